@@ -21,17 +21,58 @@
 #include "PortConnectionMonitor.h"
 #include "qextserialenumerator.h"
 
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+/*
+ * How long /dev must be quiet before ports are enumerated again.
+ * udev creates several nodes and links for one device, so wait for
+ * the burst to finish, but never longer than DEBOUNCE_MAX_MS.
+ */
+#define DEBOUNCE_MS     40
+#define DEBOUNCE_MAX_MS 250
+
 PortConnectionMonitor::PortConnectionMonitor(QObject *parent) :
     QThread(parent)
 {
     running = true;
+#ifdef Q_OS_LINUX
+    inotifyFd = -1;
+    if(pipe(wakeFd) != 0) {
+        wakeFd[0] = -1;
+        wakeFd[1] = -1;
+    }
+#endif
     start();
 }
 
+PortConnectionMonitor::~PortConnectionMonitor()
+{
+#ifdef Q_OS_LINUX
+    if(wakeFd[0] > -1) {
+        close(wakeFd[0]);
+        close(wakeFd[1]);
+    }
+#endif
+}
+
 void PortConnectionMonitor::stop()
 {
     running = false;
-    this->msleep(600); // let run finish. don't terminate it.
+#ifdef Q_OS_LINUX
+    if(wakeFd[1] > -1) {
+        char c = 0;
+        if(write(wakeFd[1], &c, 1) < 0)
+            qDebug() << "PortConnectionMonitor wakeup failed";
+    }
+#endif
+    this->wait(600); // let run finish. don't terminate it.
 }
 
 QStringList PortConnectionMonitor::enumeratePorts()
@@ -64,12 +105,109 @@ QStringList PortConnectionMonitor::enumeratePorts()
     return myPortList;
 }
 
+#ifdef Q_OS_LINUX
+/*
+ * Only wake up for nodes that getPorts() would list.
+ */
+bool PortConnectionMonitor::isPortEvent(const char *buf, int len)
+{
+    const char *ptr = buf;
+    while(ptr < buf + len) {
+        const struct inotify_event *event = (const struct inotify_event *) ptr;
+        if(event->mask & IN_Q_OVERFLOW)
+            return true;
+        if(event->len > 0) {
+            if(strncmp(event->name, "tty", 3) == 0 || strncmp(event->name, "rfcomm", 6) == 0)
+                return true;
+        }
+        ptr += sizeof(struct inotify_event) + event->len;
+    }
+    return false;
+}
+
+/*
+ * Block until a serial device node is added to or removed from /dev.
+ * Returns false when stop() is called or inotify is not usable.
+ */
+bool PortConnectionMonitor::waitForDevChange()
+{
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    struct pollfd fds[2];
+    bool changed = false;
+
+    fds[0].fd = inotifyFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd[0];
+    fds[1].events = POLLIN;
+
+    QTime elapsed;
+    int timeout = -1;
+    while(running) {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        int rc = poll(fds, 2, timeout);
+        if(rc < 0) {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        if(fds[1].revents)
+            return false;
+        if(rc == 0)
+            return true; // debounce time expired
+
+        int len = read(inotifyFd, buf, sizeof(buf));
+        if(len > 0 && isPortEvent(buf, len)) {
+            if(!changed)
+                elapsed.start();
+            changed = true;
+        }
+        if(changed) {
+            timeout = DEBOUNCE_MAX_MS - elapsed.elapsed();
+            if(timeout <= 0)
+                return true;
+            if(timeout > DEBOUNCE_MS)
+                timeout = DEBOUNCE_MS;
+        }
+    }
+    return false;
+}
+#endif
+
 void PortConnectionMonitor::run()
 {
     QStringList ports;
     portList = enumeratePorts();
+
+#ifdef Q_OS_LINUX
+    /*
+     * Use inotify on /dev so the monitor sleeps until a port appears or goes away.
+     * Fall back to polling if inotify is not available.
+     */
+    if(wakeFd[0] > -1)
+        inotifyFd = inotify_init();
+    if(inotifyFd > -1) {
+        fcntl(inotifyFd, F_SETFL, fcntl(inotifyFd, F_GETFL) | O_NONBLOCK);
+        if(inotify_add_watch(inotifyFd, "/dev", IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0) {
+            close(inotifyFd);
+            inotifyFd = -1;
+        }
+    }
+    if(inotifyFd > -1) {
+        while(running && waitForDevChange()) {
+            ports = enumeratePorts();
+            if(ports != portList) {
+                portList = ports;
+                emit portChanged();
+            }
+        }
+        close(inotifyFd);
+        inotifyFd = -1;
+        return;
+    }
+#endif
+
     while(running) {
-        QApplication::processEvents();
         this->msleep(300);
         ports = enumeratePorts();
         if(ports != portList) {
@@ -27,6 +27,7 @@ class PortConnectionMonitor : public QThread
     Q_OBJECT
 public:
     explicit PortConnectionMonitor(QObject *parent = 0);
+    ~PortConnectionMonitor();
 
     QStringList enumeratePorts();
     void stop();
@@ -38,9 +39,19 @@ signals:
 public slots:
 
 private:
+#ifdef Q_OS_LINUX
+    bool waitForDevChange();
+    bool isPortEvent(const char *buf, int len);
+#endif
+
     QString pathPrefix;
     QStringList portList;
-    bool running;
+    volatile bool running;
+
+#ifdef Q_OS_LINUX
+    int inotifyFd;
+    int wakeFd[2];
+#endif
 
 };
 
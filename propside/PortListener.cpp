@@ -32,6 +32,7 @@ PortListener::PortListener(QObject *parent, Console *term) : QThread(parent)
 {
     terminal = term;
     useSerial = false;
+    useXBee = false;
 
     /*
      * removed EVENT_DRIVEN code because it doesn't work on all platforms
@@ -47,12 +48,17 @@ PortListener::PortListener(QObject *parent, Console *term) : QThread(parent)
 
     // use event driven code with Telnet based Wifi
     connect(wifiPort, SIGNAL(updateEvent(XEsp8266port*)), this, SLOT(updateReady(XEsp8266port*)));
+
+    // XBee Wi-Fi serial service datagrams are event driven too
+    xbeePort = new XBeeSerialPort();
 }
 
-void PortListener::init(const QString & portName, BaudRateType baud, QString ipaddr)
+void PortListener::init(const QString & portName, BaudRateType baud, QString ipaddr, bool xbee)
 {
     serialPort->setPortName("");
     wifiPort->setPortName("");
+    xbeePort->setPortName("");
+    useXBee = false;
 
     if (ipaddr.length() == 0) {
         useSerial = true;
@@ -64,6 +70,16 @@ void PortListener::init(const QString & portName, BaudRateType baud, QString ipa
         serialPort->setStopBits(STOP_1);
         serialPort->setTimeout(10);
     }
+    else if (xbee) {
+        useSerial = false;
+        useXBee = true;
+        if (xbeePort->isOpen()) {
+            xbeePort->close();
+        }
+        xbeePort->setPortName(portName);
+        xbeePort->setBaudRate(baud);
+        xbeeAddr = ipaddr;
+    }
     else {
         useSerial = false;
         if (portName.compare(wifiPort->getPortName()) && wifiPort->isOpen()) {
@@ -82,6 +98,9 @@ QString PortListener::getPortName()
     if (useSerial) {
         return serialPort->portName();
     }
+    else if (useXBee) {
+        return xbeePort->portName();
+    }
     else {
         return wifiPort->getPortName();
     }
@@ -89,6 +108,8 @@ QString PortListener::getPortName()
 
 BaudRateType PortListener::getBaudRate()
 {
+    if (useXBee)
+        return (BaudRateType)xbeePort->baudRate();
     return (useSerial) ? serialPort->baudRate() : (BaudRateType)wifiPort->getBaudRate();
 }
 
@@ -122,6 +143,10 @@ bool PortListener::open()
         connect(this, SIGNAL(updateEvent(QextSerialPort*)), this, SLOT(updateReady(QextSerialPort*)));
         this->start();
     }
+    else if (useXBee) {
+        connect(xbeePort, SIGNAL(updateEvent(XBeeSerialPort*)), this, SLOT(updateReady(XBeeSerialPort*)));
+        return xbeePort->open(QHostAddress(xbeeAddr), xbeePort->baudRate());
+    }
     else {
         connect(wifiPort, SIGNAL(updateEvent(XEsp8266port*)), this, SLOT(updateReady(XEsp8266port*)));
         wifiPort->open(QHostAddress(wifiPort->getIpAddress()), wifiPort->getBaudRate());
@@ -136,6 +161,10 @@ void PortListener::close()
         disconnect(this, SIGNAL(updateEvent(QextSerialPort*)), this, SLOT(updateReady(QextSerialPort*)));
         serialPort->close();
     }
+    else if (useXBee) {
+        disconnect(xbeePort, SIGNAL(updateEvent(XBeeSerialPort*)), this, SLOT(updateReady(XBeeSerialPort*)));
+        xbeePort->close();
+    }
     else {
         disconnect(wifiPort, SIGNAL(updateEvent(XEsp8266port*)), this, SLOT(updateReady(XEsp8266port*)));
         wifiPort->close();
@@ -145,6 +174,8 @@ void PortListener::close()
 
 bool PortListener::isOpen()
 {
+    if (useXBee)
+        return xbeePort->isOpen();
     return (useSerial) ? serialPort->isOpen() : wifiPort->isOpen();
 }
 
@@ -158,6 +189,9 @@ void PortListener::send(QByteArray &data)
     if (useSerial) {
         serialPort->write(data.constData(),1);
     }
+    else if (useXBee) {
+        xbeePort->write(data,1);
+    }
     else {
         wifiPort->write(data.constData(),1);
     }
@@ -185,6 +219,13 @@ void PortListener::updateReady(XEsp8266port* port)
             terminal->updateReady(port);
 }
 
+void PortListener::updateReady(XBeeSerialPort* port)
+{
+    if(terminal != NULL)
+        if(terminal->enabled())
+            terminal->updateReady(port);
+}
+
 #if defined(Q_OS_WIN32)
 // delay less than 25ms here is dangerous for windows
 #define POLL_DELAY 25
@@ -22,13 +22,14 @@
 
 #include "console.h"
 #include "xesp8266port.h"
+#include "xbeeserialport.h"
 
 class PortListener : public QThread
 {
 Q_OBJECT
 public:
     PortListener(QObject *parent, Console *term);
-    void init(const QString &portName = 0, BaudRateType baud = BAUD115200, QString ipaddr = 0);
+    void init(const QString &portName = 0, BaudRateType baud = BAUD115200, QString ipaddr = 0, bool xbee = false);
     void setDtr(bool enable);
     void setRts(bool enable);
     bool open();
@@ -44,15 +45,19 @@ public:
 
 private:
     bool            useSerial;
+    bool            useXBee;
     Console         *terminal;
     QextSerialPort  *serialPort;
     XEsp8266port     *wifiPort;
+    XBeeSerialPort  *xbeePort;
+    QString         xbeeAddr;
     QPlainTextEdit  *textEditor;
 
 private slots:
     void onDsrChanged(bool status);
     void updateReady(QextSerialPort*);
     void updateReady(XEsp8266port *);
+    void updateReady(XBeeSerialPort *);
 
 signals:
     void readyRead(int length);
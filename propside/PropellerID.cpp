@@ -29,6 +29,7 @@
  *
  */
 
+#include <string.h>
 #include "qtversion.h"
 #include "PropellerID.h"
 
@@ -38,12 +39,15 @@ PropellerID::PropellerID(QObject *parent) : QThread(parent)
     pload_verbose = 0;
     rxhead = 0;
     rxtail = 0;
+    rxRunning = false;
     resetType = RESET_BY_DTR;
+    version = 0;
     LFSR = 80; // 'P'
 }
 
 PropellerID::~PropellerID()
 {
+    wait(); // run() ends when the port is closed
     delete port;
 }
 
@@ -52,54 +56,59 @@ int PropellerID::isDevice(QString portName)
     return findprop(portName.toLatin1());
 }
 
+/*
+ * Receive thread. Blocks in the serial driver until data arrives and
+ * copies it straight into the free part of the ring. Only the head
+ * update is done under rxMutex, so readers are woken per chunk, not per byte.
+ */
 void PropellerID::run()
 {
-    while(port->isOpen()) {
-        msleep(25);
-        QApplication::processEvents();
-        emit portEvent();
+    while(rxRunning && port->isOpen()) {
+        if(!port->waitForReadyRead(20))
+            continue;
+
+        rxMutex.lock();
+        unsigned int head = rxhead;
+        unsigned int space = RXSIZE - (rxhead - rxtail);
+        rxMutex.unlock();
+
+        if(space == 0) {
+            // consumer is behind. the queue is much bigger than a reply, so this is junk.
+            msleep(1);
+            continue;
+        }
+
+        unsigned int index = head & RXMASK;
+        unsigned int chunk = RXSIZE - index;
+        if(chunk > space)
+            chunk = space;
+
+        int size = port->read(&rxqueue[index], chunk);
+        if(size > 0) {
+            rxMutex.lock();
+            rxhead += size;
+            rxReady.wakeAll();
+            rxMutex.unlock();
+        }
     }
 }
 
-void PropellerID::portHandler()
+int PropellerID::rxcopy(char* buff, int n)
 {
-    /*
-     * TODO Queue is broken. Fix it later.
-     * For the time being the current queue buffer is big enough to hold
-     * all expected receive data + garbage from quickstart boards.
-     */
-
-    /*
-     * [--t--h-] head >= tail, read size-(head-tail) into buffer
-     * [-h-t---] head < tail, read head amount into buffer
-     * [b------] head == tail
-     * [t-----h] full
-     * [-----ht]
-     * [------b]
-     */
-    int size = port->bytesAvailable();
-    if(size < 1) {
-        return;
-    }
-#if 1
-    if (rxhead >= rxtail) {
-        size = RXSIZE-(rxhead-rxtail);
-        size = port->read(&rxqueue[rxhead], size);
-    } else {
-        size = port->read(&rxqueue[rxhead], rxtail-rxhead-1);
-    }
-#else
-    if (rxhead > rxtail) {
-        size = RXSIZE-(rxhead-rxtail);
-        size = port->read(&rxqueue[rxhead], size);
-    } else if (rxhead < rxtail) {
-        size = port->read(&rxqueue[0], rxtail - rxhead);
-    } else {
-        size = port->read(&rxqueue[0], RXSIZE);
+    int size = 0;
+    while(size < n && rxhead != rxtail) {
+        unsigned int index = rxtail & RXMASK;
+        int chunk = RXSIZE - index;
+        int avail = rxhead - rxtail;
+        if(chunk > avail)
+            chunk = avail;
+        if(chunk > n - size)
+            chunk = n - size;
+        memcpy(&buff[size], &rxqueue[index], chunk);
+        size += chunk;
+        rxtail += chunk;
     }
-#endif
-    rxhead = (rxhead + size) & RXSIZE;
-    // if (pload_verbose) qDebug() << size << " bytes read H" << rxhead << "T" << rxtail;
+    return size;
 }
 
 /**
@@ -110,17 +119,10 @@ void PropellerID::portHandler()
  */
 int PropellerID::rx(char* buff, int n)
 {
-    int size = 0;
-    while(rxhead == rxtail)
-        ;
-    while(rxhead != rxtail) {
-        if(size >= n)
-            break;
-        buff[size] = rxqueue[rxtail];
-        size++;
-        rxtail = (rxtail + size) & RXSIZE;
-    }
-    return size;
+    QMutexLocker locker(&rxMutex);
+    while(rxhead == rxtail && rxRunning)
+        rxReady.wait(&rxMutex, 100);
+    return rxcopy(buff, n);
 }
 
 /**
@@ -132,7 +134,6 @@ int PropellerID::rx(char* buff, int n)
 int PropellerID::tx(char* buff, int n)
 {
     int size = port->write((const char*)buff, n);
-    QApplication::processEvents();
     return size;
 }
 
@@ -145,21 +146,35 @@ int PropellerID::tx(char* buff, int n)
  */
 int PropellerID::rx_timeout(char* buff, int n, int timeout)
 {
-    int size = 0;
-    while(rxhead == rxtail) {
-        msleep(1);
-        QApplication::processEvents();
-        if(timeout-- < 0)
-            break;
-    }
-    while(timeout > 0 && rxhead != rxtail) {
-        if(size >= n)
+    QMutexLocker locker(&rxMutex);
+    if(rxhead == rxtail)
+        rxReady.wait(&rxMutex, timeout);
+    int size = rxcopy(buff, n);
+    return size == 0 ? SERIAL_TIMEOUT : size;
+}
+
+/**
+ * receive exactly n bytes unless the timeout expires first
+ * @param buff - char pointer to buffer
+ * @param n - number of bytes to read
+ * @param timeout - total timeout in milliseconds
+ * @returns number of bytes read
+ */
+int PropellerID::rx_bulk(char* buff, int n, int timeout)
+{
+    QTime elapsed;
+    elapsed.start();
+
+    QMutexLocker locker(&rxMutex);
+    int size = rxcopy(buff, n);
+    while(size < n) {
+        int remaining = timeout - elapsed.elapsed();
+        if(remaining <= 0)
             break;
-        buff[size] = rxqueue[rxtail];
-        size++;
-        rxtail = (rxtail + size) & RXSIZE;
+        rxReady.wait(&rxMutex, remaining);
+        size += rxcopy(&buff[size], n - size);
     }
-    return size == 0 ? SERIAL_TIMEOUT : size;
+    return size;
 }
 
 /**
@@ -264,8 +279,9 @@ int PropellerID::sendlong(int data)
  */
 int PropellerID::hwfind(int retry)
 {
-    int  n, ii, jj, rc, to;
+    int  n, jj, rc;
     char mybuf[300];
+    char reply[258];
 
     /* hwfind is recursive if we get a failure on the first try.
      * retry is set by caller and should never be more than one.
@@ -312,43 +328,40 @@ int PropellerID::hwfind(int retry)
      * Some chips may respond < 50ms, but there's no guarantee all will.
      * If we don't get it, we can assume the propeller is not there.
      */
-    ii = getBit(&rc, 110);
-    if(rc == 0) {
+    if(rx_timeout(reply, 1, 110) < 1) {
         if (pload_verbose)
             qDebug("Timeout waiting for first response bit. Propeller not found.");
         return 0;
     }
 
-    // wait for response so we know we have a Propeller
-    for(n = 1; n < 250; n++) {
+    /*
+     * The rest of the reply is 249 LFSR bits and 8 version bits, one per byte.
+     * That is about 25ms at 115200 baud, so read it all at once.
+     */
+    if(rx_bulk(&reply[1], 257, 250) < 257) {
+        qDebug("Timeout waiting for bit-stream response.");
+        return 0;
+    }
 
+    // check the LFSR response so we know we have a Propeller
+    for(n = 0; n < 250; n++) {
         jj = iterate();
-        //if (pload_verbose) { printf("%d:%d %3d ", ii, jj, n); fflush(stdout); }
-
-        if(ii != jj) {
+        if((reply[n] & 1) != jj) {
             /* if we get this far, we probably have a propeller chip
              * but the serial port is in a funny state. just retry.
              */
-            qDebug("Lost HW contact. %d %x ... retry.", n, *mybuf & 0xff);
-            for(n = 0; (n < 300) && (rx_timeout(mybuf,1,10) > -1); n++);
+            qDebug("Lost HW contact. %d %x ... retry.", n, reply[n] & 0xff);
+            for(n = 0; (n < 30) && (rx_timeout(mybuf, sizeof(mybuf), 10) > -1); n++)
+                ;
             hwreset();
             return hwfind(--retry);
         }
-        to = 0;
-        do {
-            ii = getBit(&rc, 100);
-        } while(rc == 0 && to++ < 100);
-        //printf(" %d\n", rc);
-        if(to > 100) {
-            qDebug("Timeout waiting for bit-stream response.");
-            return 0;
-        }
     }
 
     rc = 0;
     for(n = 0; n < 8; n++) {
         rc >>= 1;
-        rc += getBit(0, 100) ? 0x80 : 0;
+        rc += (reply[250+n] & 1) ? 0x80 : 0;
     }
     if (pload_verbose) qDebug("Propeller Version ... %d", rc);
     return rc;
@@ -359,7 +372,6 @@ void PropellerID::flushPort()
     int size = 0;
     do {
         msleep(5);
-        QApplication::processEvents();
         size = port->bytesAvailable();
         //if (pload_verbose) qDebug("Flushing port %d", size);
         port->readAll();
@@ -375,7 +387,7 @@ void PropellerID::flushPort()
  */
 int PropellerID::findprop(const char* name)
 {
-    int version = 0;
+    version = 0;
 
     if (pload_verbose)
         qDebug("\nChecking for Propeller on port %s", name);
@@ -392,19 +404,16 @@ int PropellerID::findprop(const char* name)
 
     flushPort();
 
-    /*
-     * TODO Queue is broken. Fix it later.
-     * For the time being the current queue buffer is big enough to hold
-     * all expected receive data + garbage from quickstart boards.
-     */
     rxhead = 0;
     rxtail = 0;
+    rxRunning = true;
 
-    connect(this, SIGNAL(portEvent()), this, SLOT(portHandler()));
     start();
     hwreset();
     version = hwfind(1); // retry once
-    disconnect(this, SIGNAL(portEvent()), this, SLOT(portHandler()));
+
+    rxRunning = false;
+    wait();
 
     if (pload_verbose) {
         if(version) {
@@ -21,6 +21,8 @@
 #define PROPELLERID_H
 
 #include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 #include "qextserialport.h"
 
 class PropellerID : public QThread
@@ -31,6 +33,9 @@ public:
     virtual ~PropellerID();
 
     int  isDevice(QString port);
+    int  getVersion() {
+        return version;
+    }
     void run();
 
 
@@ -47,13 +52,32 @@ public:
 private:
 
     int resetType;
+    int version;
     QextSerialPort *port;
 
-    enum { RXSIZE = (1<<10)-1 };
+    /*
+     * Single producer, single consumer receive ring.
+     * run() is the producer, hwfind() is the consumer.
+     * rxhead and rxtail are free running counters masked on use.
+     */
+    enum { RXSIZE = 1<<10 };
+    enum { RXMASK = RXSIZE-1 };
+
+    unsigned int rxhead;
+    unsigned int rxtail;
+    char rxqueue[RXSIZE];
+
+    QMutex          rxMutex;
+    QWaitCondition  rxReady;
+    volatile bool   rxRunning;
 
-    int rxhead;
-    int rxtail;
-    char rxqueue[RXSIZE+1];
+    /**
+     * copy up to n bytes from the ring. rxMutex must be held.
+     * @param buff - char pointer to buffer
+     * @param n - number of bytes in buffer to read
+     * @returns number of bytes copied
+     */
+    int rxcopy(char* buff, int n);
 
     /**
      * receive a buffer
@@ -80,6 +104,15 @@ private:
      */
     int rx_timeout(char* buff, int n, int timeout);
 
+    /**
+     * receive exactly n bytes unless the timeout expires first
+     * @param buff - char pointer to buffer
+     * @param n - number of bytes to read
+     * @param timeout - total timeout in milliseconds
+     * @returns number of bytes read
+     */
+    int rx_bulk(char* buff, int n, int timeout);
+
     /**
      * hwreset ... resets Propeller hardware using DTR or RTS
      * @param sparm - pointer to DCB serial control struct
@@ -165,12 +198,6 @@ private:
      */
     int findprop(const char* port);
 
-private slots:
-    void portHandler();
-
-signals:
-    void portEvent();
-
 };
 
 #endif // PROPELLERID_H
@@ -0,0 +1,158 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PropellerProbe.h"
+
+/*
+ * Shared between the caller and the workers. probeFirst can return while
+ * slower workers are still running, so the workers keep their own reference.
+ */
+class PropellerProbeState
+{
+public:
+    PropellerProbeState() : pending(0), found(0) {}
+
+    QMutex          mutex;
+    QWaitCondition  done;
+    int             pending;
+    int             found;
+    QList<PropellerProbeResult> results;
+};
+
+PropellerProbeWorker::PropellerProbeWorker(QString name, int reset, QSharedPointer<PropellerProbeState> probeState)
+    : QThread(0), portName(name), resetType(reset), state(probeState)
+{
+}
+
+void PropellerProbeWorker::run()
+{
+    PropellerProbeResult result;
+
+    /* create PropellerID here so it belongs to this thread */
+    PropellerID propId;
+    if(resetType == PropellerID::RESET_BY_RTS)
+        propId.setRtsReset();
+    else
+        propId.setDtrReset();
+
+    result.portName = portName;
+    result.status = propId.isDevice(portName);
+    result.version = result.status > 0 ? propId.getVersion() : 0;
+
+    QMutexLocker locker(&state->mutex);
+    state->results.append(result);
+    if(result.status > 0)
+        state->found++;
+    state->pending--;
+    state->done.wakeAll();
+}
+
+PropellerProbe::PropellerProbe(QObject *parent) : QObject(parent)
+{
+    resetType = PropellerID::RESET_BY_DTR;
+}
+
+void PropellerProbe::setResetType(int type)
+{
+    if(type != resetType)
+        cache.clear();
+    resetType = type;
+}
+
+void PropellerProbe::invalidate()
+{
+    cache.clear();
+}
+
+/*
+ * Results are returned in the same order as ports.
+ */
+QList<PropellerProbeResult> PropellerProbe::probeAll(QStringList ports)
+{
+    QList<PropellerProbeResult> results = probe(ports, false);
+    QList<PropellerProbeResult> list;
+    foreach(QString name, ports) {
+        foreach(PropellerProbeResult result, results) {
+            if(result.portName == name) {
+                list.append(result);
+                break;
+            }
+        }
+    }
+    return list;
+}
+
+/*
+ * Returns the first port that answers, not the first port in the list.
+ * status is 0 and portName is empty if no Propeller was found.
+ */
+PropellerProbeResult PropellerProbe::probeFirst(QStringList ports)
+{
+    QList<PropellerProbeResult> results = probe(ports, true);
+    foreach(PropellerProbeResult result, results) {
+        if(result.status > 0)
+            return result;
+    }
+    PropellerProbeResult none;
+    none.status = 0;
+    none.version = 0;
+    return none;
+}
+
+QList<PropellerProbeResult> PropellerProbe::probe(QStringList ports, bool firstOnly)
+{
+    QList<PropellerProbeResult> results;
+    QSharedPointer<PropellerProbeState> state(new PropellerProbeState());
+
+    foreach(QString name, ports) {
+        if(name.isEmpty())
+            continue;
+        if(cache.contains(name)) {
+            results.append(cache.value(name));
+            if(firstOnly && cache.value(name).status > 0)
+                return results;
+            continue;
+        }
+        PropellerProbeWorker *worker = new PropellerProbeWorker(name, resetType, state);
+        connect(worker, SIGNAL(finished()), worker, SLOT(deleteLater()));
+        state->mutex.lock();
+        state->pending++;
+        state->mutex.unlock();
+        worker->start();
+    }
+
+    /* keep the GUI alive while the workers reset and listen */
+    state->mutex.lock();
+    while(state->pending > 0 && !(firstOnly && state->found > 0)) {
+        state->done.wait(&state->mutex, 20);
+        state->mutex.unlock();
+        QApplication::processEvents();
+        state->mutex.lock();
+    }
+    QList<PropellerProbeResult> probed = state->results;
+    state->mutex.unlock();
+
+    /* busy ports may be free next time, so don't cache them */
+    foreach(PropellerProbeResult result, probed) {
+        if(result.status > -1)
+            cache.insert(result.portName, result);
+        results.append(result);
+    }
+    return results;
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROPELLERPROBE_H
+#define PROPELLERPROBE_H
+
+#include "qtversion.h"
+#include "PropellerID.h"
+
+struct PropellerProbeResult {
+    QString portName;   ///< Port name
+    int     status;     ///< 1 found, 0 not found, -1 port busy
+    int     version;    ///< Chip version if found
+};
+
+class PropellerProbeState;
+
+/*
+ * PropellerProbe checks many ports for a Propeller at the same time.
+ * Each port gets its own worker thread and PropellerID instance because
+ * every probe spends most of its time waiting on reset and timeouts.
+ * Results are cached until invalidate() is called on a port change.
+ */
+class PropellerProbe : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PropellerProbe(QObject *parent = 0);
+
+    void setResetType(int type);
+
+    QList<PropellerProbeResult> probeAll(QStringList ports);
+    PropellerProbeResult probeFirst(QStringList ports);
+
+public slots:
+    void invalidate();
+
+private:
+    QList<PropellerProbeResult> probe(QStringList ports, bool firstOnly);
+
+    int resetType;
+    QMap<QString, PropellerProbeResult> cache;
+};
+
+class PropellerProbeWorker : public QThread
+{
+    Q_OBJECT
+public:
+    PropellerProbeWorker(QString portName, int resetType, QSharedPointer<PropellerProbeState> state);
+    void run();
+
+private:
+    QString portName;
+    int     resetType;
+    QSharedPointer<PropellerProbeState> state;
+};
+
+#endif // PROPELLERPROBE_H
@@ -50,11 +50,11 @@ AboutDialog::AboutDialog(QString landing, QWidget *parent) : QDialog(parent)
 
 void AboutDialog::accept()
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
+    SettingsCache *settings = SettingsCache::instance();
     if(showSplashStartCheckBox->isChecked() == false)
-        settings.setValue(helpStartupKey, false);
+        settings->setValue(helpStartupKey, false);
     else
-        settings.setValue(helpStartupKey, true);
+        settings->setValue(helpStartupKey, true);
     this->done(QDialog::Accepted);
 }
 
@@ -65,8 +65,8 @@ void AboutDialog::reject()
 
 void AboutDialog::show()
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant helpStartup = settings.value(helpStartupKey,true);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant helpStartup = settings->value(helpStartupKey,true);
     if(helpStartup.canConvert(QVariant::Bool)) {
         showSplashStartCheckBox->setChecked(helpStartup.toBool());
     }
@@ -75,8 +75,8 @@ void AboutDialog::show()
 
 int AboutDialog::exec()
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant helpStartup = settings.value(helpStartupKey,true);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant helpStartup = settings->value(helpStartupKey,true);
     if(helpStartup.canConvert(QVariant::Bool)) {
         showSplashStartCheckBox->setChecked(helpStartup.toBool());
     }
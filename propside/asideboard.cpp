@@ -180,6 +180,19 @@ QStringList *ASideBoard::getAll()
     return al;
 }
 
+QHash<QString, QString> ASideBoard::properties()
+{
+    return propHash;
+}
+
+/*
+ * Use properties parsed earlier by parseConfig.
+ */
+void ASideBoard::setProperties(const QHash<QString, QString> &properties)
+{
+    propHash = properties;
+}
+
 int ASideBoard::parseConfig(QString file)
 {
     int propCount = -1;
@@ -35,6 +35,8 @@ public:
     QString   getFormattedConfig();
     QStringList *getAll();
     int         parseConfig(QString file);
+    QHash<QString, QString> properties();
+    void        setProperties(const QHash<QString, QString> &properties);
 
     static const QString clkmode;
     static const QString pllmode;
@@ -18,6 +18,9 @@
  */
 
 #include "asideconfig.h"
+#include "directory.h"
+
+#define BOARDCACHE_MAGIC "SimpleIDE boards 1"
 
 const QString ASideConfig::SdRun  = "SdXMMC";
 const QString ASideConfig::SdLoad = "SdLoad";
@@ -26,19 +29,39 @@ const QString ASideConfig::IDE = "IDE:";
 const QString ASideConfig::SubDelimiter = ":";
 const QString ASideConfig::UserDelimiter = "-";
 
+/*
+ * Reads the board configurations off the GUI thread at startup.
+ */
+class BoardLoader : public QRunnable
+{
+public:
+    BoardLoader(ASideConfig *config, QString filePath)
+        : config(config), filePath(filePath) { }
+    void run() { config->readBoards(filePath); }
+private:
+    ASideConfig *config;
+    QString      filePath;
+};
+
 ASideConfig::ASideConfig()
 {
     boards = new QList<ASideBoard*>();
+    loadPool.setMaxThreadCount(1);
+    loading = false;
+    cacheLoaded = false;
+    cacheDirty = false;
 }
 
 ASideConfig::~ASideConfig()
 {
+    waitForBoards();
     boards->clear();
     delete boards;
 }
 
 void ASideConfig::deleteBoardByName(QString name)
 {
+    waitForBoards();
     for(int n = 0; n < boardNames.count(); n++)
     {
         if(boardNames.at(n) == name)
@@ -56,6 +79,7 @@ void ASideConfig::deleteBoardByName(QString name)
  */
 ASideBoard *ASideConfig::getBoardByName(QString name)
 {
+    waitForBoards();
     for(int n = 0; n < boardNames.count(); n++)
     {
         if(boardNames.at(n) == name)
@@ -73,6 +97,31 @@ ASideBoard *ASideConfig::newBoard(QString name)
 }
 
 int ASideConfig::loadBoards(QString filePath)
+{
+    waitForBoards();
+    return readBoards(filePath);
+}
+
+/*
+ * Start loading boards in the background. Every accessor waits for
+ * the load to finish, so callers don't need to care.
+ */
+void ASideConfig::loadBoardsAsync(QString filePath)
+{
+    waitForBoards();
+    loading = true;
+    loadPool.start(new BoardLoader(this, filePath));
+}
+
+void ASideConfig::waitForBoards()
+{
+    if(loading) {
+        loadPool.waitForDone();
+        loading = false;
+    }
+}
+
+int ASideConfig::readBoards(QString filePath)
 {
     QDir dir(filePath);
     if(!dir.exists())
@@ -88,11 +137,16 @@ int ASideConfig::loadBoards(QString filePath)
     boardNames.clear();
     boardNames.append(GENERIC_BOARD);
 
-    return addBoards(filePath);
+    return scanBoards(filePath);
 }
 
-
 int ASideConfig::addBoards(QString filePath)
+{
+    waitForBoards();
+    return scanBoards(filePath);
+}
+
+int ASideConfig::scanBoards(QString filePath)
 {
     QDir dir(filePath);
     if(!dir.exists())
@@ -114,60 +168,162 @@ int ASideConfig::addBoards(QString filePath)
         }
     }
 
+    loadCache();
+
     foreach(QString name, names) {
         if(boardtxt.isEmpty() == false) {
             if(boardtxt.contains(name, Qt::CaseInsensitive) == false)
                 continue;
         }
-        QFile fileReader(filePath+name);
-        if (!fileReader.open(QIODevice::ReadOnly))
+        const BoardFile *bf = boardFile(filePath+name);
+        if(!bf)
             return 0;
-        QString file = fileReader.readAll();
-        name = name.mid(0,name.lastIndexOf("."));
 
-        /* add default board */
-        ASideBoard *board = newBoard(name.toUpper());
-        if (board->parseConfig(file))
-            boards->append(board);
+        /* every variant of a file shares the same parsed properties */
+        foreach(QString variant, bf->variants) {
+            ASideBoard *board = newBoard(variant);
+            if(bf->valid) {
+                board->setProperties(bf->properties);
+                boards->append(board);
+            }
+        }
+    }
 
-        QStringList list = file.split("\n",QString::SkipEmptyParts);
-        QStringList sublist;
+    saveCache();
+    return boards->count();
+}
 
-        /* find board subtypes */
-        foreach(QString s, list) {
-            if(s.contains("[",Qt::CaseInsensitive)) {
-                s = s.mid(s.indexOf("[")+1);
-                if(s.contains("]") == false) {
-                    /* badly formed board type. Ignore it */
-                    continue;
-                }
-                s = s.mid(0,s.indexOf("]"));
-                s = s.trimmed();
-                if(s.compare(name,Qt::CaseInsensitive) != 0) {
-                    sublist.append(name.toUpper());
-                    ASideBoard *board = newBoard(name.toUpper()+ASideConfig::SubDelimiter+s.toUpper());
-                    if (board->parseConfig(file))
-                        boards->append(board);
-                }
+/*
+ * Parsed form of a .cfg file, reused while the file's time and size
+ * are unchanged. Returns NULL if the file can't be read.
+ */
+const ASideConfig::BoardFile *ASideConfig::boardFile(const QString &path)
+{
+    QFileInfo info(path);
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    QHash<QString,BoardFile>::const_iterator it = fileCache.constFind(path);
+    if(it != fileCache.constEnd() && it.value().modified == modified && it.value().size == info.size())
+        return &it.value();
+
+    QFile fileReader(path);
+    if (!fileReader.open(QIODevice::ReadOnly))
+        return NULL;
+    QString file = fileReader.readAll();
+    fileReader.close();
+
+    QString name = info.fileName();
+    name = name.mid(0,name.lastIndexOf("."));
+
+    BoardFile bf = parseBoardFile(name, file);
+    bf.modified = modified;
+    bf.size = info.size();
+    cacheDirty = true;
+    return &fileCache.insert(path, bf).value();
+}
+
+ASideConfig::BoardFile ASideConfig::parseBoardFile(const QString &name, const QString &file)
+{
+    BoardFile bf;
+
+    /* add default board */
+    ASideBoard board;
+    bf.valid = board.parseConfig(file) != 0;
+    bf.properties = board.properties();
+    bf.variants.append(name.toUpper());
+
+    QStringList list = file.split("\n",QString::SkipEmptyParts);
+
+    /* find board subtypes */
+    foreach(QString s, list) {
+        if(s.contains("[",Qt::CaseInsensitive)) {
+            s = s.mid(s.indexOf("[")+1);
+            if(s.contains("]") == false) {
+                /* badly formed board type. Ignore it */
+                continue;
             }
+            s = s.mid(0,s.indexOf("]"));
+            s = s.trimmed();
+            if(s.compare(name,Qt::CaseInsensitive) != 0)
+                bf.variants.append(name.toUpper()+ASideConfig::SubDelimiter+s.toUpper());
         }
+    }
 
-        /* add IDE control variants */
-        if(file.contains(ASideConfig::IDE,Qt::CaseInsensitive)) {
-            foreach(QString s, list) {
-                if(s.contains(ASideConfig::IDE,Qt::CaseInsensitive)) {
-                    s = s.mid(s.indexOf(ASideConfig::IDE)+ASideConfig::IDE.length());
-                    s = s.trimmed();
-                    ASideBoard *board = newBoard(name.toUpper()+ASideConfig::UserDelimiter+s.toUpper());
-                    if (board->parseConfig(file))
-                        boards->append(board);
-                }
+    /* add IDE control variants */
+    if(file.contains(ASideConfig::IDE,Qt::CaseInsensitive)) {
+        foreach(QString s, list) {
+            if(s.contains(ASideConfig::IDE,Qt::CaseInsensitive)) {
+                s = s.mid(s.indexOf(ASideConfig::IDE)+ASideConfig::IDE.length());
+                s = s.trimmed();
+                bf.variants.append(name.toUpper()+ASideConfig::UserDelimiter+s.toUpper());
             }
         }
+    }
+    return bf;
+}
 
-        fileReader.close();
+QString ASideConfig::cacheFile()
+{
+    return Directory::cacheLocation("boards.cache");
+}
+
+/*
+ * The parsed boards are kept on disk so a fresh start doesn't
+ * parse every .cfg file again.
+ */
+void ASideConfig::loadCache()
+{
+    if(cacheLoaded)
+        return;
+    cacheLoaded = true;
+
+    QFile file(cacheFile());
+    if(!file.open(QFile::ReadOnly))
+        return;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+    QString magic;
+    qint32 count = 0;
+    in >> magic >> count;
+    if(magic != BOARDCACHE_MAGIC)
+        return;
+    for(int n = 0; n < count && in.status() == QDataStream::Ok; n++) {
+        QString path;
+        BoardFile bf;
+        in >> path >> bf.modified >> bf.size >> bf.valid >> bf.variants >> bf.properties;
+        if(in.status() == QDataStream::Ok && !fileCache.contains(path))
+            fileCache.insert(path, bf);
     }
-    return boards->count();
+}
+
+void ASideConfig::saveCache()
+{
+    if(!cacheDirty)
+        return;
+    cacheDirty = false;
+
+    QString name = cacheFile();
+    QDir().mkpath(QFileInfo(name).path());
+
+    /* drop entries for files that are gone */
+    foreach(QString path, fileCache.keys()) {
+        if(!QFile::exists(path))
+            fileCache.remove(path);
+    }
+
+    QFile file(name+".tmp");
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out << QString(BOARDCACHE_MAGIC) << (qint32) fileCache.count();
+    QHash<QString,BoardFile>::const_iterator it;
+    for(it = fileCache.constBegin(); it != fileCache.constEnd(); ++it) {
+        const BoardFile &bf = it.value();
+        out << it.key() << bf.modified << bf.size << bf.valid << bf.variants << bf.properties;
+    }
+    file.close();
+    QFile::remove(name);
+    QFile::rename(name+".tmp", name);
 }
 
 #if REMOVE_CRUFT
@@ -225,11 +381,13 @@ int ASideConfig::loadBoards_v0_2_0(QString filePath)
 
 QStringList ASideConfig::getBoardNames()
 {
+    waitForBoards();
     return boardNames;
 }
 
 ASideBoard* ASideConfig::getBoardData(QString name)
 {
+    waitForBoards();
     int length = boards->count();
     if(length == 0)
         return NULL;
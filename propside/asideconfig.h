@@ -40,6 +40,8 @@ public:
     ~ASideConfig();
 
     int         loadBoards(QString filePath);
+    void        loadBoardsAsync(QString filePath);
+    void        waitForBoards();
     int         addBoards(QString filePath);
     ASideBoard *newBoard(QString name);
     void        deleteBoardByName(QString name);
@@ -50,6 +52,31 @@ public:
 
 
 private:
+    friend class BoardLoader;
+
+    int         readBoards(QString filePath);
+    int         scanBoards(QString filePath);
+
+    struct BoardFile {
+        qint64      modified;
+        qint64      size;
+        bool        valid;
+        QStringList variants;
+        QHash<QString,QString> properties;
+    };
+
+    const BoardFile *boardFile(const QString &path);
+    static BoardFile parseBoardFile(const QString &name, const QString &file);
+    static QString cacheFile();
+    void        loadCache();
+    void        saveCache();
+
+    QHash<QString,BoardFile> fileCache;
+    bool                cacheLoaded;
+    bool                cacheDirty;
+
+    QThreadPool         loadPool;
+    bool                loading;
     QString             filePath;
     QStringList         boardNames;
     QList<ASideBoard*> *boards;
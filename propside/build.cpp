@@ -29,9 +29,11 @@ Build::Build(ProjectOptions *projopts, QPlainTextEdit *compstat, QLabel *stat, Q
     progress = progbar;
     cbBoard = cb;
     properties = p;
+    captureOutput = false;
 
     process = new QProcess();
     blinker = new Blinker(status);
+    diagnostics = new DiagnosticModel(this);
 
     connect(blinker, SIGNAL(statusNone()), this, SLOT(statusNone()));
     connect(blinker, SIGNAL(statusFailed()), this, SLOT(statusFailed()));
@@ -89,11 +91,11 @@ int  Build::startProgram(QString program, QString workpath, QStringList args, Du
     /*
      * ensure absolute path to programs
      */
-    QTime ptime;
-    ptime.start();
-    qDebug() << "startProgram 0 time" << ptime.elapsed();
-
     program = shortFileName(program);
+    TraceSpan span(program, "tool");
+    span.setArg("args", args.join(" "));
+    span.setArg("workdir", workpath);
+
     program = aSideCompilerPath+program;
     QApplication::processEvents();
 
@@ -120,23 +122,18 @@ int  Build::startProgram(QString program, QString workpath, QStringList args, Du
 
     procDone = false;
     procResultError = false;
-
-    qDebug() << "startProgram 1 time" << ptime.elapsed();
+    pendingOutput.clear();
 
     process->start(program,args);
 
-    qDebug() << "startProgram 2 time" << ptime.elapsed();
-
     this->codeSize = 0;
 
     /* process Qt application events until procDone
      */
     while(procDone == false) {
-        //qDebug() << "startProgram 3 time" << ptime.elapsed();
         Sleeper::ms(50);
         QApplication::processEvents();
     }
-    qDebug() << "startProgram 3 time" << ptime.elapsed();
 
     int killed = 0;
     if(process->state() == QProcess::Running) {
@@ -151,9 +148,9 @@ int  Build::startProgram(QString program, QString workpath, QStringList args, Du
 
     //progress->hide();
 
-    if(procResultError)
-        return 1;
-    return process->exitCode() | killed;
+    int rc = procResultError ? 1 : (process->exitCode() | killed);
+    span.setArg("exit", rc);
+    return rc;
 }
 
 void Build::procError(QProcess::ProcessError error)
@@ -181,6 +178,9 @@ void Build::procFinished(int exitCode, QProcess::ExitStatus exitStatus)
     procDone = true;
     procMutex.unlock();
 
+    if(pendingOutput.length() > 0)
+        showOutput(QByteArray(), true);
+
     QVariant name = process->property("Name");
     buildResult(exitStatus, exitCode, name.toString(), process->readAllStandardOutput());
 
@@ -258,13 +258,46 @@ void Build::procReadyRead()
     QByteArray bytes = process->readAllStandardOutput();
     if(bytes.length() == 0)
         return;
+    showOutput(bytes, false);
+}
+
+/*
+ * Show saved output of an earlier run of program as if it ran again,
+ * so warnings reach the status window and the diagnostics model.
+ */
+void Build::replayOutput(QString program, QByteArray bytes)
+{
+    if(bytes.length() == 0)
+        return;
+    process->setProperty("Name", QVariant(aSideCompilerPath+shortFileName(program)));
+    pendingOutput.clear();
+    showOutput(bytes, true);
+}
 
+/*
+ * Show program output in the build status window.
+ * Lines are classified once, compiler messages go to the diagnostics model,
+ * and text is inserted in one batch. A partial last line waits for the
+ * next chunk unless flush is set.
+ */
+void Build::showOutput(QByteArray bytes, bool flush)
+{
 #if defined(Q_OS_WIN32)
     QString eol("\r");
 #else
     QString eol("\n");
 #endif
-    bytes = bytes.replace("\r\n","\n");
+    if(captureOutput)
+        capturedOutput += bytes;
+    bytes = pendingOutput + bytes.replace("\r\n","\n");
+    pendingOutput.clear();
+    if(!flush) {
+        int end = qMax(bytes.lastIndexOf('\n'), bytes.lastIndexOf('\r'));
+        pendingOutput = bytes.mid(end+1);
+        bytes.truncate(end+1);
+    }
+    if(bytes.length() == 0)
+        return;
 
     // bstc doesn't return good exit status
     QString progname;
@@ -278,30 +311,29 @@ void Build::procReadyRead()
         if(QString(bytes).contains("Error",Qt::CaseInsensitive)) {
             procResultError = true;
         }
-        if(QString(bytes).contains("longs",Qt::CaseInsensitive)) {
-            bytes = bytes.replace("longs", "bytes");
-        }
+        bytes = bytes.replace("longs", "bytes");
     }
     if(progname.contains("propbasic",Qt::CaseInsensitive)) {
         isbstc = true;
-        if(QString(bytes).contains("Error",Qt::CaseInsensitive) && !QString(bytes).contains("0 Error",Qt::CaseInsensitive)) {
+        QString s(bytes);
+        if(s.contains("Error",Qt::CaseInsensitive) && !s.contains("0 Error",Qt::CaseInsensitive)) {
             procResultError = true;
         }
-        if(QString(bytes).contains("longs",Qt::CaseInsensitive)) {
-            bytes = bytes.replace("longs", "bytes");
-        }
+        bytes = bytes.replace("longs", "bytes");
     }
 
+    QString text(bytes);
+
     if(progname.contains("propeller-elf-gcc") && bytes.contains("gcc version")) {
-        QString line = QString(bytes);
-        QStringList lines = line.split("gcc version",QString::SkipEmptyParts);
-        if(lines.count() > 0) {
+        QStringList lines = text.split("gcc version",QString::SkipEmptyParts);
+        if(lines.count() > 1) {
+            compileStatus->moveCursor(QTextCursor::End);
             compileStatus->insertPlainText(" GCC "+QString(lines[1]).trimmed());
             return;
         }
     }
 
-    QStringList lines = QString(bytes).split("\n",QString::SkipEmptyParts);
+    QStringList lines = text.split("\n",QString::SkipEmptyParts);
     if(bytes.contains("bytes")) {
         for (int n = 0; n < lines.length(); n++) {
             QString line = lines[n];
@@ -321,72 +353,99 @@ void Build::procReadyRead()
         }
     }
 
+    /*
+     * Text accumulates in batch and goes in with one insert.
+     * block tracks the status window line the batch has reached.
+     */
+    QString batch;
+    QList<Diagnostic> diags;
+    int block = compileStatus->blockCount()-1;
+    compileStatus->moveCursor(QTextCursor::End);
+
     for (int n = 0; n < lines.length(); n++) {
         QString line = lines[n];
-        if(line.length() > 0) {
-            compileStatus->moveCursor(QTextCursor::End);
-            if(line.contains("Propeller Version",Qt::CaseInsensitive)) {
-                compileStatus->insertPlainText(line+eol);
-                progress->setValue(0);
-            }
-            else
-            if(line.contains("loading",Qt::CaseInsensitive) && !isbstc) {
-                progMax = 0;
-                progress->setValue(0);
-                compileStatus->insertPlainText(line+eol);
-            }
-            else
-            if(line.contains("writing",Qt::CaseInsensitive)) {
-                progMax = 0;
-                progress->setValue(0);
-            }
-            else
-            if(line.contains("Download OK",Qt::CaseInsensitive)) {
-                progress->setValue(100);
-                compileStatus->insertPlainText(line+eol);
-            }
-            else
-            if(line.contains("sent",Qt::CaseInsensitive)) {
-                compileStatus->insertPlainText(line+eol);
-            }
-            else
-            if(line.contains("remaining",Qt::CaseInsensitive)) {
+        if(line.length() == 0)
+            continue;
+
+        Diagnostic diag;
+        if(diagParser.parse(line, diag)) {
+            batch += eol+line;
+            diag.statusLine = ++block;
+            diags.append(diag);
+        }
+        else
+        if(line.contains("Propeller Version",Qt::CaseInsensitive)) {
+            batch += line+eol;
+            block++;
+            progress->setValue(0);
+        }
+        else
+        if(line.contains("loading",Qt::CaseInsensitive) && !isbstc) {
+            progMax = 0;
+            progress->setValue(0);
+            batch += line+eol;
+            block++;
+        }
+        else
+        if(line.contains("writing",Qt::CaseInsensitive)) {
+            progMax = 0;
+            progress->setValue(0);
+        }
+        else
+        if(line.contains("Download OK",Qt::CaseInsensitive)) {
+            progress->setValue(100);
+            batch += line+eol;
+            block++;
+        }
+        else
+        if(line.contains("sent",Qt::CaseInsensitive)) {
+            batch += line+eol;
+            block++;
+        }
+        else
+        if(line.contains("remaining",Qt::CaseInsensitive)) {
+            if(progMax == 0) {
+                QString bs = line.mid(0,line.indexOf(" "));
+                progMax = bs.toInt();
+                progMax /= 1024;
+                progMax++;
+                progCount = 0;
                 if(progMax == 0) {
-                    QString bs = line.mid(0,line.indexOf(" "));
-                    progMax = bs.toInt();
-                    progMax /= 1024;
-                    progMax++;
-                    progCount = 0;
-                    if(progMax == 0) {
-                        progress->setValue(100);
-                    }
-                }
-                if(progMax != 0) {
-                    progCount++;
-                    progress->setValue(100*progCount/progMax);
+                    progress->setValue(100);
                 }
-                compileStatus->moveCursor(QTextCursor::StartOfLine,QTextCursor::KeepAnchor);
-                compileStatus->insertPlainText(line);
             }
-            else
-            if(line.contains("Program size",Qt::CaseInsensitive)) {
-                // bstc reports program size is N longs
-                compileStatus->insertPlainText(eol);
-                compileStatus->insertPlainText(line);
-                QString s = line.mid(line.lastIndexOf("is ")+3);
-                s = s.mid(0,s.lastIndexOf(" "));
-                bool ok = false;
-                int size =  s.toInt(&ok);
-                this->codeSize = ok ? size : 0;
+            if(progMax != 0) {
+                progCount++;
+                progress->setValue(100*progCount/progMax);
             }
-            else {
-                if(n < lines.length())
-                    compileStatus->insertPlainText(eol);
-                compileStatus->insertPlainText(line);
+            // overwrites the current line, so the batch must be in first
+            if(batch.length() > 0) {
+                compileStatus->insertPlainText(batch);
+                batch.clear();
             }
+            compileStatus->moveCursor(QTextCursor::StartOfLine,QTextCursor::KeepAnchor);
+            compileStatus->insertPlainText(line);
+        }
+        else
+        if(line.contains("Program size",Qt::CaseInsensitive)) {
+            // bstc reports program size is N longs
+            batch += eol+line;
+            block++;
+            QString s = line.mid(line.lastIndexOf("is ")+3);
+            s = s.mid(0,s.lastIndexOf(" "));
+            bool ok = false;
+            int size =  s.toInt(&ok);
+            this->codeSize = ok ? size : 0;
+        }
+        else {
+            batch += eol+line;
+            block++;
         }
     }
 
+    if(batch.length() > 0)
+        compileStatus->insertPlainText(batch);
+    diagnostics->append(diags);
 }
 
 int  Build::checkBuildStart(QProcess *proc, QString progName)
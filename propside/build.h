@@ -23,6 +23,8 @@
 #include "blinker.h"
 #include "properties.h"
 #include "projectoptions.h"
+#include "diagnostics.h"
+#include "buildtrace.h"
 
 #define FILELINK " -> "
 #define SHOW_ASM_EXTENTION ".asm"
@@ -73,11 +75,34 @@ public:
             incHash.clear();
     }
 
+    DiagnosticModel *diagnosticModel() {
+        return diagnostics;
+    }
+
+    /* keep a copy of program output, e.g. for the object cache */
+    void setCaptureOutput(bool capture) {
+        captureOutput = capture;
+        if(capture)
+            capturedOutput.clear();
+    }
+    QByteArray takeCapturedOutput() {
+        QByteArray bytes = capturedOutput;
+        capturedOutput.clear();
+        return bytes;
+    }
+    void replayOutput(QString program, QByteArray bytes);
+
 signals:
     void showCompileStatusError();
 
 private:
+    void showOutput(QByteArray bytes, bool flush);
+
     Blinker *blinker;
+    DiagnosticParser diagParser;
+    QByteArray pendingOutput;
+    QByteArray capturedOutput;
+    bool       captureOutput;
 
 protected:
     QString         aSideCompiler;
@@ -103,6 +128,7 @@ protected:
 
     ProjectOptions  *projectOptions;
     Properties      *properties;
+    DiagnosticModel *diagnostics;
 
     QString         outputFile;
 
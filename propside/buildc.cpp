@@ -23,6 +23,7 @@
 #include "Sleeper.h"
 #include "properties.h"
 #include "asideconfig.h"
+#include "elfreader.h"
 #include "hintdialog.h"
 #include "directory.h"
 
@@ -79,11 +80,14 @@ int  BuildC::runBuild(QString option, QString projfile, QString compiler)
     if(maxprogress < 1)
         return -1;
 
+    setupObjectCache();
+
     //checkAndSaveFiles();
 
     progress->hide();
     programSize->setText("");
 
+    diagnostics->clear();
     compileStatus->setPlainText(tr("Project Directory: ")+sourcePath(projectFile)+"\n");
     compileStatus->moveCursor(QTextCursor::End);
 
@@ -358,6 +362,12 @@ int  BuildC::runBuild(QString option, QString projfile, QString compiler)
         else {
             rc = runCompiler(clist);
 
+            if(objectCache.hitCount()+objectCache.missCount() > 0) {
+                compileStatus->appendPlainText(tr("Object cache: %1 hits, %2 misses")
+                        .arg(objectCache.hitCount()).arg(objectCache.missCount()));
+            }
+            objectCache.trim();
+
             cur = compileStatus->textCursor();
 
             loadtype = cbBoard->currentText();
@@ -736,6 +746,92 @@ int  BuildC::runAR(QStringList copts, QString libname)
     return rc;
 }
 
+/*
+ * Settings decide where the shared object cache lives.
+ * An empty directory setting turns the cache off.
+ */
+void BuildC::setupObjectCache()
+{
+    SettingsCache *settings = SettingsCache::instance();
+    QString dir = settings->value(objectCacheKey, ObjectCache::defaultDirectory()).toString();
+    qint64 mbytes = settings->value(objectCacheSizeKey, 256).toLongLong();
+    objectCache.setDirectory(dir);
+    objectCache.setMaxSize(mbytes*1024*1024);
+    objectCache.resetStats();
+}
+
+/*
+ * Compile one source to objPath, or take the object from the cache.
+ * The key is made from the preprocessed source, so header changes are
+ * caught without tracking dependencies. Anything unexpected falls back
+ * to a normal compile.
+ */
+int  BuildC::runCachedCompile(QString compstr, QStringList tlist, QString srcFile, QString objPath)
+{
+    QString workpath = sourcePath(projectFile);
+    if(!objectCache.isEnabled())
+        return startProgram(compstr,workpath,tlist);
+
+    TraceSpan span("cache "+shortFileName(srcFile), "cache");
+
+    QStringList ppargs;
+    QStringList flags;
+    for(int n = 0; n < tlist.length(); n++) {
+        QString s = tlist[n];
+        if(s.compare("-o") == 0) {
+            n++;
+            continue;
+        }
+        if(s.compare("-c") != 0)
+            ppargs.append(s);
+        if(s.compare("-I") == 0 || s.compare("-L") == 0) {
+            ppargs.append(tlist.value(++n));
+            continue;
+        }
+        if(s.indexOf("-I") == 0 || s.indexOf("-L") == 0)
+            continue;
+        if(s.compare(srcFile) == 0)
+            s = shortFileName(s);
+        flags.append(s);
+    }
+    ppargs.append("-E");
+
+    QProcess pp;
+    pp.setWorkingDirectory(workpath);
+    pp.start(aSideCompilerPath+shortFileName(compstr), ppargs);
+    if(!pp.waitForStarted())
+        return startProgram(compstr,workpath,tlist);
+    while(!pp.waitForFinished(50)) {
+        if(pp.state() == QProcess::NotRunning)
+            break;
+        QApplication::processEvents();
+    }
+    if(pp.exitStatus() != QProcess::NormalExit || pp.exitCode() != 0)
+        return startProgram(compstr,workpath,tlist);
+
+    QString compilerId = ObjectCache::compilerIdentity(aSideCompilerPath+shortFileName(compstr));
+    QString key = objectCache.key(compilerId, getMemModel(), flags, pp.readAllStandardOutput());
+
+    QByteArray output;
+    bool hit = objectCache.fetch(key, workpath+objPath, &output);
+    span.setArg("hit", hit ? 1 : 0);
+    if(hit) {
+        compileStatus->appendPlainText(shortFileName(compstr)+" "+tlist.join(" ")+" "+tr("(cached)"));
+        replayOutput(compstr, output);
+        return 0;
+    }
+
+    // never write through a hard link into the cache
+    QFile::remove(workpath+objPath);
+    setCaptureOutput(true);
+    int rc = startProgram(compstr,workpath,tlist);
+    setCaptureOutput(false);
+    output = takeCapturedOutput();
+    if(rc == 0)
+        objectCache.store(key, workpath+objPath, output);
+    return rc;
+}
+
 int  BuildC::runCompiler(QStringList copts)
 {
     int rc = 0;
@@ -936,7 +1032,7 @@ int  BuildC::runCompiler(QStringList copts)
             args.append(objPath);
             tlist.append("-o");
             tlist.append(objPath);
-            rc = startProgram(compstr,sourcePath(projectFile),tlist);
+            rc = runCachedCompile(compstr,tlist,s,objPath);
             tlist.removeLast(); // objPath
             tlist.removeLast(); // "-o"
             tlist.removeLast(); // srcFile
@@ -1029,10 +1125,26 @@ int  BuildC::runCompiler(QStringList copts)
         rc = startProgram("propeller-load",sourcePath(projectFile),args,this->DumpNormal);
     }
 
-    args.clear();
-    args.append("-h");
-    args.append(exePath);
-    rc = startProgram("propeller-elf-objdump",sourcePath(projectFile),args,this->DumpReadSizes);
+    /* read section sizes directly; objdump is only a fallback */
+    ElfReader elf;
+    programSize->setToolTip("");
+    if(elf.open(sourcePath(projectFile)+exePath)) {
+        elf.programSizes(codeSize, memorySize);
+        rc = 0;
+
+        /* size breakdown with the largest symbols */
+        QString tip = QString("text %L1  data %L2  bss %L3").arg(elf.textSize()).arg(elf.dataSize()).arg(elf.bssSize());
+        foreach(ElfSymbol sym, elf.symbols(10)) {
+            tip += QString("\n%L1\t%2").arg(sym.size).arg(sym.name);
+        }
+        programSize->setToolTip(tip);
+    }
+    else {
+        args.clear();
+        args.append("-h");
+        args.append(exePath);
+        rc = startProgram("propeller-elf-objdump",sourcePath(projectFile),args,this->DumpReadSizes);
+    }
     progress->setValue((100*prog++)/maxprogress);
 
     /*
@@ -1213,39 +1325,17 @@ QStringList BuildC::getCompilerParameters(QStringList copts)
     return args;
 }
 
-int BuildC::getCompilerParameters(QStringList copts, QStringList *args)
+/*
+ * Project compiler options: optimization, model, defines and flags.
+ * Shared with the dependency scan so it sees what the compiler sees.
+ * report shows ignored options in the status window.
+ */
+void BuildC::appendCompilerOptions(QStringList *args, QString model, bool report)
 {
-    // use the projectFile instead of the current tab file
-    //QString srcpath = sourcePath(projectFile);
-
-    //portName = cbPort->itemText(cbPort->currentIndex());
-    //boardName = cbBoard->itemText(cbBoard->currentIndex());
-
-    //model = projectOptions->getMemModel();
-    QString newmodel;
-    if (copts.at(0).contains(BUILDALL_MEMTYPE)) {
-        QString mopt = copts.at(0);
-        newmodel = mopt.mid(mopt.indexOf("=")+1);
-        model = newmodel;
-        copts.removeAt(0);
-    }
-    model = model.mid(0,model.indexOf(" ")); // anything after the first word is just description
-
-    if(copts.length() > 0) {
-        QString s = copts.at(0);
-        if(s.compare("-g") == 0)
-            args->append(s);
-    }
-    args->append("-o");
-    args->append(exePath);
-
-    args->append(projectOptions->getOptimization());
-    args->append("-m"+model);
-
-    args->append("-I");
-    args->append(".");
-    args->append("-L");
-    args->append(".");
+    if(projectOptions->getOptimization().length())
+        args->append(projectOptions->getOptimization());
+    if(model.length() > 0)
+        args->append("-m"+model);
 
     if(projectOptions->getWarnAll().length())
         args->append(projectOptions->getWarnAll());
@@ -1259,12 +1349,16 @@ int BuildC::getCompilerParameters(QStringList copts, QStringList *args)
     if(projectOptions->getSimplePrintf().length() > 0) {
         /* don't use simple printf flag for COG model programs. */
         if(model.contains("cog",Qt::CaseInsensitive) == true) {
-            this->compileStatus->insertPlainText(tr("Ignoring")+" \"Simple printf\""+tr(" flag in COG mode program.")+"\n");
-            this->compileStatus->moveCursor(QTextCursor::End);
+            if(report) {
+                this->compileStatus->insertPlainText(tr("Ignoring")+" \"Simple printf\""+tr(" flag in COG mode program.")+"\n");
+                this->compileStatus->moveCursor(QTextCursor::End);
+            }
         }
         else if(projectOptions->getTinyLib().length() > 0) {
-            this->compileStatus->insertPlainText(tr("Ignoring")+" \"Simple printf\""+tr(" flag in a program using -ltiny.")+"\n");
-            this->compileStatus->moveCursor(QTextCursor::End);
+            if(report) {
+                this->compileStatus->insertPlainText(tr("Ignoring")+" \"Simple printf\""+tr(" flag in a program using -ltiny.")+"\n");
+                this->compileStatus->moveCursor(QTextCursor::End);
+            }
         }
         else {
             args->append(projectOptions->getSimplePrintf());
@@ -1281,6 +1375,40 @@ int BuildC::getCompilerParameters(QStringList copts, QStringList *args)
             args->append(compopt);
         }
     }
+}
+
+int BuildC::getCompilerParameters(QStringList copts, QStringList *args)
+{
+    // use the projectFile instead of the current tab file
+    //QString srcpath = sourcePath(projectFile);
+
+    //portName = cbPort->itemText(cbPort->currentIndex());
+    //boardName = cbBoard->itemText(cbBoard->currentIndex());
+
+    //model = projectOptions->getMemModel();
+    QString newmodel;
+    if (copts.at(0).contains(BUILDALL_MEMTYPE)) {
+        QString mopt = copts.at(0);
+        newmodel = mopt.mid(mopt.indexOf("=")+1);
+        model = newmodel;
+        copts.removeAt(0);
+    }
+    model = model.mid(0,model.indexOf(" ")); // anything after the first word is just description
+
+    if(copts.length() > 0) {
+        QString s = copts.at(0);
+        if(s.compare("-g") == 0)
+            args->append(s);
+    }
+    args->append("-o");
+    args->append(exePath);
+
+    appendCompilerOptions(args, model, true);
+
+    args->append("-I");
+    args->append(".");
+    args->append("-L");
+    args->append(".");
 
     /* files */
     for(int n = 0; n < copts.length(); n++) {
@@ -1475,6 +1603,25 @@ bool BuildC::isOutdated(QStringList srclist, QString srcpath, QString target)
             return true;
         }
     }
+
+    /* headers count too, with the libraries autolib picked last time */
+    QStringList libDirs;
+#ifdef ENABLE_AUTOLIB
+    if(properties->getAutoLib()) {
+        if(!autoLibDirs.contains(projectFile))
+            return true;
+        libDirs = autoLibDirs.value(projectFile);
+    }
+#endif
+    if(scanDependencies(srclist, srcpath, libDirs)) {
+        QDir dir(srcpath);
+        foreach(QString src, dependencySources(srclist)) {
+            foreach(QString dep, depScanner.dependencies(dir.absoluteFilePath(src))) {
+                if (outtime.secsTo(QFileInfo(dep).lastModified()) > 0)
+                    return true;
+            }
+        }
+    }
     return false;
 }
 
@@ -1491,14 +1638,16 @@ QStringList BuildC::getLocalSourceList(QStringList &LLlist)
 
 QStringList BuildC::getLibraryList(QStringList &ILlist, QString projFile)
 {
-    QSettings settings(publisherKey,ASideGuiKey);
+    TraceSpan span("autolib", "scan");
+    span.setArg("project", projFile);
+    SettingsCache *settings = SettingsCache::instance();
     QStringList newList;
     //QString projFile = this->projectFile;
 
     if(QFile::exists(projFile) == false)
         return newList;
 
-    QVariant libv = settings.value(gccLibraryKey);
+    QVariant libv = settings->value(gccLibraryKey);
     QString libdir;
     if(libv.canConvert(QVariant::String)) {
         libdir = libv.toString();
@@ -1546,14 +1695,147 @@ QStringList BuildC::getLibraryList(QStringList &ILlist, QString projFile)
     /* invalidate cache each time we build */
     filesHash.clear();
 
-    foreach(QString srcFile, srcList) {
-        autoAddLib(projectPath, srcFile, libdir, ilist, &newList);
+    /*
+     * Let the preprocessor say which headers are really reached.
+     * Each header it can't find may name a library; add those and
+     * scan again until nothing new turns up.
+     */
+    QString absPath = QFileInfo(projFile).absolutePath()+"/";
+    bool scanned = false;
+    for(int pass = 0; pass < 16; pass++) {
+        scanned = scanDependencies(files, absPath, newList);
+        if(!scanned)
+            break;
+        bool added = false;
+        foreach(QString src, dependencySources(files)) {
+            foreach(QString hdr, depScanner.missingHeaders(QDir(absPath).absoluteFilePath(src))) {
+                QString inc = "lib"+shortFileName(hdr);
+                inc = inc.mid(0,inc.indexOf(".h"));
+                QString lib = findInclude(projectPath,libdir,inc);
+                if(lib.isEmpty() || lib.compare(projectPath) == 0 || newList.contains(lib))
+                    continue;
+                newList.append(lib);
+                added = true;
+            }
+        }
+        if(!added)
+            break;
+    }
+
+    /* text scan only when the compiler can't be run */
+    if(!scanned) {
+        newList.clear();
+        foreach(QString srcFile, srcList) {
+            autoAddLib(projectPath, srcFile, libdir, ilist, &newList);
+        }
     }
 
     newList.removeDuplicates();
+    autoLibDirs.insert(projFile, newList);
     return newList;
 }
 
+/*
+ * C and C++ sources from project items, following links.
+ */
+QStringList BuildC::dependencySources(QStringList items)
+{
+    QStringList list;
+    foreach(QString s, items) {
+        s = s.trimmed();
+        if(s.isEmpty() || s.at(0) == '>' || s.indexOf("-I") == 0 || s.indexOf("-L") == 0)
+            continue;
+        if(s.indexOf("->") > 0)
+            s = s.mid(s.indexOf("->")+2).trimmed();
+        QString ext = QFileInfo(s).suffix().toLower();
+        if(ext == "c" || ext == "cpp" || ext == "cc" || ext == "cxx")
+            list.append(s);
+    }
+    return list;
+}
+
+/*
+ * Preprocessor flags for dependency scans, the same options and defines
+ * as the compile. Autolib, incremental builds and zip all use these so
+ * they share cached results.
+ */
+QStringList BuildC::dependencyFlags(QStringList items, QStringList libDirs)
+{
+    QStringList flags;
+    QString mm = getMemModel();
+    mm = mm.mid(0,mm.indexOf(" "));
+    appendCompilerOptions(&flags, mm, false);
+    flags.append("-I");
+    flags.append(".");
+    foreach(QString s, items) {
+        s = s.trimmed();
+        if(s.indexOf("-I") == 0) {
+            flags.append("-I");
+            flags.append(s.mid(2).trimmed());
+        }
+    }
+    foreach(QString dir, libDirs) {
+        flags.append("-I");
+        flags.append(dir);
+    }
+    return flags;
+}
+
+bool BuildC::scanDependencies(QStringList items, QString projectPath, QStringList libDirs)
+{
+    QString gcc = aSideCompiler;
+    if(gcc.isEmpty()) {
+        SettingsCache *settings = SettingsCache::instance();
+        gcc = settings->value(gccCompilerKey).toString();
+    }
+    QStringList sources = dependencySources(items);
+    if(gcc.isEmpty() || sources.isEmpty())
+        return false;
+
+    TraceSpan span("dependencies", "scan");
+    span.setArg("sources", sources.count());
+    depScanner.setCompiler(gcc);
+    return depScanner.scan(sources, dependencyFlags(items, libDirs), projectPath);
+}
+
+/*
+ * Headers inside the project folder that the sources include,
+ * relative to the project. Used when zipping a project.
+ */
+QStringList BuildC::getLocalHeaders(QString projFile)
+{
+    QStringList headers;
+    QStringList items;
+    QFile proj(projFile);
+    if(proj.open(QFile::ReadOnly | QFile::Text)) {
+        items = QString(proj.readAll()).split("\n",QString::SkipEmptyParts);
+        proj.close();
+    }
+
+    QStringList libDirs;
+#ifdef ENABLE_AUTOLIB
+    if(properties->getAutoLib()) {
+        QStringList none;
+        libDirs = getLibraryList(none, projFile);
+    }
+#endif
+
+    QString projectPath = QFileInfo(projFile).absolutePath()+"/";
+    if(!scanDependencies(items, projectPath, libDirs))
+        return headers;
+
+    QDir dir(projectPath);
+    foreach(QString src, dependencySources(items)) {
+        foreach(QString dep, depScanner.dependencies(dir.absoluteFilePath(src))) {
+            QString rel = dir.relativeFilePath(dep);
+            if(rel.indexOf("../") == 0 || QDir::isAbsolutePath(rel) || headers.contains(rel))
+                continue;
+            headers.append(rel);
+        }
+    }
+    return headers;
+}
+
 int  BuildC::autoAddLib(QString projectPath, QString srcFile, QString libdir, QStringList incList, QStringList *newList)
 {
     QApplication::processEvents();
@@ -1649,7 +1931,6 @@ QString BuildC::findIncludePath(QString projdir, QString libdir, QString include
     // if we get here, not project code was found - look in global library
     s = Directory::recursiveFindFile(libdir,include);
     if(s.length() > 0) {
-        s = Directory::recursiveFindFile(libdir, include);
         incHash.insert(include, s);
         return s;
     }
@@ -21,6 +21,8 @@
 #define BUILDC_H
 
 #include "build.h"
+#include "objectcache.h"
+#include "depscanner.h"
 
 class BuildC : public Build
 {
@@ -56,10 +58,17 @@ public:
     bool isOutdated(QStringList srclist, QString srcpath, QString target);
     QStringList getLocalSourceList(QStringList &LLlist);
     QStringList getLibraryList(QStringList &ILlist, QString projectFile);
+    QStringList getLocalHeaders(QString projFile);
     QString findInclude(QString projdir, QString libdir, QString include);
 
 private:
     QString findIncludePath(QString projdir, QString libdir, QString include);
+    void setupObjectCache();
+    int  runCachedCompile(QString compstr, QStringList tlist, QString srcFile, QString objPath);
+    void appendCompilerOptions(QStringList *args, QString model, bool report);
+    QStringList dependencySources(QStringList items);
+    QStringList dependencyFlags(QStringList items, QStringList libDirs);
+    bool scanDependencies(QStringList items, QString projectPath, QStringList libDirs);
 
 private:
     QString projName;
@@ -68,6 +77,9 @@ private:
     QString exePath;
     QString exeName;
     QString memModel;
+    ObjectCache objectCache;
+    DependencyScanner depScanner;
+    QHash<QString, QStringList> autoLibDirs;   // last autolib result per project
 };
 
 #endif // BUILDC_H
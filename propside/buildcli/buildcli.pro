@@ -0,0 +1,77 @@
+# -------------------------------------------------
+# simpleide-build builds .side projects from the command line with the
+# same BuildC/BuildSpin code the IDE uses. With Qt5 it runs on the
+# offscreen platform, so no X11 display is needed.
+# -------------------------------------------------
+
+QT += core
+QT += gui
+
+greaterThan(QT_MAJOR_VERSION, 4): {
+    QT -= gui
+    QT += widgets
+    DEFINES += QT5
+}
+
+TARGET   = simpleide-build
+TEMPLATE = app
+CONFIG  += console
+CONFIG  -= app_bundle
+DEFINES += SPINSIDE
+DEFINES += SPIN
+DEFINES += ENABLE_AUTOLIB
+
+INCLUDEPATH += ..
+INCLUDEPATH += $$[QT_INSTALL_PREFIX]/src/3rdparty/zlib
+
+SOURCES += main.cpp \
+    builddriver.cpp \
+    ../build.cpp \
+    ../buildtrace.cpp \
+    ../buildc.cpp \
+    ../buildspin.cpp \
+    ../spinparser.cpp \
+    ../blinker.cpp \
+    ../diagnostics.cpp \
+    ../elfreader.cpp \
+    ../objectcache.cpp \
+    ../depscanner.cpp \
+    ../projectoptions.cpp \
+    ../properties.cpp \
+    ../settingscache.cpp \
+    ../asideconfig.cpp \
+    ../asideboard.cpp \
+    ../hintdialog.cpp \
+    ../directory.cpp \
+    ../fileindex.cpp \
+    ../treecopy.cpp \
+    ../treeremove.cpp \
+    ../zip.cpp \
+    ../zipper.cpp \
+    ../StatusDialog.cpp \
+    ../workspacedialog.cpp
+HEADERS += builddriver.h \
+    ../build.h \
+    ../buildtrace.h \
+    ../buildc.h \
+    ../buildspin.h \
+    ../blinker.h \
+    ../diagnostics.h \
+    ../depscanner.h \
+    ../projectoptions.h \
+    ../properties.h \
+    ../settingscache.h \
+    ../asideconfig.h \
+    ../asideboard.h \
+    ../hintdialog.h \
+    ../StatusDialog.h \
+    ../workspacedialog.h \
+    ../zipper.h \
+    ../fileindex.h \
+    ../treecopy.h \
+    ../treeremove.h
+FORMS += ../project.ui \
+    ../hintdialog.ui
+
+unix:LIBS += -lz
+win32:LIBS += -L$$PWD/.. -lzlib1
@@ -0,0 +1,197 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include "builddriver.h"
+#include "buildc.h"
+#include "buildspin.h"
+#include "properties.h"
+#include "projectoptions.h"
+
+BuildDriver::BuildDriver(QObject *parent) : QObject(parent)
+{
+    verbose = false;
+    isSpin = false;
+    builder = NULL;
+
+    window = new QWidget();
+    properties = new Properties(window);
+    cbBoard = new QComboBox(window);
+    projectOptions = new ProjectOptions(window, cbBoard);
+    compileStatus = new QPlainTextEdit(window);
+    status = new QLabel(window);
+    programSize = new QLabel(window);
+    progress = new QProgressBar(window);
+
+    buildC = new BuildC(projectOptions, compileStatus, status, programSize, progress, cbBoard, properties);
+    buildSpin = new BuildSpin(projectOptions, compileStatus, status, programSize, progress, cbBoard, properties);
+
+    connect(buildC->diagnosticModel(), SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(diagnosticsInserted(QModelIndex,int,int)));
+    connect(buildSpin->diagnosticModel(), SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(diagnosticsInserted(QModelIndex,int,int)));
+
+    /* nobody is there to answer a message box */
+    connect(&dialogTimer, SIGNAL(timeout()), this, SLOT(dismissDialogs()));
+    dialogTimer.start(100);
+
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant compv = settings->value(gccCompilerKey);
+    if(compv.canConvert(QVariant::String))
+        compiler = compv.toString();
+}
+
+BuildDriver::~BuildDriver()
+{
+    delete buildC;
+    delete buildSpin;
+    delete window;
+}
+
+/*
+ * Read compiler, board and options from the .side file the same way
+ * the IDE does, without rewriting the file.
+ */
+bool BuildDriver::loadProject(QString sideFile)
+{
+    QFile file(sideFile);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+        return false;
+    QString proj = file.readAll();
+    file.close();
+
+    isSpin = proj.contains(">compiler=SPIN", Qt::CaseInsensitive);
+    if(isSpin)
+        projectOptions->setCompiler(ProjectOptions::SPIN_COMPILER);
+    else if(proj.contains(">compiler=C++", Qt::CaseInsensitive))
+        projectOptions->setCompiler(ProjectOptions::CPP_COMPILER);
+    else
+        projectOptions->setCompiler("C");
+
+    QString board = boardOverride;
+    projectOptions->clearOptions();
+    foreach(QString arg, proj.split("\n")) {
+        arg = arg.trimmed();
+        if(!arg.length() || arg.at(0) != '>')
+            continue;
+        if(arg.contains(ProjectOptions::board+"::")) {
+            QStringList barr = arg.split("::");
+            if(barr.count() > 1 && board.isEmpty())
+                board = barr.at(1);
+        }
+        else if(isSpin) {
+            projectOptions->setSpinOptions(arg);
+        }
+        else {
+            projectOptions->setOptions(arg);
+        }
+    }
+
+    cbBoard->clear();
+    if(board.length() > 0) {
+        cbBoard->addItem(board);
+        projectOptions->setBoardType(board);
+    }
+    return true;
+}
+
+int BuildDriver::build(QString sideFile)
+{
+    QFileInfo info(sideFile);
+    if(!info.exists()) {
+        fprintf(stderr, "%s: no such project\n", sideFile.toLocal8Bit().constData());
+        return ExitSetup;
+    }
+    QString projectFile = QDir::fromNativeSeparators(info.absoluteFilePath());
+    projectPath = info.absolutePath();
+
+    if(!loadProject(projectFile)) {
+        fprintf(stderr, "%s: can't read project\n", sideFile.toLocal8Bit().constData());
+        return ExitSetup;
+    }
+    if(!isSpin && !QFile::exists(compiler)) {
+        fprintf(stderr, "%s: compiler not found \"%s\"\n", sideFile.toLocal8Bit().constData(),
+                compiler.toLocal8Bit().constData());
+        return ExitSetup;
+    }
+
+    builder = isSpin ? (Build *)buildSpin : (Build *)buildC;
+    BuildTrace::clear();
+    int rc;
+    {
+        TraceSpan span("build", "build");
+        span.setArg("project", projectFile);
+        rc = builder->runBuild("", projectFile, compiler);
+        span.setArg("exit", rc);
+    }
+    BuildTrace::save(BuildTrace::traceFile(info.absolutePath()+"/"));
+
+    if(verbose)
+        fprintf(stderr, "%s\n", compileStatus->toPlainText().toLocal8Bit().constData());
+
+    DiagnosticModel *model = builder->diagnosticModel();
+    fprintf(stderr, "%s: %s (%d errors, %d warnings) %s\n", sideFile.toLocal8Bit().constData(),
+            rc == 0 ? "OK" : "FAILED", model->errorCount(), model->warningCount(),
+            programSize->text().toLocal8Bit().constData());
+    fflush(stderr);
+
+    return rc == 0 ? ExitOk : ExitFailed;
+}
+
+/*
+ * gcc style file:line:column: severity: message, one per line, with absolute paths.
+ */
+void BuildDriver::diagnosticsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    DiagnosticModel *model = qobject_cast<DiagnosticModel *>(sender());
+    if(model == NULL)
+        return;
+
+    static const char *sev[] = { "note", "warning", "error" };
+    for(int n = first; n <= last; n++) {
+        const Diagnostic &diag = model->at(n);
+        QString file = QDir::cleanPath(QDir(projectPath).absoluteFilePath(diag.file));
+        printf("%s:%d:%d: %s: %s\n", QDir::toNativeSeparators(file).toLocal8Bit().constData(),
+               diag.line, diag.column, sev[diag.severity], diag.message.toLocal8Bit().constData());
+    }
+    fflush(stdout);
+}
+
+/*
+ * Answer any message box the build code opens: "No" when there is a
+ * choice, otherwise OK. The text goes to stderr.
+ */
+void BuildDriver::dismissDialogs()
+{
+    foreach(QWidget *w, QApplication::topLevelWidgets()) {
+        QMessageBox *mbox = qobject_cast<QMessageBox *>(w);
+        if(mbox == NULL || !mbox->isVisible())
+            continue;
+        QString text = mbox->text();
+        if(mbox->informativeText().length() > 0)
+            text += " "+mbox->informativeText();
+        fprintf(stderr, "simpleide-build: %s\n", text.simplified().toLocal8Bit().constData());
+        if(mbox->standardButtons() & QMessageBox::No)
+            mbox->done(QMessageBox::No);
+        else
+            mbox->done(QMessageBox::Ok);
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUILDDRIVER_H
+#define BUILDDRIVER_H
+
+#include "qtversion.h"
+
+class Properties;
+class ProjectOptions;
+class BuildC;
+class BuildSpin;
+class Build;
+
+/*
+ * Builds one .side project without showing any window.
+ * The widgets Build needs are created but never shown.
+ */
+class BuildDriver : public QObject
+{
+    Q_OBJECT
+public:
+    enum { ExitOk = 0, ExitFailed = 1, ExitSetup = 2 };
+
+    BuildDriver(QObject *parent = 0);
+    virtual ~BuildDriver();
+
+    void setVerbose(bool v) { verbose = v; }
+    void setCompiler(QString path) { compiler = path; }
+    void setBoard(QString name) { boardOverride = name; }
+
+    int  build(QString sideFile);
+
+private slots:
+    void diagnosticsInserted(const QModelIndex &parent, int first, int last);
+    void dismissDialogs();
+
+private:
+    bool loadProject(QString sideFile);
+
+    QWidget         *window;
+    Properties      *properties;
+    QComboBox       *cbBoard;
+    ProjectOptions  *projectOptions;
+    QPlainTextEdit  *compileStatus;
+    QLabel          *status;
+    QLabel          *programSize;
+    QProgressBar    *progress;
+    BuildC          *buildC;
+    BuildSpin       *buildSpin;
+    Build           *builder;
+    QTimer          dialogTimer;
+
+    QString         compiler;
+    QString         boardOverride;
+    QString         projectPath;
+    bool            isSpin;
+    bool            verbose;
+};
+
+#endif // BUILDDRIVER_H
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * simpleide-build - build SimpleIDE projects without the GUI.
+ *
+ * simpleide-build [options] project.side ...
+ *   -j <n>              build up to n projects at once (default 1)
+ *   -compiler <path>    propeller-elf-gcc to use instead of the IDE setting
+ *   -board <name>       board type instead of the one in the project
+ *   -v                  print the full build log to stderr
+ *   -trace              write a Chrome trace.json next to each project
+ *
+ * Diagnostics go to stdout as file:line:column: severity: message.
+ * Exit status is 0 when every project built, 1 when a build failed
+ * and 2 for usage or setup errors.
+ */
+
+#include <stdio.h>
+
+#include "qtversion.h"
+#include "builddriver.h"
+#include "buildtrace.h"
+
+static void usage()
+{
+    fprintf(stderr, "usage: simpleide-build [-j n] [-compiler path] [-board name] [-v] [-trace] project.side ...\n");
+}
+
+/*
+ * Each project builds in its own child process so the synchronous
+ * build code never has to share an event loop. Child output is held
+ * until the child exits so lines from different projects don't mix.
+ */
+static int runJobs(QStringList projects, QStringList childArgs, int jobs)
+{
+    QString self = QCoreApplication::applicationFilePath();
+    QList<QProcess *> running;
+    int result = BuildDriver::ExitOk;
+
+    while(projects.count() > 0 || running.count() > 0) {
+        while(projects.count() > 0 && running.count() < jobs) {
+            QProcess *proc = new QProcess();
+            QString project = projects.takeFirst();
+            proc->setProperty("Project", QVariant(project));
+            proc->start(self, QStringList(childArgs) << project);
+            running.append(proc);
+        }
+
+        QProcess *done = NULL;
+        while(done == NULL) {
+            foreach(QProcess *proc, running) {
+                if(proc->state() == QProcess::NotRunning || proc->waitForFinished(20)) {
+                    done = proc;
+                    break;
+                }
+            }
+        }
+        running.removeOne(done);
+
+        QByteArray out = done->readAllStandardOutput();
+        QByteArray err = done->readAllStandardError();
+        fwrite(out.constData(), 1, out.size(), stdout);
+        fwrite(err.constData(), 1, err.size(), stderr);
+        fflush(stdout);
+        fflush(stderr);
+
+        int rc;
+        if(done->error() == QProcess::FailedToStart) {
+            // a child that never ran reports NormalExit with code 0
+            fprintf(stderr, "%s: can't start %s\n", done->property("Project").toString().toLocal8Bit().constData(),
+                    self.toLocal8Bit().constData());
+            rc = BuildDriver::ExitSetup;
+        }
+        else {
+            rc = done->exitStatus() == QProcess::NormalExit ? done->exitCode() : BuildDriver::ExitFailed;
+        }
+        if(rc > result)
+            result = rc;
+        delete done;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef QT5
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+#endif
+    QApplication app(argc, argv);
+    // same cache location as the IDE
+    QCoreApplication::setApplicationName("SimpleIDE");
+
+    QStringList args = app.arguments();
+    QStringList projects;
+    QStringList childArgs;
+    QString compiler;
+    QString board;
+    bool verbose = false;
+    int jobs = 1;
+
+    for(int n = 1; n < args.count(); n++) {
+        QString arg = args[n];
+        if(arg.compare("-j") == 0 && n+1 < args.count()) {
+            jobs = qMax(1, args[++n].toInt());
+        }
+        else if(arg.startsWith("-j") && arg.length() > 2) {
+            jobs = qMax(1, arg.mid(2).toInt());
+        }
+        else if(arg.compare("-compiler") == 0 && n+1 < args.count()) {
+            compiler = args[++n];
+            childArgs << arg << compiler;
+        }
+        else if(arg.compare("-board") == 0 && n+1 < args.count()) {
+            board = args[++n];
+            childArgs << arg << board;
+        }
+        else if(arg.compare("-v") == 0) {
+            verbose = true;
+            childArgs << arg;
+        }
+        else if(arg.compare("-trace") == 0) {
+            BuildTrace::setEnabled(true);
+            childArgs << arg;
+        }
+        else if(arg.startsWith("-")) {
+            usage();
+            return BuildDriver::ExitSetup;
+        }
+        else {
+            projects.append(arg);
+        }
+    }
+
+    if(projects.isEmpty()) {
+        usage();
+        return BuildDriver::ExitSetup;
+    }
+
+    if(jobs > 1 && projects.count() > 1)
+        return runJobs(projects, childArgs, jobs);
+
+    BuildDriver driver;
+    driver.setVerbose(verbose);
+    if(compiler.length() > 0)
+        driver.setCompiler(QDir::fromNativeSeparators(compiler));
+    if(board.length() > 0)
+        driver.setBoard(board);
+
+    int result = BuildDriver::ExitOk;
+    foreach(QString project, projects) {
+        int rc = driver.build(project);
+        if(rc > result)
+            result = rc;
+    }
+    return result;
+}
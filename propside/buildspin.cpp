@@ -22,6 +22,7 @@
 
 #include "properties.h"
 #include "asideconfig.h"
+#include "objectcache.h"
 
 BuildSpin::BuildSpin(ProjectOptions *projopts, QPlainTextEdit *compstat, QLabel *stat, QLabel *progsize, QProgressBar *progbar, QComboBox *cb, Properties *p)
     : Build(projopts, compstat, stat, progsize, progbar, cb, p)
@@ -51,6 +52,7 @@ int  BuildSpin::runBuild(QString option, QString projfile, QString compiler)
     progress->show();
     programSize->setText("");
 
+    diagnostics->clear();
     compileStatus->setPlainText(tr("Project Directory: ")+sourcePath(projectFile)+"\r\n");
     compileStatus->moveCursor(QTextCursor::End);
     status->setText(tr("Building ...")+" "+spinfile);
@@ -117,7 +119,31 @@ int  BuildSpin::runBstc(QString spinfile)
 
     args.append(spinfile); // using shortname limits us to files in the project directory.
 
-    rc = startProgram(spin, sourcePath(projectFile), args);
+    /*
+     * Skip the compile when the .binary was made from exactly this
+     * object tree, compiler and options. The stamp also keeps the size.
+     */
+    QString binary = sourcePath(projectFile)+spinfile.mid(0,spinfile.lastIndexOf("."))+".binary";
+    QString stampFile = binary+".stamp";
+    QString stamp = buildStamp(spinfile, spin, args);
+    QStringList saved;
+    QFile sfile(stampFile);
+    if(QFile::exists(binary) && sfile.open(QFile::ReadOnly | QFile::Text)) {
+        saved = QString(sfile.readAll()).split("\n");
+        sfile.close();
+    }
+    if(saved.count() > 1 && saved.at(0).compare(stamp) == 0) {
+        codeSize = saved.at(1).toInt();
+        compileStatus->appendPlainText(tr("Build not needed.")+" "+shortFileName(binary)+" "+tr("is up to date."));
+    }
+    else {
+        QFile::remove(stampFile);
+        rc = startProgram(spin, sourcePath(projectFile), args);
+        if(rc == 0 && QFile::exists(binary) && sfile.open(QFile::WriteOnly | QFile::Text)) {
+            sfile.write(QString("%1\n%2\n").arg(stamp).arg(codeSize).toLatin1());
+            sfile.close();
+        }
+    }
 
     /*
      * Report program size
@@ -131,6 +157,59 @@ int  BuildSpin::runBstc(QString spinfile)
     return rc;
 }
 
+/*
+ * Hash of every file in the OBJ tree, any DAT "file" includes,
+ * the compiler identity and the command line.
+ */
+QString BuildSpin::buildStamp(QString spinfile, QString spin, QStringList args)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(ObjectCache::compilerIdentity(spin).toUtf8());
+    hash.addData(args.join("\n").toUtf8());
+
+    QString projdir = sourcePath(projectFile);
+    QString libdir = properties->getSpinLibraryStr();
+    QStringList files = spinParser.spinFileTree(projdir+spinfile, libdir);
+    QRegExp datfile("\\bfile\\s+\"([^\"]+)\"", Qt::CaseInsensitive);
+    QStringList hashed;
+
+    for(int n = 0; n < files.count(); n++) {
+        QString name = QString(files[n]).trimmed();
+        QString path = projdir+name;
+        if(!QFile::exists(path))
+            path = QDir(libdir).filePath(name);
+        if(hashed.contains(path))
+            continue;
+        hashed.append(path);
+
+        hash.addData(name.toUtf8());
+        QFile file(path);
+        if(!file.open(QFile::ReadOnly)) {
+            hash.addData("missing");
+            continue;
+        }
+        QByteArray bytes = file.readAll();
+        file.close();
+        hash.addData(bytes);
+
+        if(name.endsWith(".spin", Qt::CaseInsensitive)) {
+            /* most Spin files are UTF-16; read them like SpinParser does */
+            QBuffer buffer(&bytes);
+            buffer.open(QIODevice::ReadOnly);
+            QTextStream in(&buffer);
+            in.setAutoDetectUnicode(true);
+            QString text = in.readAll();
+            buffer.close();
+            int pos = 0;
+            while((pos = datfile.indexIn(text, pos)) > -1) {
+                files.append(datfile.cap(1));
+                pos += datfile.matchedLength();
+            }
+        }
+    }
+    return QString(hash.result().toHex());
+}
+
 void BuildSpin::appendLoaderParameters(QString copts, QString projfile, QStringList *args)
 {
     QString filename = projectFile.mid(projectFile.lastIndexOf("/")+1);
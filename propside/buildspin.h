@@ -21,6 +21,7 @@
 #define BUILDSPIN_H
 
 #include "build.h"
+#include "spinparser.h"
 
 class BuildSpin : public Build
 {
@@ -34,6 +35,10 @@ public:
     int  runBstc(QString spinfile);
     void appendLoaderParameters(QString copts, QString projfile, QStringList *args);
 
+private:
+    QString buildStamp(QString spinfile, QString spin, QStringList args);
+
+    SpinParser spinParser;
 };
 
 #endif // BUILDSPIN_H
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buildtrace.h"
+
+bool          BuildTrace::enabled = false;
+QMutex        BuildTrace::mutex;
+QElapsedTimer BuildTrace::clock;
+QList<BuildTrace::Event> BuildTrace::events;
+
+void BuildTrace::setEnabled(bool enable)
+{
+    QMutexLocker lock(&mutex);
+    enabled = enable;
+    if(enabled && !clock.isValid())
+        clock.start();
+}
+
+void BuildTrace::clear()
+{
+    QMutexLocker lock(&mutex);
+    events.clear();
+}
+
+/*
+ * Microseconds since tracing was enabled.
+ */
+qint64 BuildTrace::now()
+{
+    if(!enabled)
+        return 0;
+    return clock.nsecsElapsed()/1000;
+}
+
+void BuildTrace::complete(const QString &name, const QString &category, qint64 start, const QVariantMap &args)
+{
+    if(!enabled)
+        return;
+    Event ev;
+    ev.name = name;
+    ev.category = category;
+    ev.start = start;
+    ev.duration = now()-start;
+    ev.thread = (quintptr)QThread::currentThreadId();
+    ev.args = args;
+
+    QMutexLocker lock(&mutex);
+    events.append(ev);
+}
+
+/*
+ * SIMPLEIDE_TRACE may name the output file; otherwise trace.json
+ * goes next to the project.
+ */
+QString BuildTrace::traceFile(const QString &projectPath)
+{
+    QString env = QString::fromLocal8Bit(qgetenv("SIMPLEIDE_TRACE"));
+    if(env.endsWith(".json", Qt::CaseInsensitive))
+        return env;
+    return projectPath+"trace.json";
+}
+
+QString BuildTrace::escape(const QString &s)
+{
+    QString out;
+    out.reserve(s.length()+2);
+    out += '"';
+    for(int n = 0; n < s.length(); n++) {
+        QChar c = s.at(n);
+        if(c == '"' || c == '\\')
+            out += QString("\\")+c;
+        else if(c == '\n')
+            out += "\\n";
+        else if(c == '\t')
+            out += "\\t";
+        else if(c.unicode() < 0x20)
+            out += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        else
+            out += c;
+    }
+    out += '"';
+    return out;
+}
+
+bool BuildTrace::save(const QString &fileName)
+{
+    if(!enabled)
+        return false;
+
+    QFile file(fileName);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QMutexLocker lock(&mutex);
+
+    /* threads are numbered in order of appearance */
+    QList<quintptr> threads;
+    qint64 pid = QCoreApplication::applicationPid();
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << "{\"traceEvents\":[\n";
+    for(int n = 0; n < events.count(); n++) {
+        const Event &ev = events.at(n);
+        if(!threads.contains(ev.thread))
+            threads.append(ev.thread);
+        out << "{\"name\":" << escape(ev.name)
+            << ",\"cat\":" << escape(ev.category)
+            << ",\"ph\":\"X\",\"ts\":" << ev.start
+            << ",\"dur\":" << ev.duration
+            << ",\"pid\":" << pid
+            << ",\"tid\":" << threads.indexOf(ev.thread)+1
+            << ",\"args\":{";
+        QVariantMap::const_iterator it = ev.args.constBegin();
+        for(; it != ev.args.constEnd(); ++it) {
+            if(it != ev.args.constBegin())
+                out << ",";
+            out << escape(it.key()) << ":";
+            if(it.value().type() == QVariant::Int || it.value().type() == QVariant::LongLong)
+                out << it.value().toLongLong();
+            else
+                out << escape(it.value().toString());
+        }
+        out << "}}" << (n < events.count()-1 ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+    file.close();
+    return true;
+}
+
+TraceSpan::TraceSpan(const QString &name, const QString &category)
+    : name(name), category(category), finished(false)
+{
+    start = BuildTrace::now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    finish();
+}
+
+/*
+ * Ends the span early, e.g. before saving the trace.
+ */
+void TraceSpan::finish()
+{
+    if(finished)
+        return;
+    finished = true;
+    BuildTrace::complete(name, category, start, args);
+}
+
+void TraceSpan::setArg(const QString &key, const QVariant &value)
+{
+    if(BuildTrace::isEnabled())
+        args.insert(key, value);
+}
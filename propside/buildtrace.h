@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUILDTRACE_H
+#define BUILDTRACE_H
+
+#include <QtCore>
+
+/*
+ * Build timeline in Chrome trace event format.
+ * Open the saved trace.json with chrome://tracing or ui.perfetto.dev.
+ * Recording is off unless enabled; spans then cost one clock read each.
+ */
+class BuildTrace
+{
+public:
+    static void setEnabled(bool enable);
+    static bool isEnabled() { return enabled; }
+
+    static void clear();
+    static qint64 now();
+    static void complete(const QString &name, const QString &category, qint64 start, const QVariantMap &args);
+    static bool save(const QString &fileName);
+    static QString traceFile(const QString &projectPath);
+
+private:
+    struct Event {
+        QString     name;
+        QString     category;
+        qint64      start;
+        qint64      duration;
+        quintptr    thread;
+        QVariantMap args;
+    };
+
+    static QString escape(const QString &s);
+
+    static bool          enabled;
+    static QMutex        mutex;
+    static QElapsedTimer clock;
+    static QList<Event>  events;
+};
+
+/*
+ * Records one span from construction to destruction.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const QString &name, const QString &category);
+    ~TraceSpan();
+
+    void setArg(const QString &key, const QVariant &value);
+    void finish();
+
+private:
+    QString     name;
+    QString     category;
+    qint64      start;
+    bool        finished;
+    QVariantMap args;
+};
+
+#endif // BUILDTRACE_H
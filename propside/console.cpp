@@ -45,6 +45,9 @@ Console::Console(QWidget *parent) : QPlainTextEdit(parent)
     for(int n = 0; n < maxhex; n++)
         hexbyte[n] = 0;
     sbuff = NULL;
+    received = 0;
+    windowLines = WindowLines;
+    scrollbackEnabled = true;
     // experimenting with wraps ... just turn it off.
     this->setLineWrapMode(QPlainTextEdit::NoWrap);
 }
@@ -83,6 +86,7 @@ void Console::clear()
     hexbytes = 0;
     for(int n = 0; n < maxhex; n++)
         hexbyte[n] = 0;
+    scrollback.clear();
     setPlainText("");
 }
 
@@ -285,6 +289,131 @@ void Console::setHexDump(bool enable)
     hexdump = enable;
 }
 
+/*
+ * The widget only holds a window of the most recent lines because
+ * QPlainTextEdit gets slow with big documents. Lines that scroll
+ * out of the window are moved to the Scrollback store.
+ * A buffer size of WindowLines or less just limits the window.
+ */
+void Console::setScrollbackLines(qint64 lines)
+{
+    if(lines > 0 && lines <= WindowLines) {
+        windowLines = (int)lines;
+        scrollbackEnabled = false;
+        scrollback.clear();
+    }
+    else {
+        windowLines = WindowLines;
+        scrollbackEnabled = true;
+        scrollback.setMaxLines(lines > 0 ? lines-windowLines : 0);
+    }
+    trimToWindow();
+}
+
+void Console::trimToWindow()
+{
+    int extra = blockCount() - windowLines;
+    if(extra < 1)
+        return;
+
+    if(scrollbackEnabled) {
+        QTextBlock block = document()->firstBlock();
+        for(int n = 0; n < extra && block.isValid(); n++) {
+            scrollback.appendLine(block.text());
+            block = block.next();
+        }
+    }
+    QTextCursor cur(document());
+    cur.movePosition(QTextCursor::Start);
+    cur.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, extra);
+    cur.removeSelectedText();
+}
+
+qint64 Console::bytesReceived()
+{
+    return received;
+}
+
+/*
+ * History line numbers are absolute. Lines before historyWindowLine()
+ * are in the scrollback store, the rest are blocks in the widget.
+ */
+qint64 Console::historyFirstLine()
+{
+    return scrollback.firstLine();
+}
+
+qint64 Console::historyEndLine()
+{
+    return scrollback.endLine() + blockCount();
+}
+
+qint64 Console::historyWindowLine()
+{
+    return scrollback.endLine();
+}
+
+QString Console::historyLine(qint64 number)
+{
+    if(number < scrollback.endLine())
+        return scrollback.line(number);
+    return document()->findBlockByNumber((int)(number - scrollback.endLine())).text();
+}
+
+QStringList Console::historyLines(qint64 number, int count)
+{
+    QStringList list = scrollback.lines(number, count);
+    number += list.count();
+    count -= list.count();
+    if(number < scrollback.endLine()) {
+        count -= (int)(scrollback.endLine() - number);
+        number = scrollback.endLine();
+    }
+    QTextBlock block = document()->findBlockByNumber((int)(number - scrollback.endLine()));
+    for(; count > 0 && block.isValid(); count--) {
+        list.append(block.text());
+        block = block.next();
+    }
+    return list;
+}
+
+qint64 Console::findInHistory(const QString &text, qint64 from, bool forward)
+{
+    qint64 window = scrollback.endLine();
+    qint64 found = -1;
+
+    if(text.isEmpty())
+        return -1;
+
+    if(forward) {
+        if(from < window) {
+            found = scrollback.find(text, from, true);
+            if(found > -1)
+                return found;
+            from = window;
+        }
+        QTextBlock block = document()->findBlockByNumber((int)(from - window));
+        for(; block.isValid(); block = block.next()) {
+            if(block.text().contains(text, Qt::CaseInsensitive))
+                return window + block.blockNumber();
+        }
+    }
+    else {
+        if(from >= window) {
+            QTextBlock block = document()->findBlockByNumber((int)(from - window));
+            if(!block.isValid())
+                block = document()->lastBlock();
+            for(; block.isValid(); block = block.previous()) {
+                if(block.text().contains(text, Qt::CaseInsensitive))
+                    return window + block.blockNumber();
+            }
+            from = window-1;
+        }
+        found = scrollback.find(text, from, false);
+    }
+    return found;
+}
+
 #ifdef EVENT_DRIVEN
 enum { BUFFERSIZE = 2048 };
 #else
@@ -307,6 +436,7 @@ void Console::updateReady(QextSerialPort* port)
 
     QByteArray ba = port->readAll();
     length = ba.length();
+    received += length;
 #else
     if(port->bytesAvailable() < 1)
         return;
@@ -320,6 +450,7 @@ void Console::updateReady(QextSerialPort* port)
     if(hexmode != false) {
         for(int n = 0; n < length; n++)
             dumphex((int)buf[n]);
+        trimToWindow();
     }
     else {
 #if 1
@@ -335,6 +466,7 @@ void Console::updateReady(QextSerialPort* port)
                 for(int n = 0; n < jj; n++) {
                     update(ba.at(n));
                 }
+                trimToWindow();
                 QApplication::processEvents(QEventLoop::AllEvents, evlimit);
 
                 ba.remove(0,jj);
@@ -346,6 +478,7 @@ void Console::updateReady(QextSerialPort* port)
             if (port->isOpen()) {
                 ba = port->readAll();
                 length = ba.length();
+                received += length;
             }
         }
         this->setSerialPollEnable(true);
@@ -357,48 +490,67 @@ void Console::updateReady(QextSerialPort* port)
     QApplication::processEvents();
 }
 
+/*
+ * Read the socket in jcount sized pieces straight into a stack buffer.
+ * No QByteArray per read and no copying of the unread rest.
+ */
 void Console::updateReady(XEsp8266port* port)
 {
+    enum { jcount = 200 };
+    char buf[jcount];
+
     if(isEnabled == false)
         return;
 
-    qint64 length = port->bytesAvailable();
-    if(length < 1) return;
-
-    QByteArray ba = port->readAll();
-    length = ba.length();
-
-    if(hexmode != false) {
-        for(int n = 0; n < length; n++)
-            dumphex((int)ba[n]);
+    if(port->bytesAvailable() < 1) return;
+
+    // limit amount of time spent doing event updates
+    int evlimit= 100;
+    int length;
+    while (port->isOpen() && (length = port->read(buf, jcount)) > 0) {
+        extern bool g_ApplicationClosing;
+        if (g_ApplicationClosing) return;
+        received += length;
+        if(hexmode != false) {
+            for(int n = 0; n < length; n++)
+                dumphex((int)buf[n]);
+        }
+        else {
+            for(int n = 0; n < length; n++)
+                update(buf[n]);
+        }
+        trimToWindow();
+        QApplication::processEvents(QEventLoop::AllEvents, evlimit);
     }
-    else {
-        int jcount = 200;
-        // limit amount of time spent doing event updates
-        int evlimit= 100;
-        while (length > 0) {
-            int jj = (length > jcount) ? jcount : length;
-            while(jj > 0) {
-                extern bool g_ApplicationClosing;
-                if (g_ApplicationClosing) return;
-                for(int n = 0; n < jj; n++) {
-                    update(ba.at(n));
-                }
-                QApplication::processEvents(QEventLoop::AllEvents, evlimit);
+    QApplication::processEvents();
+}
 
-                ba.remove(0,jj);
-                length = ba.length();
-                jj = (length > jcount) ? jcount : length;
+/*
+ * XBee serial service data comes a datagram at a time.
+ */
+void Console::updateReady(XBeeSerialPort* port)
+{
+    if(isEnabled == false)
+        return;
 
-                //QApplication::processEvents(QEventLoop::AllEvents, evlimit);
-            }
-            if (port->isOpen()) {
-                ba = port->readAll();
-                length = ba.length();
-            }
+    // limit amount of time spent doing event updates
+    int evlimit= 100;
+    QByteArray ba = port->readAll();
+    while (port->isOpen() && ba.length() > 0) {
+        extern bool g_ApplicationClosing;
+        if (g_ApplicationClosing) return;
+        received += ba.length();
+        if(hexmode != false) {
+            for(int n = 0; n < ba.length(); n++)
+                dumphex((int)ba.at(n));
+        }
+        else {
+            for(int n = 0; n < ba.length(); n++)
+                update(ba.at(n));
         }
-        // simple but very slow way
-        // for(int n = 0; n < length; n++) update(ba[n]);
+        trimToWindow();
+        QApplication::processEvents(QEventLoop::AllEvents, evlimit);
+        ba = port->readAll();
     }
     QApplication::processEvents();
 }
@@ -23,6 +23,8 @@
 #include "qtversion.h"
 #include "qextserialport.h"
 #include "xesp8266port.h"
+#include "xbeeserialport.h"
+#include "scrollback.h"
 
 class Console : public QPlainTextEdit
 {
@@ -65,6 +67,17 @@ public:
     void setHexMode(bool enable);
     void setHexDump(bool enable);
 
+    void setScrollbackLines(qint64 lines);
+    qint64 historyFirstLine();
+    qint64 historyEndLine();
+    qint64 historyWindowLine();
+    QString historyLine(qint64 number);
+    QStringList historyLines(qint64 number, int count);
+    qint64 findInHistory(const QString &text, qint64 from, bool forward);
+    void trimToWindow();
+
+    qint64 bytesReceived();
+
 public:
 
     typedef enum {
@@ -154,6 +167,15 @@ private:
     // screen buffer
     char *sbuff;
 
+    // bytes taken from the port since the console was made
+    qint64 received;
+
+    // lines scrolled out of the widget window
+    enum { WindowLines = 512 };
+    Scrollback scrollback;
+    int  windowLines;
+    bool scrollbackEnabled;
+
 protected:
     void keyPressEvent(QKeyEvent* event);
     void resizeEvent(QResizeEvent *e);
@@ -161,6 +183,7 @@ protected:
 public slots:
     void updateReady(QextSerialPort*);
     void updateReady(XEsp8266port *);
+    void updateReady(XBeeSerialPort *);
     void dumphex(int ch);
     void update(char ch);
 
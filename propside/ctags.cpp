@@ -19,6 +19,7 @@
 
 #include "ctags.h"
 #include "mainwindow.h"
+#include "buildtrace.h"
 
 CTags::CTags(QString path, QObject *parent) : QObject(parent)
 {
@@ -133,6 +134,8 @@ int CTags::runCtags(QString path)
     for(int n = 0; n < args.count(); n++)
         qDebug() << args.at(n);
     */
+    TraceSpan span("ctags", "tool");
+    span.setArg("args", args.join(" "));
     process->start(ctagsProgram,args);
 
     /* process Qt application events until procDone
@@ -141,6 +144,7 @@ int CTags::runCtags(QString path)
         QApplication::processEvents();
 
     rc = process->exitCode();
+    span.setArg("exit", rc);
     return rc;
 }
 
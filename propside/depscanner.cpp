@@ -0,0 +1,232 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "depscanner.h"
+
+DependencyScanner::DependencyScanner()
+{
+}
+
+/*
+ * Run gcc -MM -MG for every source that has no current entry.
+ * Returns false if the compiler could not be run; callers then fall
+ * back to their own scanning.
+ */
+bool DependencyScanner::scan(QStringList sources, QStringList flags, QString workpath)
+{
+    if(compiler.isEmpty())
+        return false;
+
+    QString flagstr;
+    QStringList includes;
+    splitFlags(flags, &flagstr, &includes);
+    QDir dir(workpath);
+    QStringList todo;
+    foreach(QString src, sources) {
+        src = QDir::cleanPath(dir.absoluteFilePath(src));
+        if(!isCurrent(src, flagstr, includes, workpath) && !todo.contains(src))
+            todo.append(src);
+    }
+
+    int jobs = qMax(1, QThread::idealThreadCount());
+    QList<QProcess *> running;
+    QHash<QProcess *, QString> source;
+    bool ok = true;
+
+    while(ok && (todo.count() > 0 || running.count() > 0)) {
+        while(running.count() < jobs && todo.count() > 0) {
+            QString src = todo.takeFirst();
+            QProcess *proc = new QProcess();
+            proc->setWorkingDirectory(workpath);
+            proc->setProcessChannelMode(QProcess::SeparateChannels);
+            proc->start(compiler, QStringList() << flags << "-MM" << "-MG" << src);
+            if(!proc->waitForStarted()) {
+                delete proc;
+                ok = false;
+                break;
+            }
+            running.append(proc);
+            source[proc] = src;
+        }
+
+        for(int n = running.count()-1; n > -1; n--) {
+            QProcess *proc = running[n];
+            if(proc->state() != QProcess::NotRunning && !proc->waitForFinished(10))
+                continue;
+            if(proc->exitStatus() == QProcess::NormalExit && proc->exitCode() == 0)
+                finish(source[proc], flagstr, includes, workpath, proc->readAllStandardOutput());
+            else
+                ok = false;
+            running.removeAt(n);
+            delete proc;
+        }
+        QCoreApplication::processEvents();
+    }
+
+    foreach(QProcess *proc, running) {
+        proc->kill();
+        proc->waitForFinished(1000);
+        delete proc;
+    }
+    return ok;
+}
+
+/*
+ * Include directories are kept apart from the other flags so results
+ * survive autolib adding directories between passes.
+ */
+void DependencyScanner::splitFlags(QStringList flags, QString *other, QStringList *includes)
+{
+    QStringList rest;
+    for(int n = 0; n < flags.count(); n++) {
+        QString s = flags[n];
+        if(s.compare("-I") == 0 && n+1 < flags.count())
+            includes->append(flags[++n]);
+        else if(s.indexOf("-I") == 0)
+            includes->append(s.mid(2));
+        else
+            rest.append(s);
+    }
+    *other = rest.join(" ");
+}
+
+/*
+ * Content of the source plus time and size of each header it reached.
+ */
+QByteArray DependencyScanner::stamp(QString source, QStringList deps)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QFile file(source);
+    if(!file.open(QFile::ReadOnly))
+        return QByteArray();
+    hash.addData(file.readAll());
+    file.close();
+    foreach(QString dep, deps) {
+        QFileInfo info(dep);
+        if(!info.exists())
+            return QByteArray();
+        hash.addData(dep.toUtf8());
+        hash.addData(QString(" %1 %2\n").arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size()).toUtf8());
+    }
+    return hash.result();
+}
+
+void DependencyScanner::finish(QString source, QString flags, QStringList includes, QString workpath, const QByteArray &rule)
+{
+    QDir dir(workpath);
+    QStringList list = parseRule(rule);
+    Entry entry;
+    entry.flags = flags;
+    entry.includes = includes;
+    /* first prerequisite is the source itself */
+    for(int n = 1; n < list.count(); n++) {
+        QString dep = QDir::cleanPath(dir.absoluteFilePath(QDir::fromNativeSeparators(list[n])));
+        if(QFile::exists(dep))
+            entry.deps.append(dep);
+        else
+            entry.missing.append(list[n]);
+    }
+    entry.stamp = stamp(source, entry.deps);
+    cache.insert(source, entry);
+}
+
+/*
+ * Directories added after the ones of the last scan can't change how
+ * found headers resolve; they only matter if a missing header is there.
+ */
+bool DependencyScanner::isCurrent(QString source, QString flags, QStringList includes, QString workpath) const
+{
+    if(!cache.contains(source))
+        return false;
+    const Entry &entry = cache[source];
+    if(entry.flags != flags || entry.stamp.isEmpty())
+        return false;
+    if(entry.includes.count() > includes.count() || includes.mid(0, entry.includes.count()) != entry.includes)
+        return false;
+    if(stamp(source, entry.deps) != entry.stamp)
+        return false;
+
+    /* a header that was missing may exist now or be on a new path */
+    if(entry.missing.count() > 0) {
+        QDir work(workpath);
+        QList<QDir> dirs;
+        dirs.append(QDir(QFileInfo(source).absolutePath()));
+        foreach(QString inc, includes)
+            dirs.append(QDir(work.absoluteFilePath(inc)));
+        foreach(QString dep, entry.missing) {
+            foreach(QDir dir, dirs) {
+                if(dir.exists(dep))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+QStringList DependencyScanner::dependencies(QString source) const
+{
+    source = QDir::cleanPath(QDir(source).absolutePath());
+    if(!cache.contains(source))
+        return QStringList();
+    return cache[source].deps;
+}
+
+QStringList DependencyScanner::missingHeaders(QString source) const
+{
+    source = QDir::cleanPath(QDir(source).absolutePath());
+    if(!cache.contains(source))
+        return QStringList();
+    return cache[source].missing;
+}
+
+/*
+ * Split a make rule "target: prereq prereq \ ..." into prerequisites.
+ * Escaped spaces stay part of the name.
+ */
+QStringList DependencyScanner::parseRule(const QByteArray &rule)
+{
+    QString text = QString::fromLocal8Bit(rule);
+    text.replace("\\\r\n", " ");
+    text.replace("\\\n", " ");
+
+    QStringList list;
+    int colon = text.indexOf(": ");
+    if(colon < 0)
+        return list;
+
+    QString name;
+    for(int n = colon+2; n < text.length(); n++) {
+        QChar c = text.at(n);
+        if(c == '\\' && n+1 < text.length() && text.at(n+1) == ' ') {
+            name += ' ';
+            n++;
+        }
+        else if(c.isSpace()) {
+            if(name.length() > 0)
+                list.append(name);
+            name.clear();
+        }
+        else {
+            name += c;
+        }
+    }
+    if(name.length() > 0)
+        list.append(name);
+    return list;
+}
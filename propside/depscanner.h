@@ -0,0 +1,67 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEPSCANNER_H
+#define DEPSCANNER_H
+
+#include "qtversion.h"
+
+/*
+ * Header dependencies from the compiler's own preprocessor (gcc -MM -MG).
+ * Sources are scanned in parallel. A result is kept while the source's
+ * content and its headers are unchanged and the flags other than -I
+ * match. Adding include directories only rescans sources whose missing
+ * headers turn up in them. Headers the preprocessor could not find are
+ * reported separately so autolib can resolve them.
+ */
+class DependencyScanner
+{
+public:
+    DependencyScanner();
+
+    void    setCompiler(QString gcc) { compiler = gcc; }
+    QString getCompiler() const { return compiler; }
+
+    bool    scan(QStringList sources, QStringList flags, QString workpath);
+    void    clear() { cache.clear(); }
+
+    QStringList dependencies(QString source) const;
+    QStringList missingHeaders(QString source) const;
+
+    static QStringList parseRule(const QByteArray &rule);
+
+private:
+    struct Entry {
+        QString     flags;      // everything but -I
+        QStringList includes;   // -I directories in order
+        QByteArray  stamp;
+        QStringList deps;
+        QStringList missing;
+    };
+
+    static void splitFlags(QStringList flags, QString *other, QStringList *includes);
+    static QByteArray stamp(QString source, QStringList deps);
+    bool isCurrent(QString source, QString flags, QStringList includes, QString workpath) const;
+    void finish(QString source, QString flags, QStringList includes, QString workpath, const QByteArray &rule);
+
+    QString compiler;
+    QHash<QString, Entry> cache;
+};
+
+#endif // DEPSCANNER_H
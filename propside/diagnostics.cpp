@@ -0,0 +1,157 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics.h"
+
+DiagnosticParser::DiagnosticParser()
+    : gccRegex("^((?:[A-Za-z]:)?[^:]+):(\\d+):(?:(\\d+):)?\\s*(fatal error|error|warning|note):\\s*(.*)$"),
+      spinRegex("^(.+)\\((\\d+)[,:](\\d+)\\)\\s*:?\\s*(error|warning)\\s*:?\\s*(.*)$", Qt::CaseInsensitive)
+{
+}
+
+/*
+ * Cheap character checks first so ordinary output lines never reach the regex.
+ */
+bool DiagnosticParser::parse(const QString &line, Diagnostic &diag)
+{
+    int colon = line.indexOf(':');
+    if(colon < 0)
+        return false;
+
+    int paren = line.indexOf('(');
+    if(paren > 0 && paren < colon && spinRegex.indexIn(line) == 0) {
+        diag.file = spinRegex.cap(1).trimmed();
+        if(diag.file.contains("..."))
+            diag.file = diag.file.mid(diag.file.indexOf("...")+3);
+        diag.line = spinRegex.cap(2).toInt();
+        diag.column = spinRegex.cap(3).toInt();
+        diag.severity = spinRegex.cap(4).compare("error", Qt::CaseInsensitive) == 0 ?
+                    Diagnostic::Error : Diagnostic::Warning;
+        diag.message = spinRegex.cap(5).trimmed();
+        return true;
+    }
+
+    if(!line.contains(": "))
+        return false;
+    if(gccRegex.indexIn(line) != 0)
+        return false;
+
+    diag.file = gccRegex.cap(1);
+    diag.line = gccRegex.cap(2).toInt();
+    diag.column = gccRegex.cap(3).toInt();
+    QString sev = gccRegex.cap(4);
+    if(sev.endsWith("error"))
+        diag.severity = Diagnostic::Error;
+    else if(sev == "warning")
+        diag.severity = Diagnostic::Warning;
+    else
+        diag.severity = Diagnostic::Note;
+    diag.message = gccRegex.cap(5);
+    return true;
+}
+
+DiagnosticModel::DiagnosticModel(QObject *parent) : QAbstractListModel(parent)
+{
+    errors = 0;
+    warnings = 0;
+}
+
+int DiagnosticModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return diagnostics.count();
+}
+
+QVariant DiagnosticModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= diagnostics.count())
+        return QVariant();
+
+    const Diagnostic &diag = diagnostics.at(index.row());
+    if(role == Qt::DisplayRole) {
+        static const char *sev[] = { "note", "warning", "error" };
+        return QString("%1:%2:%3: %4: %5").arg(diag.file).arg(diag.line).arg(diag.column)
+                .arg(sev[diag.severity]).arg(diag.message);
+    }
+    if(role == Qt::ToolTipRole)
+        return diag.message;
+    return QVariant();
+}
+
+void DiagnosticModel::clear()
+{
+#ifdef QT5
+    beginResetModel();
+    diagnostics.clear();
+    errors = 0;
+    warnings = 0;
+    endResetModel();
+#else
+    diagnostics.clear();
+    errors = 0;
+    warnings = 0;
+    reset();
+#endif
+}
+
+void DiagnosticModel::append(const QList<Diagnostic> &list)
+{
+    if(list.isEmpty())
+        return;
+    int first = diagnostics.count();
+    beginInsertRows(QModelIndex(), first, first+list.count()-1);
+    foreach(Diagnostic diag, list) {
+        if(diag.severity == Diagnostic::Error)
+            errors++;
+        else if(diag.severity == Diagnostic::Warning)
+            warnings++;
+        diagnostics.append(diag);
+    }
+    endInsertRows();
+}
+
+int DiagnosticModel::firstError() const
+{
+    for(int n = 0; n < diagnostics.count(); n++) {
+        if(diagnostics.at(n).severity == Diagnostic::Error)
+            return n;
+    }
+    return -1;
+}
+
+/*
+ * Records are appended in output order, so statusLine is sorted.
+ */
+int DiagnosticModel::findStatusLine(int block) const
+{
+    int lo = 0;
+    int hi = diagnostics.count()-1;
+    while(lo <= hi) {
+        int mid = (lo+hi)/2;
+        int n = diagnostics.at(mid).statusLine;
+        if(n == block)
+            return mid;
+        if(n < block)
+            lo = mid+1;
+        else
+            hi = mid-1;
+    }
+    return -1;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "qtversion.h"
+
+/*
+ * One compiler message: gcc "file:line:col: error: text",
+ * openspin "file(line:col) : error : text" or bstc "file(line,col) Error : text".
+ */
+struct Diagnostic {
+    enum Severity { Note, Warning, Error };
+
+    QString  file;
+    int      line;
+    int      column;
+    Severity severity;
+    QString  message;
+    int      statusLine;    // block number in the build status window
+
+    Diagnostic() : line(0), column(0), severity(Note), statusLine(-1) {}
+};
+
+class DiagnosticParser
+{
+public:
+    DiagnosticParser();
+    bool parse(const QString &line, Diagnostic &diag);
+
+private:
+    QRegExp gccRegex;
+    QRegExp spinRegex;
+};
+
+class DiagnosticModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    DiagnosticModel(QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    void clear();
+    void append(const QList<Diagnostic> &list);
+
+    const Diagnostic &at(int row) const { return diagnostics.at(row); }
+    int  errorCount() const { return errors; }
+    int  warningCount() const { return warnings; }
+    int  firstError() const;
+    int  findStatusLine(int block) const;
+
+private:
+    QVector<Diagnostic> diagnostics;
+    int errors;
+    int warnings;
+};
+
+#endif // DIAGNOSTICS_H
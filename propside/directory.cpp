@@ -17,13 +17,33 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "qtversion.h"
 #include "directory.h"
+#include "treecopy.h"
+#include "treeremove.h"
+#include "fileindex.h"
 #include <QApplication>
 
 Directory::Directory()
 {
 }
 
+/*
+ * Path of name in the per-user cache folder shared by the IDE's
+ * caches, ~/.simpleide if the platform has none.
+ */
+QString Directory::cacheLocation(QString name)
+{
+#ifdef QT5
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+#else
+    QString dir = QDesktopServices::storageLocation(QDesktopServices::CacheLocation);
+#endif
+    if(dir.isEmpty())
+        dir = QDir::homePath()+"/.simpleide";
+    return QDir::fromNativeSeparators(dir)+"/"+name;
+}
+
 bool Directory::isInFilterList(QString file, QStringList list)
 {
     if(list.isEmpty())
@@ -50,62 +70,14 @@ bool Directory::isPossibleInfiniteFolder(QString spath, QString dpath)
     return dpath.contains(spath);
 }
 
+/*
+ * notlist is a space separated list of wildcards for names to skip.
+ * See TreeCopy for progress reporting.
+ */
 void Directory::recursiveCopyDir(QString srcdir, QString dstdir, QString notlist)
 {
-    QString file;
-
-    QStringList slist;
-    QStringList flist;
-
-    if(srcdir.length() < 1)
-        return;
-    if(dstdir.length() < 1)
-        return;
-
-    QApplication::processEvents();
-
-    QStringList list;
-    if(notlist.isEmpty() == false)
-        list = notlist.split(" ", QString::SkipEmptyParts);
-
-    if(srcdir.at(srcdir.length()-1) != '/')
-        srcdir += '/';
-    if(dstdir.at(dstdir.length()-1) != '/')
-        dstdir += '/';
-
-    QDir spath(srcdir);
-    QDir dpath(dstdir);
-
-    if(spath.exists() == false)
-        return;
-    if(isPossibleInfiniteFolder(srcdir, dstdir))
-        return;
-    if(dpath.exists() == false)
-        dpath.mkdir(dstdir);
-
-    flist = spath.entryList(QDir::AllEntries, QDir::DirsLast);
-    foreach(file, flist) {
-        if(file.compare(".") == 0)
-            break;
-        if(file.compare("..") == 0)
-            break;
-        QApplication::processEvents();
-        if(isInFilterList(file,list) == false) {
-            if(QFile::exists(dstdir+file)) {
-                QFile::remove(dstdir+file);
-            }
-            QFile::copy(srcdir+file, dstdir+file);
-        }
-    }
-    slist = spath.entryList(QDir::AllDirs, QDir::DirsLast);
-    foreach(file, slist) {
-        if(file.compare(".") == 0)
-            continue;
-        if(file.compare("..") == 0)
-            continue;
-        if(isInFilterList(file,list) == false)
-            recursiveCopyDir(srcdir+file, dstdir+file, notlist);
-    }
+    TreeCopy copier;
+    copier.copy(srcdir, dstdir, notlist);
 }
 
 /*
@@ -179,39 +151,8 @@ void Directory::recursiveRemoveDir(QString dir)
     }
     */
 
-    QDir dpath(dir);
-    QString file;
-
-    QStringList dlist;
-    QStringList flist;
-
-    if(dir.length() < 1)
-        return;
-
-    QApplication::processEvents();
-
-    if(dir.at(dir.length()-1) != '/')
-        dir += '/';
-
-    flist = dpath.entryList(QDir::AllEntries, QDir::DirsLast);
-    foreach(file, flist) {
-        if(file.compare(".") == 0)
-            continue;
-        if(file.compare("..") == 0)
-            continue;
-        QApplication::processEvents();
-        QFile::remove(dir+file);
-    }
-    dlist = dpath.entryList(QDir::AllDirs, QDir::DirsLast);
-    foreach(file, dlist) {
-        if(file.compare(".") == 0)
-            continue;
-        if(file.compare("..") == 0)
-            continue;
-        recursiveRemoveDir(dir+file);
-        dpath.rmdir(dir+file);
-    }
-    dpath.rmdir(dir);
+    TreeRemove remover;
+    remover.remove(dir);
 }
 
 QString Directory::find(QString file, QString find)
@@ -377,6 +318,11 @@ QString Directory::recursiveFindFile(QString dir, QString findfile)
     if(dir.length() < 1)
         return file;
 
+    /* indexed folders are searched in memory */
+    FileIndex *index = FileIndex::instance();
+    if(index->covers(dir))
+        return index->findFile(dir, findfile);
+
     QChar sep = dir.at(dir.length()-1);
     if(sep != '/' && sep != '\\')
         dir += "/";
@@ -417,6 +363,10 @@ int Directory::recursiveFindFileList(QString dir, QString findfile, QStringList
     if(dir.length() < 1)
         return 0;
 
+    FileIndex *index = FileIndex::instance();
+    if(index->covers(dir))
+        return index->findFiles(dir, findfile, filelist);
+
     QChar sep = dir.at(dir.length()-1);
     if(sep != '/' && sep != '\\')
         dir += "/";
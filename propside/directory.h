@@ -37,6 +37,7 @@ public:
     static QString recursiveFind(QString dir, QString find);
     static QString recursiveFindFile(QString dir, QString file);
     static int recursiveFindFileList(QString dir, QString findfile, QStringList &filelist);
+    static QString cacheLocation(QString name);
 
 private:
     static bool isCSourceCommented(QString find, QString line, int num, QStringList lines);
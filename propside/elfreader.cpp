@@ -0,0 +1,209 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "elfreader.h"
+
+#define ELF_HEADER_SIZE     52
+#define ELF_SECTION_SIZE    40
+#define ELF_SYMBOL_SIZE     16
+
+ElfReader::ElfReader()
+{
+    bigEndian = false;
+}
+
+quint16 ElfReader::get16(const char *p) const
+{
+    const uchar *u = (const uchar *)p;
+    if(bigEndian)
+        return qFromBigEndian<quint16>(u);
+    return qFromLittleEndian<quint16>(u);
+}
+
+quint32 ElfReader::get32(const char *p) const
+{
+    const uchar *u = (const uchar *)p;
+    if(bigEndian)
+        return qFromBigEndian<quint32>(u);
+    return qFromLittleEndian<quint32>(u);
+}
+
+QByteArray ElfReader::readAt(quint32 offset, quint32 size)
+{
+    if(!file.seek(offset))
+        return QByteArray();
+    QByteArray bytes = file.read(size);
+    if((quint32)bytes.size() != size)
+        return QByteArray();
+    return bytes;
+}
+
+bool ElfReader::open(const QString &fileName)
+{
+    sectionList.clear();
+    if(file.isOpen())
+        file.close();
+
+    file.setFileName(fileName);
+    if(!file.open(QFile::ReadOnly)) {
+        error = QString("Can't open %1").arg(fileName);
+        return false;
+    }
+
+    QByteArray hdr = file.read(ELF_HEADER_SIZE);
+    if(hdr.size() != ELF_HEADER_SIZE || !hdr.startsWith("\177ELF") || hdr.at(4) != 1) {
+        error = QString("%1 is not an ELF32 file").arg(fileName);
+        return false;
+    }
+    bigEndian = (hdr.at(5) == 2);
+
+    const char *h = hdr.constData();
+    quint32 shoff = get32(h+32);
+    quint16 shentsize = get16(h+46);
+    quint16 shnum = get16(h+48);
+    quint16 shstrndx = get16(h+50);
+
+    if(shoff == 0 || shnum == 0 || shentsize < ELF_SECTION_SIZE || shstrndx >= shnum) {
+        error = QString("%1 has no section headers").arg(fileName);
+        return false;
+    }
+
+    QByteArray shdrs = readAt(shoff, (quint32)shnum*shentsize);
+    if(shdrs.isEmpty()) {
+        error = QString("%1 is truncated").arg(fileName);
+        return false;
+    }
+
+    QVector<quint32> nameOffsets(shnum);
+    for(int n = 0; n < shnum; n++) {
+        const char *s = shdrs.constData()+n*shentsize;
+        ElfSection sec;
+        nameOffsets[n] = get32(s);
+        sec.type = get32(s+4);
+        sec.flags = get32(s+8);
+        sec.addr = get32(s+12);
+        sec.offset = get32(s+16);
+        sec.size = get32(s+20);
+        sec.link = get32(s+24);
+        sectionList.append(sec);
+    }
+
+    const ElfSection &strsec = sectionList.at(shstrndx);
+    QByteArray names = readAt(strsec.offset, strsec.size);
+    for(int n = 0; n < sectionList.count(); n++) {
+        quint32 pos = nameOffsets[n];
+        if(pos < (quint32)names.size())
+            sectionList[n].name = QString::fromLatin1(names.constData()+pos);
+    }
+    return true;
+}
+
+quint32 ElfReader::textSize() const
+{
+    quint32 size = 0;
+    foreach(ElfSection sec, sectionList) {
+        if((sec.flags & SHF_ALLOC) && (sec.flags & SHF_EXECINSTR) && sec.type != SHT_NOBITS)
+            size += sec.size;
+    }
+    return size;
+}
+
+quint32 ElfReader::dataSize() const
+{
+    quint32 size = 0;
+    foreach(ElfSection sec, sectionList) {
+        if((sec.flags & SHF_ALLOC) && !(sec.flags & SHF_EXECINSTR) && sec.type != SHT_NOBITS)
+            size += sec.size;
+    }
+    return size;
+}
+
+quint32 ElfReader::bssSize() const
+{
+    quint32 size = 0;
+    foreach(ElfSection sec, sectionList) {
+        if((sec.flags & SHF_ALLOC) && sec.type == SHT_NOBITS)
+            size += sec.size;
+    }
+    return size;
+}
+
+/*
+ * Same totals the objdump -h parser produced: loaded sections count
+ * toward code and memory, .bss toward memory, and the heap ends the list.
+ */
+void ElfReader::programSizes(int &codeSize, int &memorySize) const
+{
+    codeSize = 0;
+    memorySize = 0;
+    foreach(ElfSection sec, sectionList) {
+        if(!(sec.flags & SHF_ALLOC))
+            continue;
+        if(sec.name.contains(".bss", Qt::CaseInsensitive)) {
+            memorySize += sec.size;
+        }
+        else if(sec.name.contains("heap", Qt::CaseInsensitive)) {
+            break;
+        }
+        else if(sec.type != SHT_NOBITS) {
+            codeSize += sec.size;
+            memorySize += sec.size;
+        }
+    }
+}
+
+static bool symbolSizeGreater(const ElfSymbol &a, const ElfSymbol &b)
+{
+    return a.size > b.size;
+}
+
+/*
+ * Sized symbols from .symtab, largest first.
+ */
+QList<ElfSymbol> ElfReader::symbols(int maxCount)
+{
+    QList<ElfSymbol> list;
+
+    foreach(ElfSection sec, sectionList) {
+        if(sec.type != SHT_SYMTAB || (int)sec.link >= sectionList.count())
+            continue;
+        QByteArray syms = readAt(sec.offset, sec.size);
+        const ElfSection &strsec = sectionList.at(sec.link);
+        QByteArray names = readAt(strsec.offset, strsec.size);
+
+        int count = syms.size()/ELF_SYMBOL_SIZE;
+        for(int n = 1; n < count; n++) {
+            const char *s = syms.constData()+n*ELF_SYMBOL_SIZE;
+            ElfSymbol sym;
+            sym.size = get32(s+8);
+            if(sym.size == 0)
+                continue;
+            quint32 pos = get32(s);
+            sym.name = pos < (quint32)names.size() ? QString::fromLatin1(names.constData()+pos) : QString();
+            sym.value = get32(s+4);
+            sym.section = get16(s+14);
+            list.append(sym);
+        }
+    }
+
+    qStableSort(list.begin(), list.end(), symbolSizeGreater);
+    if(maxCount > -1 && list.count() > maxCount)
+        list = list.mid(0, maxCount);
+    return list;
+}
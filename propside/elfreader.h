@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ELFREADER_H
+#define ELFREADER_H
+
+#include <QtCore>
+
+struct ElfSection {
+    QString name;
+    quint32 type;
+    quint32 flags;
+    quint32 addr;
+    quint32 offset;
+    quint32 size;
+    quint32 link;
+};
+
+struct ElfSymbol {
+    QString name;
+    quint32 value;
+    quint32 size;
+    quint16 section;
+};
+
+/*
+ * Minimal ELF32 reader for program size reporting.
+ * Only the section headers are read on open; symbols are read on demand.
+ */
+class ElfReader
+{
+public:
+    enum { SHT_SYMTAB = 2, SHT_NOBITS = 8 };
+    enum { SHF_WRITE = 1, SHF_ALLOC = 2, SHF_EXECINSTR = 4 };
+
+    ElfReader();
+
+    bool open(const QString &fileName);
+    QString errorString() const { return error; }
+
+    const QList<ElfSection> &sections() const { return sectionList; }
+
+    quint32 textSize() const;
+    quint32 dataSize() const;
+    quint32 bssSize() const;
+    void programSizes(int &codeSize, int &memorySize) const;
+
+    QList<ElfSymbol> symbols(int maxCount = -1);
+
+private:
+    quint16 get16(const char *p) const;
+    quint32 get32(const char *p) const;
+    QByteArray readAt(quint32 offset, quint32 size);
+
+    QFile   file;
+    bool    bigEndian;
+    QString error;
+    QList<ElfSection> sectionList;
+};
+
+#endif // ELFREADER_H
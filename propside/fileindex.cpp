@@ -0,0 +1,362 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fileindex.h"
+
+/*
+ * Every indexed folder holds a watch (an inotify watch on Linux, a
+ * handle on Windows), so larger trees are left to the disk lookups.
+ */
+#define FILEINDEX_MAX_FOLDERS 4000
+
+/*
+ * Walks one root or new sub-tree off the GUI thread.
+ */
+class FileIndexScan : public QRunnable
+{
+public:
+    FileIndexScan(FileIndex *index, const QString &root, bool recursive = true)
+        : index(index), root(root), recursive(recursive) { }
+    void run() {
+        FileIndex::FolderHash tree;
+        bool complete = true;
+        if(recursive)
+            complete = FileIndex::scanTree(root, tree);
+        else
+            tree.insert(root, FileIndex::readFolder(root));
+        index->scanned(root, tree, complete);
+    }
+private:
+    FileIndex *index;
+    QString    root;
+    bool       recursive;
+};
+
+FileIndex *FileIndex::instance()
+{
+    static QMutex createMutex;
+    static QPointer<FileIndex> index;
+    QMutexLocker lock(&createMutex);
+    if(!index) {
+        index = new FileIndex(QCoreApplication::instance());
+        if(QCoreApplication::instance())
+            index->moveToThread(QCoreApplication::instance()->thread());
+    }
+    return index;
+}
+
+FileIndex::FileIndex(QObject *parent) : QObject(parent), watcher(this)
+{
+    scanPool.setMaxThreadCount(2);
+    connect(&watcher, SIGNAL(directoryChanged(QString)), this, SLOT(folderChanged(QString)));
+}
+
+QString FileIndex::key(const QString &dir)
+{
+    QString k = QDir::cleanPath(QDir::fromNativeSeparators(dir));
+    if(!k.endsWith("/"))
+        k += "/";
+    return k;
+}
+
+QString FileIndex::watchPath(const QString &key)
+{
+    return key.length() > 1 ? key.left(key.length()-1) : key;
+}
+
+/*
+ * Same listing Directory used for its lookups, folders sorted last.
+ */
+FileIndex::Folder FileIndex::readFolder(const QString &dir)
+{
+    Folder folder;
+    QDir d(dir);
+    QFileInfoList list = d.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::DirsLast);
+    foreach(QFileInfo info, list) {
+        folder.entries.append(info.fileName());
+        if(info.isDir())
+            folder.folders.append(info.fileName());
+    }
+    return folder;
+}
+
+/*
+ * Read every folder under root. Returns false if the tree is too big.
+ */
+bool FileIndex::scanTree(const QString &root, FolderHash &tree)
+{
+    QSet<QString> visited;
+    QStringList stack;
+    stack.append(root);
+    while(stack.count() > 0) {
+        QString dir = stack.takeLast();
+        QString canonical = QFileInfo(dir).canonicalFilePath();
+        if(visited.contains(canonical))
+            continue;
+        visited.insert(canonical);
+
+        Folder folder = readFolder(dir);
+        tree.insert(dir, folder);
+        if(tree.count() > FILEINDEX_MAX_FOLDERS)
+            return false;
+        foreach(QString sub, folder.folders)
+            stack.append(dir+sub+"/");
+    }
+    return true;
+}
+
+void FileIndex::addRoot(const QString &dir, bool recursive)
+{
+    if(dir.isEmpty() || !QFileInfo(dir).isDir())
+        return;
+    QString root = key(dir);
+    {
+        QMutexLocker lock(&mutex);
+        if(!rootOf(root).isEmpty())
+            return;
+        if(recursive) {
+            roots.append(root);
+            shallowRoots.removeAll(root);
+        }
+        else {
+            if(shallowRoots.contains(root))
+                return;
+            shallowRoots.append(root);
+        }
+    }
+    scanPool.start(new FileIndexScan(this, root, recursive));
+}
+
+/*
+ * Caller holds the mutex. The recursive root dir is under, if any.
+ */
+QString FileIndex::rootOf(const QString &dir) const
+{
+    foreach(QString r, roots) {
+        if(dir.startsWith(r))
+            return r;
+    }
+    return QString();
+}
+
+/*
+ * Caller holds the mutex. Forget a root that grew past the limit.
+ */
+void FileIndex::dropRoot(const QString &root)
+{
+    qDebug() << "FileIndex: too many folders, not indexing" << root;
+    roots.removeAll(root);
+    dropFolder(root);
+    for(int n = pending.count()-1; n > -1; n--) {
+        if(pending.at(n).startsWith(root))
+            pending.removeAt(n);
+    }
+}
+
+void FileIndex::scanned(const QString &root, const FolderHash &tree, bool complete)
+{
+    Scan scan;
+    scan.root = root;
+    scan.folders = tree;
+    scan.complete = complete;
+    {
+        QMutexLocker lock(&mutex);
+        scans.append(scan);
+    }
+    QMetaObject::invokeMethod(this, "mergeScans", Qt::QueuedConnection);
+}
+
+/*
+ * Publish finished scans and start watching their folders.
+ */
+void FileIndex::mergeScans()
+{
+    QStringList paths;
+    QStringList done;
+    {
+        QMutexLocker lock(&mutex);
+        foreach(Scan scan, scans) {
+            QString root = rootOf(scan.root);
+            bool subtree = pending.removeAll(scan.root) > 0;
+            if(subtree) {
+                /* root or parent was dropped while this was scanned */
+                QString parent = scan.root.left(scan.root.lastIndexOf("/", -2)+1);
+                if(root.isEmpty() || !folders.contains(parent))
+                    continue;
+            }
+            if(!subtree && root.isEmpty() && !shallowRoots.contains(scan.root))
+                continue;
+            if(!scan.complete || folders.count()+scan.folders.count() > FILEINDEX_MAX_FOLDERS) {
+                if(!root.isEmpty())
+                    dropRoot(root);
+                else
+                    shallowRoots.removeAll(scan.root);
+                continue;
+            }
+            FolderHash::const_iterator it;
+            for(it = scan.folders.constBegin(); it != scan.folders.constEnd(); ++it) {
+                folders.insert(it.key(), it.value());
+                paths.append(watchPath(it.key()));
+            }
+            done.append(scan.root);
+        }
+        scans.clear();
+    }
+    if(paths.count() > 0)
+        watcher.addPaths(paths);
+    foreach(QString root, done)
+        emit changed(root);
+}
+
+/*
+ * Re-read one folder after the watcher reports a change.
+ * Removed sub-folders are dropped. New ones under a recursive root are
+ * scanned on the pool and watched when the scan is merged.
+ */
+void FileIndex::folderChanged(const QString &path)
+{
+    QString dir = key(path);
+    QStringList added;
+    {
+        QMutexLocker lock(&mutex);
+        if(!folders.contains(dir))
+            return;
+        if(!QFileInfo(dir).isDir()) {
+            dropFolder(dir);
+        }
+        else {
+            Folder folder = readFolder(dir);
+            Folder old = folders.value(dir);
+            folders.insert(dir, folder);
+            foreach(QString sub, old.folders) {
+                if(!folder.folders.contains(sub))
+                    dropFolder(dir+sub+"/");
+            }
+            if(!rootOf(dir).isEmpty()) {
+                foreach(QString sub, folder.folders) {
+                    QString subdir = dir+sub+"/";
+                    if(old.folders.contains(sub) || pending.contains(subdir))
+                        continue;
+                    pending.append(subdir);
+                    added.append(subdir);
+                }
+            }
+        }
+    }
+    foreach(QString subdir, added)
+        scanPool.start(new FileIndexScan(this, subdir));
+    emit changed(dir);
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void FileIndex::dropFolder(const QString &dir)
+{
+    foreach(QString k, folders.keys()) {
+        if(k.startsWith(dir)) {
+            folders.remove(k);
+            watcher.removePath(watchPath(k));
+        }
+    }
+}
+
+/*
+ * True if every folder under dir is indexed, so a recursive lookup
+ * can be answered from memory.
+ */
+bool FileIndex::covers(const QString &dir)
+{
+    QString k = key(dir);
+    QMutexLocker lock(&mutex);
+    if(!folders.contains(k) || rootOf(k).isEmpty())
+        return false;
+    foreach(QString p, pending) {
+        if(p.startsWith(k))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Names in dir, or false if dir isn't indexed.
+ */
+bool FileIndex::entries(const QString &dir, QStringList &list)
+{
+    QMutexLocker lock(&mutex);
+    FolderHash::const_iterator it = folders.constFind(key(dir));
+    if(it == folders.constEnd())
+        return false;
+    list = it.value().entries;
+    return true;
+}
+
+/*
+ * Same search order as Directory::recursiveFindFile:
+ * the folder's own entries first, then each sub-folder in turn.
+ */
+QString FileIndex::findFile(const QString &dir, const QString &name)
+{
+    QMutexLocker lock(&mutex);
+    QString found;
+    findFileIn(key(dir), name, found);
+    return found;
+}
+
+void FileIndex::findFileIn(const QString &dir, const QString &name, QString &found)
+{
+    FolderHash::const_iterator it = folders.constFind(dir);
+    if(it == folders.constEnd())
+        return;
+    foreach(QString entry, it.value().entries) {
+        if(entry.compare(name) == 0) {
+            found = dir+entry;
+            return;
+        }
+    }
+    foreach(QString sub, it.value().folders) {
+        findFileIn(dir+sub+"/", name, found);
+        if(!found.isEmpty())
+            return;
+    }
+}
+
+/*
+ * Case-insensitive wildcard search like Directory::recursiveFindFileList.
+ */
+int FileIndex::findFiles(const QString &dir, const QString &pattern, QStringList &list)
+{
+    QMutexLocker lock(&mutex);
+    QRegExp regex(pattern, Qt::CaseInsensitive, QRegExp::Wildcard);
+    findFilesIn(key(dir), regex, list);
+    return list.length();
+}
+
+void FileIndex::findFilesIn(const QString &dir, const QRegExp &regex, QStringList &list)
+{
+    FolderHash::const_iterator it = folders.constFind(dir);
+    if(it == folders.constEnd())
+        return;
+    foreach(QString entry, it.value().entries) {
+        if(entry.indexOf(regex) > -1)
+            list.append(dir+entry);
+    }
+    foreach(QString sub, it.value().folders)
+        findFilesIn(dir+sub+"/", regex, list);
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILEINDEX_H
+#define FILEINDEX_H
+
+#include <QtCore>
+
+/*
+ * In-memory index of the workspace, library and project folders.
+ * Roots are scanned on a background thread and then kept current with
+ * QFileSystemWatcher (inotify on Linux), one watch per folder. Lookups
+ * under a root that is not indexed yet, or that has more folders than
+ * the index will watch, return false or empty so callers can fall back
+ * to reading the disk. A shallow root indexes only its own folder.
+ */
+class FileIndex : public QObject
+{
+    Q_OBJECT
+public:
+    static FileIndex *instance();
+
+    void    addRoot(const QString &dir, bool recursive = true);
+    bool    covers(const QString &dir);
+
+    bool    entries(const QString &dir, QStringList &list);
+    QString findFile(const QString &dir, const QString &name);
+    int     findFiles(const QString &dir, const QString &pattern, QStringList &list);
+
+    struct Folder {
+        QStringList entries;    // files and folders, folders last
+        QStringList folders;
+    };
+    typedef QHash<QString,Folder> FolderHash;
+
+    static QString key(const QString &dir);
+    static Folder  readFolder(const QString &dir);
+    static bool    scanTree(const QString &root, FolderHash &tree);
+
+signals:
+    void changed(const QString &dir);
+
+private slots:
+    void mergeScans();
+    void folderChanged(const QString &path);
+
+private:
+    explicit FileIndex(QObject *parent);
+
+    friend class FileIndexScan;
+
+    void    scanned(const QString &root, const FolderHash &folders, bool complete);
+    QString rootOf(const QString &dir) const;
+    void    dropRoot(const QString &root);
+    void    findFileIn(const QString &dir, const QString &name, QString &found);
+    void    findFilesIn(const QString &dir, const QRegExp &regex, QStringList &list);
+    void    dropFolder(const QString &dir);
+    static QString watchPath(const QString &key);
+
+    struct Scan {
+        QString    root;
+        FolderHash folders;
+        bool       complete;
+    };
+
+    QMutex              mutex;
+    QStringList         roots;
+    QStringList         shallowRoots;
+    QStringList         pending;    // new sub-trees being scanned
+    FolderHash          folders;
+    QList<Scan>         scans;
+    QFileSystemWatcher  watcher;
+    QThreadPool         scanPool;
+};
+
+#endif // FILEINDEX_H
@@ -110,11 +110,11 @@ Hardware::~Hardware()
  */
 void Hardware::loadBoards()
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant sv = settings.value(configFileKey);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant sv = settings->value(configFileKey);
     if(sv.canConvert(QVariant::String))
         aSideCfgFile = sv.toString();
-    sv = settings.value(separatorKey);
+    sv = settings->value(separatorKey);
     if(sv.canConvert(QVariant::String))
         aSideSeparator = sv.toString();
     if(aSideConfig->loadBoards(aSideCfgFile) == 0)
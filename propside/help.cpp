@@ -18,6 +18,8 @@
  */
 
 #include "help.h"
+#include "helpindex.h"
+#include "helpsearch.h"
 #include "properties.h"
 
 Help::Help() : hisIndex(-1)
@@ -26,6 +28,20 @@ Help::Help() : hisIndex(-1)
     bedit = new QTextBrowser();
     //bedit->setOpenLinks(false);
 
+    /* full-text search over the library docs and Spin sources */
+    helpSearch = new HelpSearch(this);
+    connect(helpSearch,SIGNAL(indexChanged()),this,SLOT(searchIndexChanged()));
+
+    leHelpSearch = new QLineEdit();
+    leHelpSearch->setPlaceholderText(tr("Search Help"));
+    connect(leHelpSearch,SIGNAL(textChanged(QString)),this,SLOT(helpSearchChanged(QString)));
+    lwResults = new QListWidget();
+    lwResults->setMaximumHeight(150);
+    lwResults->hide();
+    connect(lwResults,SIGNAL(itemActivated(QListWidgetItem*)),this,SLOT(searchResultActivated(QListWidgetItem*)));
+
+    blay->addWidget(leHelpSearch);
+    blay->addWidget(lwResults);
     blay->addWidget(bedit);
     blay->setContentsMargins(1,1,1,1);
 
@@ -42,13 +58,7 @@ Help::Help() : hisIndex(-1)
 
     connect(cbHelpMode,SIGNAL(currentIndexChanged(int)),this,SLOT(helpModeChanged(int)));
 
-    leHelpSearch = new QLineEdit(btool);
-    leHelpSearch->setPlaceholderText("Search Item");
-    leHelpSearch->setMaximumWidth(120);
-    leHelpSearch->setEnabled(false);
-    connect(leHelpSearch,SIGNAL(textChanged(QString)),this,SLOT(helpSearchChanged(QString)));
     btool->addWidget(cbHelpMode);
-    btool->addWidget(leHelpSearch);
 
     btnBack = new QToolButton(btool);
     btnFwd  = new QToolButton(btool);
@@ -150,16 +160,62 @@ void Help::helpModeChanged(int n)
 {
 #ifdef ADD_HELP_INDEX_WIP
     if(n > 0) {
-        leHelpSearch->setEnabled(true);
-    } else {
-        leHelpSearch->setEnabled(false);
+        leHelpSearch->setFocus();
     }
 #endif
 }
 
+void Help::setSearchFolders(QString learnPath, QString spinPath)
+{
+    helpSearch->addFolder(learnPath+"Simple Libraries", "*.html");
+    helpSearch->addFolder(spinPath, "*.spin");
+}
+
+void Help::showSearch()
+{
+    setWindowTitle(tr("Search Help"));
+    setModal(false);
+    open();
+    leHelpSearch->setFocus();
+    leHelpSearch->selectAll();
+}
+
+/*
+ * Runs on every keystroke; the index answers from memory.
+ */
 void Help::helpSearchChanged(QString text)
 {
-    if(text.length() > 0) {
+    lwResults->clear();
+    QList<HelpSearch::Hit> hits = helpSearch->query(text);
+    foreach(HelpSearch::Hit hit, hits) {
+        QListWidgetItem *item = new QListWidgetItem(hit.title, lwResults);
+        item->setToolTip(hit.path);
+        item->setData(Qt::UserRole, hit.path);
+        item->setData(Qt::UserRole+1, hit.offset);
+    }
+    lwResults->setVisible(hits.count() > 0);
+}
+
+void Help::searchIndexChanged()
+{
+    if(leHelpSearch->text().length() > 0)
+        helpSearchChanged(leHelpSearch->text());
+}
+
+void Help::searchResultActivated(QListWidgetItem *item)
+{
+    QString path = item->data(Qt::UserRole).toString();
+    int offset = item->data(Qt::UserRole+1).toInt();
+    if(path.endsWith(".spin", Qt::CaseInsensitive)) {
+        emit openSource(path, HelpSearch::lineAt(path, offset));
+    }
+    else {
+        /* show the documented member that holds the hit */
+        QString anchor = HelpIndex::instance()->anchorAt(path, offset);
+        if(anchor.length() > 0)
+            openAddress("file:///"+path+"#"+anchor);
+        else
+            openAddress("file:///"+path);
     }
 }
 
@@ -222,56 +278,24 @@ void Help::openAddress(QString address)
             libname = libname.left(libname.indexOf("_"));
             home = "<h3><a href=\""+homeAddress+"\">Propeller C Simple Library</a> \""+libname+".h\" Symbol:</h3>";
             QString text;
-            /* replace memdoc class with something else*/
-            QRegExp rex("<a class=\"anchor\" id=\""+frag+"\"></a>\n.*<a class=\"anchor");
-            rex.setCaseSensitivity(Qt::CaseInsensitive);
-            rex.setMinimal(true);
-
-            QRegExp rex2("<a class=\"anchor\" id=\""+frag+"\"></a>\n.*</div><!-- contents -->");
-            rex2.setCaseSensitivity(Qt::CaseInsensitive);
-            rex2.setMinimal(true);
-
-            QFile file(fileName);
-            if(file.open(QFile::ReadOnly)) {
-                text = file.readAll();
-                file.close();
-                int pos = 0;
-                bool found = false;
-                while((pos = rex.indexIn(text,pos)) > -1) {
-                    QString s = rex.cap();
-                    s = s.left(s.lastIndexOf("<a class=\"anchor"));
-                    if(s.contains(frag)) {
-                        qDebug() << "cap" << rex.captureCount() << s;
-                        QFile cssFile(":/images/helpfunction.css");
-                        if(cssFile.open(QFile::ReadOnly)) {
-                            css = cssFile.readAll();
-                            cssFile.close();
-                            css = "<head><style>"+css+"></style></head>";
-                        }
-                        text = "<html>"+css+"<body>"+home+""+s+"<p class=\"memdoc\">Parallax Propeller C Learning System</p></body></html>";
-                        found = true;
-                        break;
-                    }
-                    pos += rex.matchedLength();
+
+            /* the anchor index gives the symbol's block without scanning the page */
+            QString s = HelpIndex::instance()->snippet(fileName, frag);
+            if(s.length() > 0) {
+                QFile cssFile(":/images/helpfunction.css");
+                if(cssFile.open(QFile::ReadOnly)) {
+                    css = cssFile.readAll();
+                    cssFile.close();
+                    css = "<head><style>"+css+"></style></head>";
                 }
-                if(!found) {
-                    int pos = 0;
-                    while((pos = rex2.indexIn(text,pos)) > -1) {
-                        QString s = rex2.cap();
-                        s = s.left(s.lastIndexOf("</div><!-- contents -->"));
-                        if(s.contains(frag)) {
-                            qDebug() << "cap" << rex2.captureCount() << s;
-                            QFile cssFile(":/images/helpfunction.css");
-                            if(cssFile.open(QFile::ReadOnly)) {
-                                css = cssFile.readAll();
-                                cssFile.close();
-                                css = "<head><style>"+css+"></style></head>";
-                            }
-                            text = "<html>"+css+"<body>"+home+""+s+"<p class=\"memdoc\">Parallax Propeller C Learning System</p></body></html>";
-                            break;
-                        }
-                        pos += rex2.matchedLength();
-                    }
+                text = "<html>"+css+"<body>"+home+""+s+"<p class=\"memdoc\">Parallax Propeller C Learning System</p></body></html>";
+            }
+            else {
+                /* symbol not documented on this page; show the page */
+                QFile file(fileName);
+                if(file.open(QFile::ReadOnly)) {
+                    text = file.readAll();
+                    file.close();
                 }
             }
 
@@ -298,6 +322,9 @@ void Help::show(QString path, QString text)
 {
     QString address = path+"Simple Libraries Index.html";
     homeAddress = "file:///"+address;
+
+    /* index the rest of the library docs while the user reads this one */
+    HelpIndex::instance()->prebuild(path+"Simple Libraries");
     if(text.isEmpty()) {
         //QDesktopServices::openUrl(QUrl(address));
         openAddress("file:///"+address);
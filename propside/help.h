@@ -28,6 +28,9 @@
 #include <QToolButton>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QListWidget>
+
+#include "helpsearch.h"
 
 class Help : public QDialog
 {
@@ -37,6 +40,8 @@ public:
     Help();
     ~Help();
     void show(QString path, QString text);
+    void showSearch();
+    void setSearchFolders(QString learnPath, QString spinPath);
 
 private:
     void addToolButton(QToolBar *bar, QToolButton *btn, QString imgfile, const char *signal = 0, const char *slot = 0);
@@ -52,6 +57,8 @@ private:
     QToolButton *btnFwd;
     QComboBox   *cbHelpMode;
     QLineEdit   *leHelpSearch;
+    QListWidget *lwResults;
+    HelpSearch  *helpSearch;
 
     QString     homeAddress;
 
@@ -65,6 +72,11 @@ public slots:
     void helpModeChanged(int n);
     void helpSearchChanged(QString text);
     void editChanged(QUrl url);
+    void searchIndexChanged();
+    void searchResultActivated(QListWidgetItem *item);
+
+signals:
+    void openSource(QString fileName, int line);
 };
 
 #endif // HELP_H
@@ -0,0 +1,259 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qtversion.h"
+#include "helpindex.h"
+#include "directory.h"
+
+#define HELPINDEX_MAGIC "SimpleIDE help anchors 1"
+
+/*
+ * Indexes every HTML page under a folder off the GUI thread.
+ */
+class HelpIndexBuild : public QRunnable
+{
+public:
+    HelpIndexBuild(HelpIndex *index, const QString &folder) : index(index), folder(folder) { }
+    void run() {
+        QStringList files;
+        Directory::recursiveFindFileList(folder, "*.html", files);
+        foreach(QString file, files)
+            index->indexFile(file);
+        QMutexLocker lock(&index->mutex);
+        index->saveCache();
+    }
+private:
+    HelpIndex *index;
+    QString    folder;
+};
+
+HelpIndex *HelpIndex::instance()
+{
+    static QMutex createMutex;
+    static HelpIndex *index = NULL;
+    QMutexLocker lock(&createMutex);
+    if(!index)
+        index = new HelpIndex();
+    return index;
+}
+
+HelpIndex::HelpIndex()
+{
+    buildPool.setMaxThreadCount(1);
+    cacheLoaded = false;
+    cacheDirty = false;
+}
+
+/*
+ * Doxygen writes each member as <a class="anchor" id="..."></a> followed
+ * by its documentation. A member runs to the next anchor or, for the
+ * last one, to the end of the contents block.
+ */
+HelpIndex::AnchorHash HelpIndex::scanAnchors(const QByteArray &html)
+{
+    static const QByteArray anchorTag("<a class=\"anchor\" id=\"");
+    static const QByteArray anchorEnd("\"></a>\n");
+    static const QByteArray nextAnchor("<a class=\"anchor");
+    static const QByteArray contentsEnd("</div><!-- contents -->");
+
+    AnchorHash anchors;
+    QByteArray lower = html.toLower();
+    int pos = lower.indexOf(anchorTag);
+    while(pos > -1) {
+        int idStart = pos+anchorTag.length();
+        int quote = lower.indexOf('"', idStart);
+        if(quote < 0)
+            break;
+        if(lower.mid(quote, anchorEnd.length()) == anchorEnd) {
+            int body = quote+anchorEnd.length();
+            int end = lower.indexOf(nextAnchor, body);
+            if(end < 0)
+                end = lower.indexOf(contentsEnd, body);
+            QString id = QString(lower.mid(idStart, quote-idStart));
+            if(end > -1 && !anchors.contains(id)) {
+                Range range;
+                range.start = pos;
+                range.length = end-pos;
+                anchors.insert(id, range);
+            }
+        }
+        pos = lower.indexOf(anchorTag, idStart);
+    }
+    return anchors;
+}
+
+/*
+ * Scan fileName if it is new or changed. Returns false if it can't be read.
+ */
+bool HelpIndex::indexFile(const QString &fileName)
+{
+    QFileInfo info(fileName);
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    {
+        QMutexLocker lock(&mutex);
+        loadCache();
+        QHash<QString,Doc>::const_iterator it = docs.constFind(fileName);
+        if(it != docs.constEnd() && it.value().modified == modified && it.value().size == info.size())
+            return true;
+    }
+
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly))
+        return false;
+    Doc doc;
+    doc.modified = modified;
+    doc.size = info.size();
+    doc.anchors = scanAnchors(file.readAll());
+    file.close();
+
+    QMutexLocker lock(&mutex);
+    docs.insert(fileName, doc);
+    cacheDirty = true;
+    return true;
+}
+
+bool HelpIndex::anchorRange(const QString &fileName, const QString &anchor, Range *range)
+{
+    if(!indexFile(fileName))
+        return false;
+    QMutexLocker lock(&mutex);
+    const AnchorHash &anchors = docs[fileName].anchors;
+    AnchorHash::const_iterator it = anchors.constFind(anchor.toLower());
+    if(it == anchors.constEnd())
+        return false;
+    *range = it.value();
+    return true;
+}
+
+/*
+ * The documentation block for anchor, read straight from its byte range.
+ */
+QString HelpIndex::snippet(const QString &fileName, const QString &anchor)
+{
+    Range range;
+    if(!anchorRange(fileName, anchor, &range))
+        return QString();
+
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly) || !file.seek(range.start))
+        return QString();
+    QByteArray bytes = file.read(range.length);
+    file.close();
+
+    QMutexLocker lock(&mutex);
+    saveCache();
+    return QString(bytes);
+}
+
+/*
+ * The member whose documentation block holds byte offset, if any.
+ */
+QString HelpIndex::anchorAt(const QString &fileName, qint64 offset)
+{
+    if(!indexFile(fileName))
+        return QString();
+    QMutexLocker lock(&mutex);
+    const AnchorHash &anchors = docs[fileName].anchors;
+    AnchorHash::const_iterator it;
+    for(it = anchors.constBegin(); it != anchors.constEnd(); ++it) {
+        if(offset >= it.value().start && offset < it.value().start+it.value().length)
+            return it.key();
+    }
+    return QString();
+}
+
+void HelpIndex::prebuild(const QString &folder)
+{
+    {
+        QMutexLocker lock(&mutex);
+        if(prebuilt.contains(folder))
+            return;
+        prebuilt.insert(folder);
+    }
+    buildPool.start(new HelpIndexBuild(this, folder));
+}
+
+QString HelpIndex::cacheFile()
+{
+    return Directory::cacheLocation("helpanchors.cache");
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void HelpIndex::loadCache()
+{
+    if(cacheLoaded)
+        return;
+    cacheLoaded = true;
+
+    QFile file(cacheFile());
+    if(!file.open(QFile::ReadOnly))
+        return;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+    QString magic;
+    qint32 count = 0;
+    in >> magic >> count;
+    if(magic != HELPINDEX_MAGIC)
+        return;
+    for(int n = 0; n < count && in.status() == QDataStream::Ok; n++) {
+        QString path;
+        Doc doc;
+        qint32 anchors = 0;
+        in >> path >> doc.modified >> doc.size >> anchors;
+        for(int a = 0; a < anchors && in.status() == QDataStream::Ok; a++) {
+            QString id;
+            Range range;
+            in >> id >> range.start >> range.length;
+            doc.anchors.insert(id, range);
+        }
+        if(in.status() == QDataStream::Ok)
+            docs.insert(path, doc);
+    }
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void HelpIndex::saveCache()
+{
+    if(!cacheDirty)
+        return;
+    cacheDirty = false;
+
+    QString name = cacheFile();
+    QDir().mkpath(QFileInfo(name).path());
+    QFile file(name+".tmp");
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out << QString(HELPINDEX_MAGIC) << (qint32) docs.count();
+    QHash<QString,Doc>::const_iterator it;
+    for(it = docs.constBegin(); it != docs.constEnd(); ++it) {
+        out << it.key() << it.value().modified << it.value().size << (qint32) it.value().anchors.count();
+        AnchorHash::const_iterator a;
+        for(a = it.value().anchors.constBegin(); a != it.value().anchors.constEnd(); ++a)
+            out << a.key() << a.value().start << a.value().length;
+    }
+    file.close();
+    QFile::remove(name);
+    QFile::rename(name+".tmp", name);
+}
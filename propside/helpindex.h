@@ -0,0 +1,72 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HELPINDEX_H
+#define HELPINDEX_H
+
+#include <QtCore>
+
+/*
+ * Byte ranges of the symbol anchors in the Simple Libraries HTML docs.
+ * A file is scanned once and again only when its time or size changes.
+ * The ranges are saved so later sessions don't scan unchanged docs.
+ */
+class HelpIndex
+{
+public:
+    static HelpIndex *instance();
+
+    QString snippet(const QString &fileName, const QString &anchor);
+    QString anchorAt(const QString &fileName, qint64 offset);
+    void    prebuild(const QString &folder);
+
+    struct Range {
+        qint64 start;
+        qint64 length;
+    };
+    typedef QHash<QString,Range> AnchorHash;
+
+    static AnchorHash scanAnchors(const QByteArray &html);
+
+private:
+    HelpIndex();
+
+    friend class HelpIndexBuild;
+
+    struct Doc {
+        qint64     modified;
+        qint64     size;
+        AnchorHash anchors;
+    };
+
+    bool    anchorRange(const QString &fileName, const QString &anchor, Range *range);
+    bool    indexFile(const QString &fileName);
+    void    loadCache();
+    void    saveCache();
+    static QString cacheFile();
+
+    QMutex              mutex;
+    QHash<QString,Doc>  docs;
+    QSet<QString>       prebuilt;
+    bool                cacheLoaded;
+    bool                cacheDirty;
+    QThreadPool         buildPool;
+};
+
+#endif // HELPINDEX_H
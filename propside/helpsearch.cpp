@@ -0,0 +1,570 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qtversion.h"
+#include "helpsearch.h"
+#include "directory.h"
+#include "fileindex.h"
+
+#include <math.h>
+
+#define HELPSEARCH_MAGIC "SimpleIDE help search 2"
+
+/*
+ * Brings the index up to date off the GUI thread.
+ */
+class HelpSearchBuild : public QRunnable
+{
+public:
+    HelpSearchBuild(HelpSearch *search) : search(search) { }
+    void run() { search->build(); }
+private:
+    HelpSearch *search;
+};
+
+HelpSearch::HelpSearch(QObject *parent) : QObject(parent)
+{
+    tokensDirty = false;
+    cacheLoaded = false;
+    buildPool.setMaxThreadCount(1);
+
+    /* coalesce folder changes into one incremental build */
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(2000);
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(FileIndex::instance(), SIGNAL(changed(QString)), this, SLOT(folderChanged(QString)));
+}
+
+HelpSearch::~HelpSearch()
+{
+    refreshTimer.stop();
+    buildPool.waitForDone();
+}
+
+void HelpSearch::addFolder(const QString &folder, const QString &pattern)
+{
+    if(folder.isEmpty() || !QFileInfo(folder).isDir())
+        return;
+    Folder f;
+    f.path = FileIndex::key(folder);
+    f.pattern = pattern;
+    {
+        QMutexLocker lock(&mutex);
+        foreach(Folder old, folders) {
+            if(old.path == f.path && old.pattern == f.pattern)
+                return;
+        }
+        folders.append(f);
+    }
+    refreshTimer.start();
+}
+
+void HelpSearch::refresh()
+{
+    buildPool.start(new HelpSearchBuild(this));
+}
+
+void HelpSearch::folderChanged(const QString &dir)
+{
+    QString key = FileIndex::key(dir);
+    QMutexLocker lock(&mutex);
+    foreach(Folder f, folders) {
+        if(key.startsWith(f.path) || f.path.startsWith(key)) {
+            refreshTimer.start();
+            return;
+        }
+    }
+}
+
+void HelpSearch::built()
+{
+    emit indexChanged();
+}
+
+/*
+ * Spin files are often UTF-16 with a byte order mark. Decode them the
+ * way the editor does and return one byte per character, so offsets
+ * are character offsets into the decoded text.
+ */
+static QByteArray decodeSource(QByteArray data)
+{
+    QBuffer buffer(&data);
+    if(!buffer.open(QIODevice::ReadOnly))
+        return data;
+    QTextStream in(&buffer);
+    if(data.startsWith("\xFF\xFE") || data.startsWith("\xFE\xFF"))
+        in.setCodec("UTF-16");
+    else
+        in.setCodec("UTF-8");
+    QString text = in.readAll();
+    buffer.close();
+    return text.toLatin1();
+}
+
+/*
+ * Line number of a Spin hit offset, for putting the editor cursor on it.
+ */
+int HelpSearch::lineAt(const QString &fileName, int offset)
+{
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly))
+        return 0;
+    QByteArray text = decodeSource(file.readAll());
+    file.close();
+    return text.left(offset).count('\n');
+}
+
+/*
+ * Index new and changed files, drop removed ones.
+ */
+void HelpSearch::build()
+{
+    QList<Folder> roots;
+    {
+        QMutexLocker lock(&mutex);
+        loadCache();
+        roots = folders;
+    }
+
+    QSet<QString> files;
+    foreach(Folder f, roots) {
+        QStringList list;
+        Directory::recursiveFindFileList(f.path, f.pattern, list);
+        foreach(QString file, list)
+            files.insert(file);
+    }
+
+    bool changed = false;
+    QStringList known;
+    {
+        QMutexLocker lock(&mutex);
+        known = docIds.keys();
+    }
+    foreach(QString path, known) {
+        if(!files.contains(path)) {
+            QMutexLocker lock(&mutex);
+            dropDoc(path);
+            changed = true;
+        }
+    }
+
+    foreach(QString path, files) {
+        QFileInfo info(path);
+        qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        {
+            QMutexLocker lock(&mutex);
+            int id = docIds.value(path, -1);
+            if(id > -1 && docs[id].modified == modified && docs[id].size == info.size())
+                continue;
+        }
+        QFile file(path);
+        if(!file.open(QFile::ReadOnly))
+            continue;
+        QByteArray data = file.readAll();
+        file.close();
+
+        bool html = path.endsWith(".html", Qt::CaseInsensitive) || path.endsWith(".htm", Qt::CaseInsensitive);
+        if(!html)
+            data = decodeSource(data);
+        Doc doc;
+        doc.path = path;
+        doc.modified = modified;
+        doc.size = info.size();
+        doc.title = html ? QString() : info.completeBaseName();
+        doc.terms = tokenize(data, html, &doc.title);
+        if(doc.title.isEmpty())
+            doc.title = info.fileName();
+
+        QMutexLocker lock(&mutex);
+        dropDoc(path);
+        addDoc(doc);
+        changed = true;
+    }
+
+    if(changed) {
+        QMutexLocker lock(&mutex);
+        saveCache();
+    }
+    QMetaObject::invokeMethod(this, "built", Qt::QueuedConnection);
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void HelpSearch::addDoc(const Doc &doc)
+{
+    int id;
+    if(freeIds.count() > 0) {
+        id = freeIds.takeLast();
+        docs[id] = doc;
+    }
+    else {
+        id = docs.count();
+        docs.append(doc);
+    }
+    docIds.insert(doc.path, id);
+    TermHash::const_iterator it;
+    for(it = doc.terms.constBegin(); it != doc.terms.constEnd(); ++it) {
+        Posting p;
+        p.doc = id;
+        p.offset = it.value().offset;
+        p.count = it.value().count;
+        p.flags = it.value().flags;
+        postings[it.key()].append(p);
+    }
+    tokensDirty = true;
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void HelpSearch::dropDoc(const QString &path)
+{
+    int id = docIds.value(path, -1);
+    if(id < 0)
+        return;
+    docIds.remove(path);
+    foreach(QString token, docs[id].terms.keys()) {
+        QList<Posting> &list = postings[token];
+        for(int n = list.count()-1; n > -1; n--) {
+            if(list.at(n).doc == id)
+                list.removeAt(n);
+        }
+        if(list.isEmpty())
+            postings.remove(token);
+    }
+    docs[id] = Doc();
+    freeIds.append(id);
+    tokensDirty = true;
+}
+
+static bool isWordChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/*
+ * Identifiers are indexed whole and by their underscore separated parts,
+ * so both print_float and float find print_float.
+ */
+static void addWord(HelpSearch::TermHash &terms, const QByteArray &word, int offset)
+{
+    if(word.length() < 2 || word.length() > 64)
+        return;
+    QString token = QString(word).toLower();
+    HelpSearch::TermHash::iterator it = terms.find(token);
+    if(it == terms.end()) {
+        HelpSearch::Term term;
+        term.offset = offset;
+        term.count = 1;
+        term.flags = 0;
+        terms.insert(token, term);
+    }
+    else {
+        it.value().count++;
+    }
+    if(word.contains('_')) {
+        int start = 0;
+        foreach(QByteArray part, word.split('_')) {
+            if(part.length() > 1 && part.length() < word.length())
+                addWord(terms, part, offset+start);
+            start += part.length()+1;
+        }
+    }
+}
+
+static void wordSet(const QString &text, QSet<QString> &set)
+{
+    QByteArray bytes = text.toLatin1();
+    HelpSearch::TermHash terms;
+    int n = 0;
+    while(n < bytes.length()) {
+        if(!isWordChar(bytes.at(n))) {
+            n++;
+            continue;
+        }
+        int start = n;
+        while(n < bytes.length() && isWordChar(bytes.at(n)))
+            n++;
+        addWord(terms, bytes.mid(start, n-start), start);
+    }
+    foreach(QString token, terms.keys())
+        set.insert(token);
+}
+
+static QString stripTags(const QByteArray &html)
+{
+    QString text = QString(html);
+    text.replace(QRegExp("<[^>]*>"), " ");
+    text.replace("&nbsp;", " ");
+    text.replace("&#160;", " ");
+    return text;
+}
+
+/*
+ * Terms of one document. HTML markup, scripts and styles are skipped;
+ * offsets are byte offsets into data, which for Spin is the decoded
+ * text. The HTML <title> or the caller's title marks InTitle words.
+ * Doxygen memname cells and Spin PUB/PRI names mark IsSymbol words.
+ */
+HelpSearch::TermHash HelpSearch::tokenize(const QByteArray &data, bool html, QString *title)
+{
+    TermHash terms;
+    QSet<QString> titleWords;
+    QSet<QString> symbols;
+    QByteArray lower = data.toLower();
+
+    if(html) {
+        int start = lower.indexOf("<title>");
+        int end = lower.indexOf("</title>");
+        if(start > -1 && end > start) {
+            start += 7;
+            *title = stripTags(data.mid(start, end-start)).simplified();
+        }
+        int pos = lower.indexOf("class=\"memname\"");
+        while(pos > -1) {
+            int s = lower.indexOf('>', pos)+1;
+            int e = lower.indexOf("</td>", s);
+            if(s < 1 || e < 0)
+                break;
+            wordSet(stripTags(data.mid(s, e-s)), symbols);
+            pos = lower.indexOf("class=\"memname\"", e);
+        }
+    }
+    else {
+        QRegExp rex("^\\s*(PUB|PRI)\\s+([A-Za-z_][A-Za-z0-9_]*)", Qt::CaseInsensitive);
+        foreach(QString line, QString(data).split("\n")) {
+            if(rex.indexIn(line) > -1)
+                wordSet(rex.cap(2), symbols);
+        }
+    }
+    wordSet(*title, titleWords);
+
+    int n = 0;
+    int length = data.length();
+    while(n < length) {
+        char c = data.at(n);
+        if(html && c == '<') {
+            int end = -1;
+            if(lower.mid(n, 7) == "<script")
+                end = lower.indexOf("</script>", n);
+            else if(lower.mid(n, 6) == "<style")
+                end = lower.indexOf("</style>", n);
+            if(end < 0)
+                end = n;
+            end = lower.indexOf('>', end);
+            if(end < 0)
+                break;
+            n = end+1;
+            continue;
+        }
+        if(html && c == '&') {
+            int end = lower.indexOf(';', n);
+            if(end > n && end-n < 10) {
+                n = end+1;
+                continue;
+            }
+        }
+        if(!isWordChar(c)) {
+            n++;
+            continue;
+        }
+        int start = n;
+        while(n < length && isWordChar(data.at(n)))
+            n++;
+        addWord(terms, data.mid(start, n-start), start);
+    }
+
+    /* title words count even if only in the title or file name */
+    foreach(QString word, titleWords) {
+        if(!terms.contains(word)) {
+            Term term;
+            term.offset = 0;
+            term.count = 1;
+            term.flags = 0;
+            terms.insert(word, term);
+        }
+    }
+
+    TermHash::iterator it;
+    for(it = terms.begin(); it != terms.end(); ++it) {
+        if(titleWords.contains(it.key()))
+            it.value().flags |= InTitle;
+        if(symbols.contains(it.key()))
+            it.value().flags |= IsSymbol;
+    }
+    return terms;
+}
+
+/*
+ * Caller holds the mutex. Keeps the best score per document for token.
+ */
+void HelpSearch::scoreToken(const QString &token, int bonus, QHash<int,double> &scores, QHash<int,int> &offsets)
+{
+    QHash<QString,QList<Posting> >::const_iterator it = postings.constFind(token);
+    if(it == postings.constEnd())
+        return;
+    const QList<Posting> &list = it.value();
+    double idf = log(1.0+(double)docIds.count()/list.count());
+    foreach(Posting p, list) {
+        double score = (1.0+log((double)p.count))*idf + bonus;
+        if(p.flags & IsSymbol)
+            score += 8;
+        if(p.flags & InTitle)
+            score += 4;
+        if(score > scores.value(p.doc, 0)) {
+            scores.insert(p.doc, score);
+            offsets.insert(p.doc, p.offset);
+        }
+    }
+}
+
+static bool hitLessThan(const HelpSearch::Hit &a, const HelpSearch::Hit &b)
+{
+    if(a.score != b.score)
+        return a.score > b.score;
+    return a.title < b.title;
+}
+
+/*
+ * Every word must match. The last word also matches as a prefix so
+ * results follow the user's typing.
+ */
+QList<HelpSearch::Hit> HelpSearch::query(const QString &text, int maxHits)
+{
+    QList<Hit> hits;
+    QStringList words = text.toLower().split(QRegExp("[^a-z0-9_]+"), QString::SkipEmptyParts);
+    if(words.isEmpty() || (words.count() == 1 && words.at(0).length() < 2))
+        return hits;
+
+    QMutexLocker lock(&mutex);
+    if(tokensDirty) {
+        tokens = postings.keys();
+        tokens.sort();
+        tokensDirty = false;
+    }
+
+    QHash<int,double> total;
+    QHash<int,int> offsets;
+    for(int n = 0; n < words.count(); n++) {
+        QString word = words.at(n);
+        QHash<int,double> scores;
+        QHash<int,int> wordOffsets;
+        if(n == words.count()-1) {
+            QStringList::const_iterator it = qLowerBound(tokens.constBegin(), tokens.constEnd(), word);
+            for(int count = 0; it != tokens.constEnd() && it->startsWith(word) && count < 200; ++it, ++count)
+                scoreToken(*it, *it == word ? 2 : 0, scores, wordOffsets);
+        }
+        else {
+            scoreToken(word, 2, scores, wordOffsets);
+        }
+
+        if(n == 0) {
+            total = scores;
+            offsets = wordOffsets;
+            continue;
+        }
+        foreach(int doc, total.keys()) {
+            if(scores.contains(doc))
+                total[doc] += scores.value(doc);
+            else
+                total.remove(doc);
+        }
+    }
+
+    QHash<int,double>::const_iterator it;
+    for(it = total.constBegin(); it != total.constEnd(); ++it) {
+        Hit hit;
+        hit.path = docs.at(it.key()).path;
+        hit.title = docs.at(it.key()).title;
+        hit.offset = offsets.value(it.key());
+        hit.score = it.value();
+        hits.append(hit);
+    }
+    qSort(hits.begin(), hits.end(), hitLessThan);
+    while(hits.count() > maxHits)
+        hits.removeLast();
+    return hits;
+}
+
+QString HelpSearch::cacheFile()
+{
+    return Directory::cacheLocation("helpsearch.cache");
+}
+
+/*
+ * Caller holds the mutex. The cache holds each document's terms;
+ * postings are rebuilt from them.
+ */
+void HelpSearch::loadCache()
+{
+    if(cacheLoaded)
+        return;
+    cacheLoaded = true;
+
+    QFile file(cacheFile());
+    if(!file.open(QFile::ReadOnly))
+        return;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+    QString magic;
+    qint32 count = 0;
+    in >> magic >> count;
+    if(magic != HELPSEARCH_MAGIC)
+        return;
+    for(int n = 0; n < count && in.status() == QDataStream::Ok; n++) {
+        Doc doc;
+        qint32 terms = 0;
+        in >> doc.path >> doc.title >> doc.modified >> doc.size >> terms;
+        for(int t = 0; t < terms && in.status() == QDataStream::Ok; t++) {
+            QString token;
+            Term term;
+            in >> token >> term.offset >> term.count >> term.flags;
+            doc.terms.insert(token, term);
+        }
+        if(in.status() == QDataStream::Ok && !docIds.contains(doc.path))
+            addDoc(doc);
+    }
+}
+
+/*
+ * Caller holds the mutex.
+ */
+void HelpSearch::saveCache()
+{
+    QString name = cacheFile();
+    QDir().mkpath(QFileInfo(name).path());
+    QFile file(name+".tmp");
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+    out << QString(HELPSEARCH_MAGIC) << (qint32) docIds.count();
+    foreach(Doc doc, docs) {
+        if(doc.path.isEmpty())
+            continue;
+        out << doc.path << doc.title << doc.modified << doc.size << (qint32) doc.terms.count();
+        TermHash::const_iterator it;
+        for(it = doc.terms.constBegin(); it != doc.terms.constEnd(); ++it)
+            out << it.key() << it.value().offset << it.value().count << it.value().flags;
+    }
+    file.close();
+    QFile::remove(name);
+    QFile::rename(name+".tmp", name);
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HELPSEARCH_H
+#define HELPSEARCH_H
+
+#include <QtCore>
+
+/*
+ * Full-text index over the Simple Libraries HTML docs and the Spin
+ * examples. Built on a background thread, stored on disk, and updated
+ * incrementally when files under the indexed folders change.
+ */
+class HelpSearch : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HelpSearch(QObject *parent = 0);
+    ~HelpSearch();
+
+    struct Hit {
+        QString path;
+        QString title;
+        int     offset;
+        double  score;
+    };
+
+    void        addFolder(const QString &folder, const QString &pattern);
+    QList<Hit>  query(const QString &text, int maxHits = 50);
+
+    static int  lineAt(const QString &fileName, int offset);
+
+    /* one token found in one document */
+    struct Term {
+        qint32  offset;     // first occurrence: byte in HTML, character in Spin
+        qint32  count;
+        quint8  flags;
+    };
+    enum { InTitle = 1, IsSymbol = 2 };
+    typedef QHash<QString,Term> TermHash;
+
+    static TermHash tokenize(const QByteArray &data, bool html, QString *title);
+
+signals:
+    void indexChanged();
+
+public slots:
+    void refresh();
+
+private slots:
+    void folderChanged(const QString &dir);
+    void built();
+
+private:
+    friend class HelpSearchBuild;
+
+    struct Doc {
+        QString  path;
+        QString  title;
+        qint64   modified;
+        qint64   size;
+        TermHash terms;
+    };
+    struct Posting {
+        qint32  doc;
+        qint32  offset;
+        qint32  count;
+        quint8  flags;
+    };
+    struct Folder {
+        QString path;
+        QString pattern;
+    };
+
+    void    build();
+    void    addDoc(const Doc &doc);
+    void    dropDoc(const QString &path);
+    void    loadCache();
+    void    saveCache();
+    static QString cacheFile();
+    void    scoreToken(const QString &token, int bonus, QHash<int,double> &scores, QHash<int,int> &offsets);
+
+    QMutex                      mutex;
+    QList<Folder>               folders;
+    QList<Doc>                  docs;       // removed documents leave an empty path
+    QList<int>                  freeIds;    // empty slots in docs, reused by addDoc
+    QHash<QString,int>          docIds;
+    QHash<QString,QList<Posting> > postings;
+    QStringList                 tokens;     // sorted, for prefix lookups
+    bool                        tokensDirty;
+    bool                        cacheLoaded;
+    QTimer                      refreshTimer;
+    QThreadPool                 buildPool;
+};
+
+#endif // HELPSEARCH_H
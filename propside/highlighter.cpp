@@ -54,13 +54,35 @@ Highlighter::Highlighter(QTextDocument *parent, Properties *prop)
     : QSyntaxHighlighter(parent)
 {
     properties = prop;
+    refreshPending = false;
     highlight();
+    connect(SettingsCache::instance(), SIGNAL(valueChanged(QString,QVariant)),
+            this, SLOT(settingChanged(QString)));
+}
+
+/*
+ * Rebuild the rules once after a batch of highlight setting changes.
+ */
+void Highlighter::settingChanged(QString key)
+{
+    if(!key.startsWith("SimpleIDE_Highlight") || refreshPending)
+        return;
+    refreshPending = true;
+    QTimer::singleShot(0, this, SLOT(refresh()));
+}
+
+void Highlighter::refresh()
+{
+    refreshPending = false;
+    highlightingRules.clear();
+    highlight();
+    rehighlight();
 }
 
 bool Highlighter::getStyle(QString key, bool *italic)
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant var = settings.value(key, false);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant var = settings->value(key, false);
 
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
@@ -72,8 +94,8 @@ bool Highlighter::getStyle(QString key, bool *italic)
 
 bool Highlighter::getWeight(QString key, QFont::Weight *weight)
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant var = settings.value(key, false);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant var = settings->value(key, false);
 
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
@@ -85,8 +107,8 @@ bool Highlighter::getWeight(QString key, QFont::Weight *weight)
 
 bool Highlighter::getColor(QString key, Qt::GlobalColor *color)
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant var = settings.value(key, false);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant var = settings->value(key, false);
 
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
@@ -74,6 +74,10 @@ public:
 
     virtual void highlight();
 
+public slots:
+    void settingChanged(QString key);
+    void refresh();
+
 protected:
     void highlightBlock(const QString &text);
 
@@ -97,6 +101,7 @@ protected:
     QTextCharFormat numberFormat;
 
     Properties      *properties;
+    bool            refreshPending;
 
     bool            hlNumStyle;
     QFont::Weight   hlNumWeight;
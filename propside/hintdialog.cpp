@@ -24,7 +24,7 @@
 HintDialog::HintDialog(QString tag, QString hint, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::HintDialog),
-    settings(publisherKey, ASideGuiKey),
+    settings(SettingsCache::instance()),
     key(HintKeyPrefix + tag)
 {
     ui->setupUi(this);
@@ -41,7 +41,7 @@ HintDialog::~HintDialog()
 int HintDialog::exec()
 {
     int sts = 0;
-    if (settings.value(key, true).toBool())
+    if (settings->value(key, true).toBool())
         sts = QDialog::exec();
     return sts;
 }
@@ -49,7 +49,7 @@ int HintDialog::exec()
 void HintDialog::on_okButton_clicked()
 {
     if (!ui->showNextTimeCheckBox->isChecked())
-        settings.setValue(key, false);
+        settings->setValue(key, false);
     close();
 }
 
@@ -21,7 +21,7 @@
 #define HINTDIALOG_H
 
 #include <QDialog>
-#include <QSettings>
+#include "settingscache.h"
 
 namespace Ui {
 class HintDialog;
@@ -43,7 +43,7 @@ private slots:
     
 private:
     Ui::HintDialog *ui;
-    QSettings settings;
+    SettingsCache *settings;
     QString key;
 };
 
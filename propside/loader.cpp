@@ -79,8 +79,8 @@ int Loader::reload(QString port)
     QStringList args;
 
     if(this->program.length() == 0) {
-        QSettings settings(publisherKey, ASideGuiKey,this);
-        QVariant incv = settings.value(propLoaderKey);
+        SettingsCache *settings = SettingsCache::instance();
+        QVariant incv = settings->value(propLoaderKey);
         if(incv.canConvert(QVariant::String)) {
             QString s = incv.toString();
             s = QDir::fromNativeSeparators(s);
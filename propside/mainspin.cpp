@@ -18,9 +18,11 @@
  */
 
 #include "mainspinwindow.h"
+#include "termbench.h"
 
 int main(int argc, char *argv[])
 {
+    StartupTimer::start();
     QApplication a(argc, argv);
 #if defined(IDEDEBUG) && !defined(QT5)
     MainSpinWindow w;
@@ -33,6 +35,14 @@ int main(int argc, char *argv[])
 #endif
     a.setApplicationName(ASideGuiKey);
 
+    /*
+     * SimpleIDE -bench-terminal <port> <seconds>
+     * measures terminal throughput without opening the IDE.
+     */
+    if(argc > 3 && QString(argv[1]) == "-bench-terminal") {
+        return TerminalBench::run(QString(argv[2]), QString(argv[3]).toInt());
+    }
+
     qDebug() << a.applicationName() << "argument count " << argc;
     qDebug() << "Arguments: ";
     foreach(QString arg, a.arguments()) {
@@ -88,6 +98,7 @@ int main(int argc, char *argv[])
         }
     }
     w.show();
+    StartupTimer::mark("main window ready");
 
     return a.exec();
 }
@@ -39,6 +39,8 @@
 //#include "quazipfile.h"
 #include "PropellerID.h"
 #include "directory.h"
+#include "treeremove.h"
+#include "fileindex.h"
 
 #define ENABLE_ADD_LINK
 #define APP_FOLDER_TEMPLATES
@@ -53,8 +55,6 @@
 #define SIMPLE_BOARD_TOOLBAR
  */
 
-#define ESP8266_MODULE
-
 #define SD_TOOLS
 #define APPWINDOW_START_HEIGHT 620
 #define APPWINDOW_START_WIDTH 720
@@ -101,6 +101,7 @@
 #define FileToSDCard "File to SD Card"
 
 #define BuildAllLibraries "Build All Libraries"
+#define CleanAllOutputs "Clean All Outputs"
 
 /**
  * @brief g_ApplicationClosing
@@ -152,7 +153,8 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
     QCoreApplication::setApplicationName(ASideGuiKey);
 
     /* global settings */
-    settings = new QSettings(publisherKey, ASideGuiKey, this);
+    settings = SettingsCache::instance();
+    StartupTimer::mark("settings");
 
     /* get last geometry. using x,y,w,h is unreliable.
      */
@@ -170,6 +172,7 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
     propDialog = new Properties(this);
     connect(propDialog,SIGNAL(accepted()),this,SLOT(propertiesAccepted()));
     connect(propDialog,SIGNAL(clearAndExit()),this,SLOT(clearAndExit()));
+    StartupTimer::mark("properties dialog");
 
     /* setup user's editor font */
     QVariant fontv = settings->value(editorFontKey);
@@ -196,12 +199,10 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
     }
 
 
-    /* setup new project dialog */
-    newProjDialog = new NewProject(this);
-    connect(newProjDialog,SIGNAL(accepted()),this,SLOT(newProjectAccepted()));
-
-    /* setup find/replace dialog */
-    replaceDialog = new ReplaceDialog(this);
+    /* dialogs are created on first use */
+    newProjDialog = NULL;
+    replaceDialog = NULL;
+    rescueDialog = NULL;
 
     /* new ASideConfig class */
     aSideConfig = new ASideConfig();
@@ -219,9 +220,13 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
 
     /* start with an empty file if fresh install */
     newFile();
+    StartupTimer::mark("project tools");
 
-    /* get app settings at startup and before any compiler call */
+    /* get app settings at startup and before any compiler call.
+     * this also starts loading board configurations in the background.
+     */
     getApplicationSettings();
+    StartupTimer::mark("application settings");
 
     /* set up ctag tool */
     ctags = new CTags(aSideCompilerPath);
@@ -230,21 +235,23 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
     setupFileMenu();
     setupHelpMenu();
     setupToolBars();
+    StartupTimer::mark("menus and toolbars");
 
     /* show gui */
     QApplication::processEvents();
 
-    initBoardTypes();
+    /* boards were loaded by getApplicationSettings */
+    fillBoardTypes();
+    StartupTimer::mark("board types");
 
     /* start a process object for the loader to use */
     process = new QProcess(this);
 
 #ifdef ENABLE_WXLOADER
-    wxProcess = new QProcess(this);
-
-    connect(wxProcess, SIGNAL(readyReadStandardOutput()),this,SLOT(wxProcReadyRead()));
-    connect(wxProcess, SIGNAL(error(QProcess::ProcessError)),this,SLOT(wxProcError(QProcess::ProcessError)));
-    connect(wxProcess, SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(wxProcFinished(int,QProcess::ExitStatus)));
+    /* WX modules are found in the background and cached */
+    wxDiscovery = new WxDiscovery(this);
+    connect(wxDiscovery, SIGNAL(portsChanged()), this, SLOT(wxPortsChanged()));
+    wxDiscovery->discover();
 #endif
 
     projectFile = "none";
@@ -255,10 +262,14 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
 #endif
     builder = buildC;
 
+    /* build timeline is written to trace.json when enabled */
+    BuildTrace::setEnabled(settings->value(buildTraceKey, false).toBool() || !qgetenv("SIMPLEIDE_TRACE").isEmpty());
+
     connect(buildC, SIGNAL(showCompileStatusError()), this, SLOT(showCompileStatusError()));
 #ifdef SPIN
     connect(buildSpin, SIGNAL(showCompileStatusError()), this, SLOT(showCompileStatusError()));
 #endif
+    StartupTimer::mark("builders");
 
     /* setup loader and port listener */
     /* setup the terminal dialog box */
@@ -304,7 +315,7 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
 
     connect(term,SIGNAL(accepted()),this,SLOT(terminalClosed()));
     connect(term,SIGNAL(rejected()),this,SLOT(terminalClosed()));
-
+    StartupTimer::mark("terminal");
 
     /* Before window shows:
      * Create new workspace from package
@@ -312,32 +323,20 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
      * Replace an existing one that's out of date.
      */
     propDialog->replaceLearnWorkspace();
+    StartupTimer::mark("workspace");
 
-
-    /* get available ports at startup */
-    enumeratePorts();
-
-    portConnectionMonitor = new PortConnectionMonitor();
-    connect(portConnectionMonitor, SIGNAL(portChanged()), this, SLOT(enumeratePortsEvent()));
+    propProbe = new PropellerProbe(this);
 
     /* these are read once per app startup */
     QVariant lastportv  = settings->value(lastPortNameKey);
     if(lastportv.canConvert(QVariant::String))
         portName = lastportv.toString();
 
-    /* setup the first port displayed in the combo box */
-    if(cbPort->count() > 0) {
-        int ndx = 0;
-        if(portName.length() != 0) {
-            for(int n = cbPort->count()-1; n > -1; n--)
-                if(cbPort->itemText(n) == portName)
-                {
-                    ndx = n;
-                    break;
-                }
-        }
-        setCurrentPort(ndx);
-    }
+    /* get available ports in the background; startupPortsReady fills the
+     * port combo and starts the port connection monitor.
+     */
+    portConnectionMonitor = NULL;
+    QThreadPool::globalInstance()->start(new PortScan(&startupPorts, this));
 
 #ifdef ALWAYS_ALLOW_PROJECT_VIEW
     allowProjectView = true;
@@ -359,6 +358,7 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
 
     this->show();
     QApplication::processEvents();
+    StartupTimer::mark("window shown");
 
     QString workspace;
 
@@ -439,6 +439,8 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
         ed->raise();
     }
 
+    StartupTimer::mark("last project");
+
 #ifndef SHOW_IDE_EARLY
     this->show(); // show gui before about for mac
     QApplication::processEvents();
@@ -450,7 +452,6 @@ MainSpinWindow::MainSpinWindow(QWidget *parent) : QMainWindow(parent),
             aboutDialog->exec();
     }
 #endif
-    rescueDialog = new RescueDialog(this);
 
 #if 0
     // remove according to issue 212
@@ -567,8 +568,12 @@ void MainSpinWindow::getApplicationSettings()
     else
     {
         /* load boards in case there were changes */
-        aSideConfig->loadBoards(aSideCfgFile);
+        aSideConfig->loadBoardsAsync(aSideCfgFile);
     }
+
+    /* index the workspace and Spin library in the background */
+    FileIndex::instance()->addRoot(settings->value(gccWorkspaceKey).toString());
+    FileIndex::instance()->addRoot(propDialog->getSpinLibraryStr());
 }
 
 void MainSpinWindow::exitSave()
@@ -632,17 +637,17 @@ void MainSpinWindow::closeEvent(QCloseEvent *event)
 
 void MainSpinWindow::clearAndExit()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    QStringList list = settings.allKeys();
+    SettingsCache *settings = SettingsCache::instance();
+    QStringList list = settings->allKeys();
 
     foreach(QString key, list) {
         if(key.indexOf(ASideGuiKey) == 0) {
-            settings.remove(key);
+            settings->remove(key);
         }
     }
 
-    settings.remove(publisherComKey);
-    settings.remove(publisherKey);
+    settings->remove(publisherComKey);
+    settings->remove(publisherKey);
 
 }
 
@@ -654,7 +659,8 @@ void MainSpinWindow::quitProgram()
     portListener->close();
     term->accept(); // just in case serial terminal is open
 
-    portConnectionMonitor->stop();
+    if(portConnectionMonitor)
+        portConnectionMonitor->stop();
     programStopBuild();
 
     exitSave(); // find
@@ -1153,6 +1159,24 @@ void MainSpinWindow::openFile(const QString &path)
     */
 }
 
+/*
+ * Open a help search hit with the cursor on its line.
+ */
+void MainSpinWindow::openFileLine(QString fileName, int line)
+{
+    openFile(fileName);
+    if(editorTabs->count() == 0)
+        return;
+    Editor *editor = editors->at(editorTabs->currentIndex());
+    QTextBlock block = editor->document()->findBlockByNumber(line);
+    if(!block.isValid())
+        return;
+    QTextCursor cur = editor->textCursor();
+    cur.setPosition(block.position());
+    editor->setTextCursor(cur);
+    editor->centerCursor();
+}
+
 bool MainSpinWindow::isFileUTF16(QFile *file)
 {
     char str[2];
@@ -1760,13 +1784,13 @@ void MainSpinWindow::newProject()
 
 void MainSpinWindow::newProjectAccepted()
 {
-    QString name = newProjDialog->getName();
-    QString path = newProjDialog->getPath();
+    QString name = getNewProjDialog()->getName();
+    QString path = getNewProjDialog()->getPath();
     name = name.trimmed();
     path = path.trimmed();
     QDir dir(path);
 
-    QString comp = newProjDialog->getCompilerType();
+    QString comp = getNewProjDialog()->getCompilerType();
 
     qDebug() << "Project Name:" << name;
     qDebug() << "Project Compiler:" << comp;
@@ -3430,9 +3454,6 @@ QStringList MainSpinWindow::zipCproject(QStringList projList, QString srcPath, Q
      */
     QString zipLib("library/");
 
-    // WORK IN PROGRESS
-    // need to call gcc -M to find other includes.
-
 #ifdef ENABLE_AUTOLIB
     QString linkopts;
     QStringList libs;
@@ -3619,6 +3640,17 @@ QStringList MainSpinWindow::zipCproject(QStringList projList, QString srcPath, Q
         }
     }
 
+    /* headers the sources include but the project list doesn't name */
+    if(sourcePath(projFile) != sourcePath(dstProjFile)) {
+        foreach(QString hdr, buildC->getLocalHeaders(projFile)) {
+            QString dst = sourcePath(dstProjFile)+hdr;
+            if(QFile::exists(dst))
+                continue;
+            QDir().mkpath(sourcePath(dst));
+            QFile::copy(sourcePath(projFile)+hdr, dst);
+        }
+    }
+
     if(projectOptions->getMakeLibrary().isEmpty() == false) {
         QDir dir(srcPath);
         QStringList models = projectOptions->getMemModelList();
@@ -3702,8 +3734,11 @@ QString MainSpinWindow::findFileNoCase(QString file)
     if(file.indexOf("/") < 0)
         return fileret;
     QString path = file.mid(0,file.lastIndexOf("/")+1);
-    QDir dir(path);
-    QStringList list = dir.entryList(QDir::AllEntries);
+    QStringList list;
+    if(!FileIndex::instance()->entries(path, list)) {
+        QDir dir(path);
+        list = dir.entryList(QDir::AllEntries);
+    }
     file = file.mid(file.lastIndexOf("/")+1);
     foreach(QString item, list) {
         if(file.compare(item, Qt::CaseInsensitive) == 0) {
@@ -3796,6 +3831,9 @@ void MainSpinWindow::setCurrentProject(const QString &fileName)
 {
     projectFile = fileName;
 
+    /* project folders outside the workspace get their own listing indexed */
+    FileIndex::instance()->addRoot(sourcePath(fileName), false);
+
     QStringList files = settings->value(recentProjectsKey).toStringList();
     files.removeAll(fileName);
     files.prepend(fileName);
@@ -4187,255 +4225,6 @@ void MainSpinWindow::procFinished(int exitCode, QProcess::ExitStatus exitStatus)
         status->setText(status->text()+" done.");
 }
 
-void MainSpinWindow::wxProcReadyLoad(void)
-{
-    QString str = wxProcess->readAllStandardOutput();
-    compileStatus->appendPlainText(str);
-
-    qDebug() << "wxProcReadyLoad" << str;
-
-    if (str.length() == 0) {
-        return;
-    }
-
-    wxPortString += str;
-}
-
-void MainSpinWindow::wxProcReadyRead(void)
-{
-    QVariant namev = wxProcess->property("Name");
-    QString name = namev.toString();
-    QString str;
-
-    if(procDone == true) return;
-
-    qDebug() << "wxProcReadyRead" << str;
-
-    if (name.compare(aSideLoader) == 0) {
-        wxProcReadyLoad();
-    }
-    else {
-        str = wxProcess->readAllStandardOutput();
-        compileStatus->appendPlainText(str);
-    }
-}
-
-void MainSpinWindow::wxProcError(QProcess::ProcessError error)
-{
-    QVariant name = wxProcess->property("Name");
-
-    if(procDone == true) return;
-
-    qDebug() << "wxProcError" << error;
-
-    compileStatus->appendPlainText(name.toString() + tr(" error ... (%1)").arg(error));
-    compileStatus->appendPlainText(wxProcess->readAllStandardOutput());
-
-    procMutex.lock();
-    procDone = true;
-    procMutex.unlock();
-}
-
-#ifdef ESP8266_MODULE
-void MainSpinWindow::wxProcFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    if(procDone == true)
-        return;
-
-    qDebug() << "wxProcFinished" << wxPortString << exitCode << exitStatus;
-
-    QString str = wxPortString;
-
-    if (!str.contains("Name:",Qt::CaseInsensitive)) {
-        procMutex.lock();
-        procDone = true;
-        procMutex.unlock();
-        return;
-    }
-
-    QStringList ms = str.split("\n", QString::SkipEmptyParts, Qt::CaseInsensitive);
-    QRegExp ipre("IP:");
-    QRegExp idre("Name:");
-    QRegExp mcre("MAC:");
-    QStringList fs;
-
-    foreach (QString mod, ms) {
-        WxPortInfo info;
-        info.ipAddr = "";
-        info.macUpper = "";
-        info.macAddr = "";
-        info.portName = "";
-        info.VendorName = "";
-
-        if (mod.contains(ipre) && mod.contains(idre)) {
-            QStringList sl = mod.split(",", QString::SkipEmptyParts);
-            foreach (QString s, sl) {
-                if (s.contains(ipre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        info.ipAddr = fs[1].trimmed();
-                    }
-                }
-                else if (s.contains(idre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        fs[1] = fs[1].toUpper();
-                        info.portName = fs[1].trimmed();
-                        while (info.portName.contains("'")) {
-                            info.portName = info.portName.replace("'","");
-                        }
-                        info.portName = info.portName.trimmed();
-
-                        /*
-                        if (info.portName.length() == 0) {
-                            info.portName = "X-"+info.macUpper+"-"+info.macAddr;
-                        }
-                        */
-                    }
-                }
-                else if (s.contains(mcre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        fs[1] = fs[1].toUpper();
-                        info.macUpper = fs[1].trimmed()+fs[2].trimmed()+fs[3].trimmed();
-                        info.macAddr  = fs[4].trimmed()+fs[5].trimmed()+fs[6].trimmed();
-                    }
-                }
-            }
-        }
-        if (info.ipAddr.length()) {
-
-            if (info.portName.length() == 0) {
-                info.portName = "X-"+info.macAddr;
-            }
-            QString name = info.portName;
-            foreach (WxPortInfo myinfo, wxPorts) {
-                if (name.compare(myinfo.portName, Qt::CaseInsensitive) == 0) {
-                    name += "-" + info.ipAddr;
-                    info.portName = name;
-                }
-            }
-            wxPorts.append(info);
-        }
-#ifdef REMOVE
-        if (info.ipAddr.length() &&
-            info.macAddr.length() &&
-            info.macUpper.length()) {
-
-            if (info.portName.length() == 0) {
-                //info.portName = "X-"+info.portName;
-                QString macser = info.macAddr.mid(10).trimmed();
-                if (info.macUpper.compare("00409d") == 0) { // One Digi vendor ID
-                    info.VendorName = "Digi";
-                    info.portName = "X-"+info.VendorName+"-"+macser;
-                }
-                else {
-                    info.portName = "X-"+info.macUpper+info.macAddr;
-                }
-            }
-            wxPorts.append(info);
-        }
-#endif
-    }
-
-    procMutex.lock();
-    procDone = true;
-    procMutex.unlock();
-}
-#endif
-
-#ifdef XBEE_SB6_MODULE
-void MainSpinWindow::wxProcFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    if(procDone == true)
-        return;
-
-    qDebug() << "wxProcFinished" << exitCode << exitStatus;
-
-    QString str = wxPortString;
-
-    if (!str.contains("========",Qt::CaseInsensitive)) {
-        procMutex.lock();
-        procDone = true;
-        procMutex.unlock();
-        return;
-    }
-
-    QStringList ms = str.split("========", QString::SkipEmptyParts, Qt::CaseInsensitive);
-    QRegExp ipre("ipAddr:");
-    QRegExp idre("nodeId:");
-    QRegExp mcre("macAddr:");
-    QStringList fs;
-
-    foreach (QString mod, ms) {
-        WxPortInfo info;
-        info.ipAddr = "";
-        info.macUpper = "";
-        info.macAddr = "";
-        info.portName = "";
-        info.VendorName = "";
-
-        if (mod.contains(ipre) && mod.contains(idre) && mod.contains(mcre)) {
-            QStringList sl = mod.split("\n", QString::SkipEmptyParts);
-            foreach (QString s, sl) {
-                if (s.contains(ipre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        info.ipAddr = fs[1].trimmed();
-                    }
-                }
-                else if (s.contains(idre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        fs[1] = fs[1].toUpper();
-                        info.portName = fs[1].trimmed();
-                        while (info.portName.contains("'")) {
-                            info.portName = info.portName.replace("'","");
-                        }
-                        info.portName = info.portName.trimmed();
-
-                        /*
-                        if (info.portName.length() == 0) {
-                            info.portName = "X-"+info.macUpper+"-"+info.macAddr;
-                        }
-                        */
-                    }
-                }
-                else if (s.contains(mcre)) {
-                    fs = s.split(":", QString::SkipEmptyParts);
-                    if (fs.length() > 0) {
-                        fs[1] = fs[1].toUpper();
-                        info.macUpper = fs[1].trimmed().mid(4,6);
-                        info.macAddr = fs[1].trimmed();
-                    }
-                }
-            }
-        }
-        if (info.ipAddr.length() &&
-            info.macAddr.length() &&
-            info.macUpper.length()) {
-
-            if (info.portName.length() == 0) {
-                //info.portName = "X-"+info.portName;
-                QString macser = info.macAddr.mid(10).trimmed();
-                if (info.macUpper.compare("00409d") == 0) { // One Digi vendor ID
-                    info.VendorName = "Digi";
-                    info.portName = "X-"+info.VendorName+"-"+macser;
-                }
-                else {
-                    info.portName = "X-"+info.macUpper+info.macAddr;
-                }
-            }
-            wxPorts.append(info);
-        }
-    }
-
-    procMutex.lock();
-    procDone = true;
-    procMutex.unlock();
-}
-#endif
-
 /*
  * save for cat dumps
  */
@@ -4751,9 +4540,35 @@ void MainSpinWindow::fontSmaller()
     }
 }
 
-void MainSpinWindow::replaceInFile()
+/*
+ * Dialogs below are not needed at startup and are created on first use.
+ */
+NewProject *MainSpinWindow::getNewProjDialog()
+{
+    if(!newProjDialog) {
+        newProjDialog = new NewProject(this);
+        connect(newProjDialog,SIGNAL(accepted()),this,SLOT(newProjectAccepted()));
+    }
+    return newProjDialog;
+}
+
+ReplaceDialog *MainSpinWindow::getReplaceDialog()
 {
     if(!replaceDialog)
+        replaceDialog = new ReplaceDialog(this);
+    return replaceDialog;
+}
+
+RescueDialog *MainSpinWindow::getRescueDialog()
+{
+    if(!rescueDialog)
+        rescueDialog = new RescueDialog(this);
+    return rescueDialog;
+}
+
+void MainSpinWindow::replaceInFile()
+{
+    if(!getReplaceDialog())
         return;
 
     Editor *editor = editors->at(editorTabs->currentIndex());
@@ -5088,10 +4903,11 @@ void MainSpinWindow::propertiesAccepted()
 {
     getApplicationSettings();
     initBoardTypes();
+    helpDialog->setSearchFolders(settings->value(gccWorkspaceKey).toString()+"Learn/", propDialog->getSpinLibraryStr());
+    /* highlighters follow their settings through SettingsCache */
     for(int n = 0; n < editorTabs->count(); n++) {
         Editor *e = editors->at(n);
         e->setTabStopWidth(propDialog->getTabSpaces()*10);
-        e->setHighlights(editorTabs->tabText(n));
     }
 }
 
@@ -5208,6 +5024,55 @@ void MainSpinWindow::programBuildAllLibraries()
     }
 }
 
+/*
+ * Remove the memory model output folders of every project in the
+ * workspace. Only folders next to a .side file are touched.
+ */
+void MainSpinWindow::programCleanAllOutputs()
+{
+    QString workspace = propDialog->getCurrentWorkspace();
+    if (workspace.endsWith("/") == false) workspace += "/";
+
+    int question = QMessageBox::question(this,tr(CleanAllOutputs), tr("Remove the build output folders of all projects in")+
+                          "\n"+workspace+"?",QMessageBox::Yes,QMessageBox::No);
+    if(question != QMessageBox::Yes) {
+        return;
+    }
+
+    QStringList files;
+    Directory::recursiveFindFileList(workspace, "*.side", files);
+
+    QStringList outputs;
+    /* same names BuildC::ensureOutputDirectory makes from getMemModel() */
+    foreach(QString model, projectOptions->getMemModelList()) {
+        model = model.toLower().replace("-","_");
+        if(model.length() > 0 && outputs.contains(model) == false)
+            outputs.append(model);
+    }
+
+    QStringList dirs;
+    foreach(QString file, files) {
+        QString path = sourcePath(file);
+        foreach(QString model, outputs) {
+            if(QFileInfo(path+model).isDir() && dirs.contains(path+model) == false)
+                dirs.append(path+model);
+        }
+    }
+
+    statusDialog->init(tr(CleanAllOutputs), tr("Removing build output folders."));
+    TreeRemove remover;
+    remover.remove(dirs);
+    statusDialog->stop();
+
+    QString msg = tr("Removed %1 files in %2 folders, %3 MB freed.")
+            .arg(remover.fileCount()).arg(dirs.count())
+            .arg(remover.bytesFreed()/(1024.0*1024.0), 0, 'f', 1);
+    compileStatus->setPlainText(msg);
+    if(remover.failedCount() > 0)
+        compileStatus->appendPlainText(tr("%1 items could not be removed.").arg(remover.failedCount()));
+    status->setText(msg);
+}
+
 void MainSpinWindow::programStopBuild()
 {
     if(builder != NULL)
@@ -5240,7 +5105,7 @@ void MainSpinWindow::programBurnEE()
     runLoader("-e -r");
     if(connected) {
         term->getEditor()->setPlainText("");
-        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));
+        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
         portListener->open();
         btnConnected->setChecked(true);
         term->setPortEnabled(true);
@@ -5264,7 +5129,7 @@ void MainSpinWindow::programRun()
     runLoader("-r");
     if(connected) {
         term->getEditor()->setPlainText("");
-        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));
+        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
         portListener->open();
         btnConnected->setChecked(true);
         term->setPortEnabled(true);
@@ -5290,7 +5155,7 @@ void MainSpinWindow::programDebug()
         return;
     }
 
-    portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));
+    portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
     portListener->open();
 
     btnConnected->setChecked(true);
@@ -5440,10 +5305,14 @@ void MainSpinWindow::setupHelpMenu()
     helpMenu->addAction(QIcon(":/images/UserHelp.png"), tr("&Build Error Rescue"), this, SLOT(buildRescueShow()));
     helpMenu->addAction(QIcon(":/images/about.png"), tr("&About"), this, SLOT(aboutShow()));
     helpMenu->addAction(QIcon(":/images/Credits.png"), tr("&Credits"), this, SLOT(creditShow()));
+    helpMenu->addAction(tr("Search Help"), this, SLOT(helpSearchShow()));
+    helpMenu->addAction(tr("Startup Timing"), this, SLOT(startupTimingShow()));
     //helpMenu->addAction(QIcon(":/images/Library.png"), tr("&Library"), this, SLOT(libraryShow()));
 
     /* new Help class */
     helpDialog = new Help();
+    connect(helpDialog,SIGNAL(openSource(QString,int)),this,SLOT(openFileLine(QString,int)));
+    helpDialog->setSearchFolders(settings->value(gccWorkspaceKey).toString()+"Learn/", propDialog->getSpinLibraryStr());
 }
 
 void MainSpinWindow::aboutShow()
@@ -5451,6 +5320,17 @@ void MainSpinWindow::aboutShow()
     aboutDialog->show();
 }
 
+void MainSpinWindow::helpSearchShow()
+{
+    helpDialog->showSearch();
+}
+
+void MainSpinWindow::startupTimingShow()
+{
+    QMessageBox::information(this, tr("Startup Timing"),
+        tr("Time spent in each startup phase.")+"<pre>"+StartupTimer::report()+"</pre>");
+}
+
 void MainSpinWindow::creditShow()
 {
     QString license(ASideGuiKey+tr(" was developed by Steve Denson for Parallax Inc.<br/><br/>")+ASideGuiKey+
@@ -5485,6 +5365,7 @@ void MainSpinWindow::helpShow()
 
 void MainSpinWindow::buildRescueShow()
 {
+    getRescueDialog();
     if(compileStatus->toPlainText().length() > 0) {
         rescueDialog->setEditText(compileStatus->toPlainText());
     }
@@ -5573,7 +5454,7 @@ void MainSpinWindow::setCurrentPort(int index)
     if(portName.length()) {
         if(portName.compare(AUTO_PORT) != 0) {
 #ifdef ENUM_INIT_PORTNAME
-            portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));  // signals get hooked up internally
+            portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));  // signals get hooked up internally
 #endif
         }
     }
@@ -5910,8 +5791,16 @@ int  MainSpinWindow::runBuild(QString option)
     status->setMaximumWidth(maxw);
 
     statusDialog->init("Build", "Building Propeller application.");
-    int rc = builder->runBuild(option, projectFile, aSideCompiler);
+    BuildTrace::clear();
+    int rc;
+    {
+        TraceSpan span("build", "build");
+        span.setArg("project", projectFile);
+        rc = builder->runBuild(option, projectFile, aSideCompiler);
+        span.setArg("exit", rc);
+    }
     statusDialog->stop();
+    BuildTrace::save(BuildTrace::traceFile(sourcePath(projectFile)));
 
     return rc;
 }
@@ -6093,7 +5982,11 @@ int  MainSpinWindow::runLoader(QString copts)
 
     QStringList args = getLoaderParameters(copts, file);
 
-    portName = serialPort();
+    {
+        TraceSpan span("find port", "loader");
+        portName = serialPort();
+        span.setArg("port", portName);
+    }
     if(portName.compare(AUTO_PORT) == 0) {
         compileStatus->appendPlainText("error: Propeller not found on any port.");
         return 1;
@@ -6167,6 +6060,8 @@ int  MainSpinWindow::runLoader(QString copts)
 
     portListener->close();
 
+    TraceSpan span("load", "loader");
+    span.setArg("args", args.join(" "));
     process->start(aSideLoader,args);
     compileStatus->insertPlainText("\n");
 
@@ -6205,7 +6100,12 @@ int  MainSpinWindow::runLoader(QString copts)
         this->enumeratePorts();
     }
     progress->hide();
-    return process->exitCode() | killed;
+
+    int rc = process->exitCode() | killed;
+    span.setArg("exit", rc);
+    span.finish();
+    BuildTrace::save(BuildTrace::traceFile(sourcePath(projectFile)));
+    return rc;
 }
 
 void MainSpinWindow::compilerError(QProcess::ProcessError error)
@@ -6719,6 +6619,66 @@ void MainSpinWindow::spinStatusClicked(QString line)
     }
 }
 
+/*
+ * Open the file of a parsed compiler message at its line.
+ */
+bool MainSpinWindow::showDiagnostic(const Diagnostic &diag)
+{
+    int n = 0;
+    QString file = diag.file;
+#ifdef SPIN
+    if(isSpinProject() && file.contains(SPIN_EXTENSION, Qt::CaseInsensitive) == false)
+        file += SPIN_EXTENSION;
+#endif
+    QString name = QFileInfo(file).fileName();
+
+    /* open file in tab if not there already */
+    for(n = 0; n < editorTabs->count();n++) {
+        if(editorTabs->tabText(n).indexOf(name) == 0) {
+            editorTabs->setCurrentIndex(n);
+            break;
+        }
+        if(editors->at(n)->toolTip().endsWith(file)) {
+            editorTabs->setCurrentIndex(n);
+            break;
+        }
+    }
+
+    if(n > editorTabs->count()-1) {
+        if(QFile::exists(file)) {
+            openFileName(file);
+        }
+        else
+        if(QFile::exists(sourcePath(projectFile)+file)) {
+            openFileName(sourcePath(projectFile)+file);
+        }
+        else {
+            return false;
+        }
+    }
+
+    Editor *editor = editors->at(editorTabs->currentIndex());
+    if(editor == NULL)
+        return false;
+
+    QTextCursor c = editor->textCursor();
+    c.movePosition(QTextCursor::Start);
+    if(diag.line > 0) {
+        c.movePosition(QTextCursor::Down,QTextCursor::MoveAnchor,diag.line-1);
+        c.movePosition(QTextCursor::StartOfLine);
+        c.movePosition(QTextCursor::EndOfLine,QTextCursor::KeepAnchor,1);
+    }
+    editor->setTextCursor(c);
+    editor->setFocus();
+
+    c.movePosition(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
+    editor->setTextCursor(c);
+
+    // highlight error
+    emit highlightCurrentLine(QColor(255, 255, 0));
+    return true;
+}
+
 /*
  * Find error or warning in a file
  */
@@ -6738,6 +6698,16 @@ void MainSpinWindow::compileStatusClicked(void)
     compileStatus->setTextCursor(cur);
     line = cur.selectedText();
 
+    /* messages recorded during the build don't need parsing again */
+    if(builder != NULL) {
+        DiagnosticModel *model = builder->diagnosticModel();
+        int row = model->findStatusLine(cur.blockNumber());
+        if(row > -1 && line.contains(model->at(row).message) && showDiagnostic(model->at(row))) {
+            compileStatusClickEnable = true;
+            return;
+        }
+    }
+
     if(isCProject()) {
         cStatusClicked(line);
     }
@@ -6760,6 +6730,13 @@ void MainSpinWindow::showCompileStatusError()
     showStatusPane(true);
     btnShowStatusPane->setChecked(true);
 
+    if(builder != NULL) {
+        DiagnosticModel *model = builder->diagnosticModel();
+        int row = model->firstError();
+        if(row > -1 && showDiagnostic(model->at(row)))
+            return;
+    }
+
     // find first error line
     QTextDocument *doc = compileStatus->document();
 
@@ -7835,10 +7812,7 @@ void MainSpinWindow::findChip()
 
     compileStatus->setPlainText("Identifying Propellers ...\n");
 
-    if(rtsReset())
-        propId.setRtsReset();
-    else
-        propId.setDtrReset();
+    propProbe->setResetType(rtsReset() ? PropellerID::RESET_BY_RTS : PropellerID::RESET_BY_DTR);
 
     int indx = cbPort->currentIndex();
     this->enumeratePorts();
@@ -7846,14 +7820,18 @@ void MainSpinWindow::findChip()
     if(indx < size)
         cbPort->setCurrentIndex(indx);
 
+    QStringList ports;
     for (int n = 1; n < size; n++) {
-        QString mp;
-        mp = cbPort->itemText(n);
-        int rc = propId.isDevice(mp);
-        if(rc < 0) {
+        ports.append(cbPort->itemText(n));
+    }
+
+    QList<PropellerProbeResult> results = propProbe->probeAll(ports);
+    foreach(PropellerProbeResult result, results) {
+        QString mp = result.portName;
+        if(result.status < 0) {
             compileStatus->appendPlainText("  Port "+mp+" is busy.");
-        } else if(rc > 0) {
-            compileStatus->appendPlainText("  Propeller found on "+mp+".");
+        } else if(result.status > 0) {
+            compileStatus->appendPlainText("  Propeller found on "+mp+QString(" version %1.").arg(result.version));
         } else {
             compileStatus->appendPlainText("  Propeller not found on "+mp+".");
         }
@@ -7864,23 +7842,21 @@ QString MainSpinWindow::serialPort()
 {
     int portIndex = cbPort->currentIndex();
     if(cbPort->currentText().compare(AUTO_PORT) == 0) {
-        if(rtsReset())
-            propId.setRtsReset();
-        else
-            propId.setDtrReset();
+        propProbe->setResetType(rtsReset() ? PropellerID::RESET_BY_RTS : PropellerID::RESET_BY_DTR);
 
         //compileStatus->setPlainText("Finding first available propeller ... ");
         int size = cbPort->count();
 
+        QStringList ports;
         for (int n = 1; n < size; n++) {
-            QString mp;
-            mp = cbPort->itemText(n);
-            int rc = propId.isDevice(mp);
-            if(rc > 0) {
-                //compileStatus->appendPlainText("Propeller found on "+mp+".");
+            ports.append(cbPort->itemText(n));
+        }
+        PropellerProbeResult result = propProbe->probeFirst(ports);
+        if(result.status > 0) {
+            //compileStatus->appendPlainText("Propeller found on "+result.portName+".");
+            int n = cbPort->findText(result.portName);
+            if(n > 0)
                 portIndex = n;
-                break;
-            }
         }
     }
     return(cbPort->itemText(portIndex));
@@ -7939,7 +7915,7 @@ void MainSpinWindow::enumeratePortsEvent()
                     lastCbPort = lastTermPort;
                     // make sure we are using lastTermport
 #ifdef ENUM_INIT_LASTTERMPORT
-                    portListener->init(lastTermPort,portListener->getBaudRate(), getWxPortIpAddr(serialPort()));
+                    portListener->init(lastTermPort,portListener->getBaudRate(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
 #endif
                     // reopen port with connect button
                     btnConnected->setChecked(true);
@@ -7953,7 +7929,7 @@ void MainSpinWindow::enumeratePortsEvent()
                                 cbPort->setCurrentIndex(n);
                                 // make sure we are using lastCbPort
 #ifdef ENUM_INIT_LASTCBPORT
-                                portListener->init(lastCbPort,portListener->getBaudRate(), getWxPortIpAddr(serialPort()));
+                                portListener->init(lastCbPort,portListener->getBaudRate(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
 #endif
                                 term->setLastConnectedPortName(lastCbPort);
                                 break;
@@ -8000,77 +7976,116 @@ QString MainSpinWindow::getWxPortIpAddr(QString wxname)
     return "";
 }
 
-#ifdef ESP8266_MODULE
-QList<WxPortInfo> MainSpinWindow::getWxPorts(void)
+bool MainSpinWindow::isXBeePort(QString wxname)
 {
-    QStringList args;
-    args.append("-W");
-
-    wxProcess->setProperty("Name", QVariant(aSideLoader));
-    wxProcess->setProperty("IsLoader", QVariant(true));
-
-    wxProcess->setProcessChannelMode(QProcess::MergedChannels);
-    //wxProcess->setWorkingDirectory(sourcePath(fileName));
-
-    procMutex.lock();
-    procDone = false;
-    procMutex.unlock();
-
-    wxPortString = "";
-    wxPorts.clear();
-
-    statusDialog->init("Searching", "Searching for ports");
-
-    qDebug() << aSideLoader << args;
-
-    wxProcess->start(aSideLoader, args);
-
-    while(procDone == false)
-        QApplication::processEvents();
-
-    statusDialog->stop();
-
-    //QString output = wxProcess->readAllStandardOutput();
-    //qDebug() << output;
-    return wxPorts;
+    foreach (WxPortInfo info, wxPorts) {
+        if(info.portName.compare(wxname) == 0) {
+            return info.VendorName.compare("XBee") == 0;
+        }
+    }
+    return false;
 }
-#else
+
+/*
+ * Returns the cached WX modules right away and starts a new discovery.
+ * Modules that answer later are added by wxPortsChanged.
+ */
 QList<WxPortInfo> MainSpinWindow::getWxPorts(void)
 {
-    QStringList args;
-    args.append("-X");
-
-    wxProcess->setProperty("Name", QVariant(aSideLoader));
-    wxProcess->setProperty("IsLoader", QVariant(true));
-
-    wxProcess->setProcessChannelMode(QProcess::MergedChannels);
-    //wxProcess->setWorkingDirectory(sourcePath(fileName));
-
-    procMutex.lock();
-    procDone = false;
-    procMutex.unlock();
+    wxPorts = wxDiscovery->ports();
+    wxDiscovery->discover();
+    return wxPorts;
+}
 
-    wxPortString = "";
-    wxPorts.clear();
+void MainSpinWindow::wxPortsChanged()
+{
+    QList<WxPortInfo> ports = wxDiscovery->ports();
+    QList<WxPortInfo> kept;
 
-    statusDialog->init("Searching", "Searching for ports");
+    foreach (WxPortInfo wx, wxPorts) {
+        bool found = false;
+        foreach (WxPortInfo info, ports) {
+            if (info.portName.compare(wx.portName) == 0) {
+                found = true;
+                break;
+            }
+        }
+        if (found)
+            continue;
+        int index = cbPort->findText(wx.portName);
+        if (index < 0)
+            continue;
+        // don't pull the port out from under an open terminal; drop it once it isn't current
+        if (index == cbPort->currentIndex()) {
+            kept.append(wx);
+            continue;
+        }
+        cbPort->removeItem(index);
+        if (index < friendlyPortName.count())
+            friendlyPortName.removeAt(index);
+    }
+    foreach (WxPortInfo wx, ports) {
+        if (cbPort->findText(wx.portName) > -1) {
+            continue;
+        }
+        friendlyPortName.append(wx.portName);
+        cbPort->addItem(wx.portName);
+    }
+    wxPorts = ports + kept;
 
-    qDebug() << aSideLoader << args;
+    if(cbPort->count()) {
+        btnConnected->setCheckable(true);
+    }
+}
 
-    wxProcess->start(aSideLoader, args);
+/*
+ * Enumerates serial ports off the GUI thread at startup.
+ */
+class PortScan : public QRunnable
+{
+public:
+    PortScan(QList<QextPortInfo> *ports, QObject *receiver)
+        : ports(ports), receiver(receiver) { }
+    void run() {
+        *ports = QextSerialEnumerator::getPorts();
+        QMetaObject::invokeMethod(receiver, "startupPortsReady", Qt::QueuedConnection);
+    }
+private:
+    QList<QextPortInfo> *ports;
+    QObject             *receiver;
+};
 
-    while(procDone == false)
-        QApplication::processEvents();
+void MainSpinWindow::startupPortsReady()
+{
+    listPorts(startupPorts);
+    startupPorts.clear();
 
-    statusDialog->stop();
+    /* setup the first port displayed in the combo box */
+    if(cbPort->count() > 0) {
+        int ndx = 0;
+        if(portName.length() != 0) {
+            for(int n = cbPort->count()-1; n > -1; n--)
+                if(cbPort->itemText(n) == portName)
+                {
+                    ndx = n;
+                    break;
+                }
+        }
+        setCurrentPort(ndx);
+    }
 
-    //QString output = wxProcess->readAllStandardOutput();
-    //qDebug() << output;
-    return wxPorts;
+    portConnectionMonitor = new PortConnectionMonitor();
+    connect(portConnectionMonitor, SIGNAL(portChanged()), propProbe, SLOT(invalidate()));
+    connect(portConnectionMonitor, SIGNAL(portChanged()), this, SLOT(enumeratePortsEvent()));
+    StartupTimer::mark("ports");
 }
-#endif
 
 void MainSpinWindow::enumeratePorts()
+{
+    listPorts(QextSerialEnumerator::getPorts());
+}
+
+void MainSpinWindow::listPorts(QList<QextPortInfo> ports)
 {
     int lastIndex = cbPort->currentIndex();
 
@@ -8088,7 +8103,6 @@ void MainSpinWindow::enumeratePorts()
 #ifdef ENABLE_AUTO_PORT
     friendlyPortName.append(AUTO_PORT);
 #endif
-    QList<QextPortInfo> ports = QextSerialEnumerator::getPorts();
     QStringList stringlist;
     QString name;
     stringlist << "List of ports:";
@@ -8214,7 +8228,7 @@ void MainSpinWindow::connectButton()
         term->setPortName(portName);
         term->activateWindow();
         term->getEditor()->setFocus();
-        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));
+        portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
         portListener->open();
         cbPort->setEnabled(false);
     }
@@ -8237,7 +8251,7 @@ void MainSpinWindow::menuActionConnectButton()
 void MainSpinWindow::portRename()
 {
     bool ok;
-    if (getWxPortIpAddr(cbPort->currentText()).length() == 0) {
+    if (getWxPortIpAddr(cbPort->currentText()).length() == 0 || isXBeePort(cbPort->currentText())) {
         QMessageBox::warning(this, tr("Can't Rename Port"), tr("Can only rename WX ports."));
         return;
     }
@@ -8322,7 +8336,7 @@ void MainSpinWindow::portResetButton()
         portListener->close();
         runLoader("-R");
         if (isopen) {
-            portListener->init(savePortName, term->getBaud(), getWxPortIpAddr(savePortName));
+            portListener->init(savePortName, term->getBaud(), getWxPortIpAddr(savePortName), isXBeePort(savePortName));
             portListener->open();
         }
     }
@@ -8331,7 +8345,7 @@ void MainSpinWindow::portResetButton()
         {
             if(savePortName.compare(portName) != 0) {
 #ifdef ENUM_INIT_PORTNAME
-                portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()));
+                portListener->init(portName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
 #endif
             }
 
@@ -8341,7 +8355,7 @@ void MainSpinWindow::portResetButton()
 
             if(savePortName.compare(portName) != 0) {
 #ifdef ENUM_INIT_PORTNAME
-                portListener->init(savePortName, term->getBaud(), getWxPortIpAddr(serialPort()));
+                portListener->init(savePortName, term->getBaud(), getWxPortIpAddr(serialPort()), isXBeePort(serialPort()));
 #endif
             }
         }
@@ -8417,15 +8431,19 @@ void MainSpinWindow::reloadBoardTypes()
 
 void MainSpinWindow::initBoardTypes()
 {
-    int boardIndex = cbBoard->currentIndex();
-    cbBoard->clear();
-
     QFile file;
     if(file.exists(aSideCfgFile))
     {
         /* load boards in case there were changes */
         aSideConfig->loadBoards(aSideCfgFile);
     }
+    fillBoardTypes();
+}
+
+void MainSpinWindow::fillBoardTypes()
+{
+    int boardIndex = cbBoard->currentIndex();
+    cbBoard->clear();
 
     /* get board types */
     QStringList boards = aSideConfig->getBoardNames();
@@ -8689,6 +8707,7 @@ void MainSpinWindow::setupFileMenu()
     programMenu->addAction(QIcon(":/images/console.png"), tr("Open Terminal"), this, SLOT(menuActionConnectButton()));
     programMenu->addAction(QIcon(":/images/reset.png"), tr("Reset Port"), this, SLOT(portResetButton()));
     programMenu->addAction(tr(BuildAllLibraries), this, SLOT(programBuildAllLibraries()), Qt::CTRL+Qt::ALT+Qt::Key_F12);
+    programMenu->addAction(tr(CleanAllOutputs), this, SLOT(programCleanAllOutputs()));
 
 #if defined(GDBENABLE)
     QMenu *debugMenu = new QMenu(tr("&Debug"), this);
@@ -9037,7 +9056,7 @@ void MainSpinWindow::showSimpleView(bool simple)
         foreach(QAction *pa, progMenuList) {
             QString txt = pa->text();
             if(txt != NULL) {
-                if(txt.contains(BuildAllLibraries))
+                if(txt.contains(BuildAllLibraries) || txt.contains(CleanAllOutputs))
                    pa->setVisible(false);
             }
         }
@@ -9104,7 +9123,7 @@ void MainSpinWindow::showSimpleView(bool simple)
         foreach(QAction *pa, progMenuList) {
             QString txt = pa->text();
             if(txt != NULL) {
-                if(txt.contains(BuildAllLibraries))
+                if(txt.contains(BuildAllLibraries) || txt.contains(CleanAllOutputs))
                    pa->setVisible(true);
             }
         }
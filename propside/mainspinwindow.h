@@ -36,6 +36,7 @@
 #include "treemodel.h"
 #include "PortListener.h"
 #include "qextserialport.h"
+#include "qextserialenumerator.h"
 #include "xesp8266port.h"
 #include "terminal.h"
 #include "properties.h"
@@ -59,10 +60,13 @@
 #include "buildspin.h"
 #include "spinparser.h"
 #include "PropellerID.h"
+#include "PropellerProbe.h"
 #include "PortConnectionMonitor.h"
 #include "zipper.h"
 #include "StatusDialog.h"
 #include "rescuedialog.h"
+#include "wxdiscovery.h"
+#include "startuptimer.h"
 
 #ifdef QT5
 #include <QtPrintSupport/QPrinter>
@@ -75,14 +79,6 @@ QT_BEGIN_NAMESPACE
 class QTextEdit;
 QT_END_NAMESPACE
 
-struct WxPortInfo {
-    QString portName;   ///< Port name
-    QString VendorName; ///< Vendor name
-    QString ipAddr;     ///< IP Address
-    QString macUpper;   ///< MAC Addr upper
-    QString macAddr;    ///< MAC Address
-};
-
 //! [0]
 class MainSpinWindow : public QMainWindow
 {
@@ -109,6 +105,7 @@ public slots:
     void openTab();
     void newFile();
     void openFile(const QString &path = QString());
+    void openFileLine(QString fileName, int line);
     void saveFile();
     void saveEditor();
     void saveFileByTabIndex(int tab);
@@ -134,6 +131,8 @@ public slots:
     void closeProject();
     void zipProject();
     void aboutShow();
+    void startupTimingShow();
+    void helpSearchShow();
     void creditShow();
     void helpShow();
     void libraryShow();
@@ -168,6 +167,7 @@ public slots:
     void propertiesAccepted();
 
     void programBuildAllLibraries();
+    void programCleanAllOutputs();
     void programStopBuild();
     void programBuild();
     void programBurnEE();
@@ -201,11 +201,15 @@ public slots:
 
     QList<WxPortInfo> getWxPorts(void);
     QString getWxPortIpAddr(QString wxname);
+    bool    isXBeePort(QString wxname);
+    void wxPortsChanged();
 
     void enumeratePorts();
     void enumeratePortsEvent();
+    void startupPortsReady();
     void reloadBoardTypes();
     void initBoardTypes();
+    void fillBoardTypes();
 
     void addProjectFile();
     void addProjectLibFile();
@@ -241,11 +245,6 @@ public slots:
     void procReadyRead();
     void procReadyReadCat();
 
-    void wxProcReadyRead(void);
-    void wxProcReadyLoad(void);
-    void wxProcError(QProcess::ProcessError error);
-    void wxProcFinished(int exitCode, QProcess::ExitStatus exitStatus);
-
     void setCurrentFile(const QString &fileName);
     void updateRecentFileActions();
     void openRecentFile();
@@ -292,6 +291,10 @@ private:
     int tabIndexByFileName(QString filename);
     void exitSave();
     void getApplicationSettings();
+    void listPorts(QList<QextPortInfo> ports);
+    NewProject *getNewProjDialog();
+    ReplaceDialog *getReplaceDialog();
+    RescueDialog *getRescueDialog();
     int  checkCompilerInfo();
     bool isSpinProject();
     bool isCProject();
@@ -348,6 +351,7 @@ private:
 
     void cStatusClicked(QString line);
     void spinStatusClicked(QString line);
+    bool showDiagnostic(const Diagnostic &diag);
 
     void resetVerticalSplitSize();
     void resetRightSplitSize();
@@ -362,7 +366,7 @@ private:
 
     Help            *helpDialog;
 
-    QSettings       *settings;
+    SettingsCache   *settings;
     QString         aSideLoader;
     QString         aSideCompiler;
     QString         aSideCompilerPath;
@@ -502,8 +506,10 @@ private:
     Blinker         *blinker;
 
     PropellerID     propId;
+    PropellerProbe  *propProbe;
 
     PortConnectionMonitor *portConnectionMonitor;
+    QList<QextPortInfo> startupPorts;
 
     StatusDialog    *statusDialog;
     Zipper          zipper;
@@ -516,8 +522,7 @@ private:
     QPrinter        printer;
 
     QList<WxPortInfo> wxPorts;
-    QProcess        *wxProcess;
-    QString         wxPortString;
+    WxDiscovery     *wxDiscovery;
 
 public slots:
     void ideDebugShow();
@@ -119,8 +119,8 @@ void NewProject::nameChanged()
 
 QString NewProject::getCurrentPath()
 {
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    QVariant  lastfile = settings.value(gccWorkspaceKey);
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant  lastfile = settings->value(gccWorkspaceKey);
     QString userpath("");
     if(lastfile.canConvert(QVariant::String)) {
         userpath = lastfile.toString();
@@ -165,8 +165,8 @@ void NewProject::browsePath()
             mypath += "\\";
     }
     path->setText(mypath+name->text());
-    QSettings settings(publisherKey, ASideGuiKey, this);
-    settings.setValue(gccWorkspaceKey,mypath);
+    SettingsCache *settings = SettingsCache::instance();
+    settings->setValue(gccWorkspaceKey,mypath);
     int fontSize = path->fontInfo().pixelSize();
     setMinimumWidth(mypath.length()*fontSize+100);
     qDebug() << "New Project Folder " << mypath << name->text();
@@ -0,0 +1,226 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "objectcache.h"
+#include "directory.h"
+
+#if defined(Q_OS_WIN32)
+#include <windows.h>
+#include <sys/utime.h>
+#else
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#define OBJECTCACHE_VERSION "2"
+
+ObjectCache::ObjectCache()
+{
+    maxSize = 256*1024*1024;
+    storedSize = 0;
+    hits = 0;
+    misses = 0;
+}
+
+QString ObjectCache::defaultDirectory()
+{
+    return Directory::cacheLocation("objcache/");
+}
+
+void ObjectCache::setDirectory(QString dir)
+{
+    cacheDir = QDir::fromNativeSeparators(dir);
+    if(cacheDir.length() > 0 && !cacheDir.endsWith("/"))
+        cacheDir += "/";
+    if(cacheDir.length() > 0 && !QDir(cacheDir).exists()) {
+        if(!QDir().mkpath(cacheDir))
+            cacheDir = "";
+    }
+}
+
+/*
+ * Compilers are identified by path, size and modification time,
+ * so reinstalling a toolchain invalidates old entries.
+ */
+QString ObjectCache::compilerIdentity(QString compiler)
+{
+    QFileInfo info(compiler);
+    return QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+            .arg(info.lastModified().toTime_t());
+}
+
+QString ObjectCache::key(QString compilerId, QString model, QStringList flags, const QByteArray &source)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(OBJECTCACHE_VERSION);
+    hash.addData(compilerId.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(model.toUtf8());
+    hash.addData("\0", 1);
+    foreach(QString flag, flags) {
+        hash.addData(flag.toUtf8());
+        hash.addData("\0", 1);
+    }
+    hash.addData(source);
+    return QString(hash.result().toHex());
+}
+
+QString ObjectCache::entryPath(QString key)
+{
+    return cacheDir+key.left(2)+"/"+key.mid(2)+".o";
+}
+
+/*
+ * Compiler messages of an entry live beside its object.
+ */
+QString ObjectCache::outputPath(QString entry)
+{
+    return entry.left(entry.length()-2)+".out";
+}
+
+void ObjectCache::touch(QString path)
+{
+#if defined(Q_OS_WIN32)
+    _wutime((const wchar_t *)QDir::toNativeSeparators(path).utf16(), NULL);
+#else
+    utime(QFile::encodeName(path).constData(), NULL);
+#endif
+}
+
+/*
+ * A hard link costs nothing; copy when the cache is on another volume.
+ * The destination is always removed first so a later compile writes
+ * a new file instead of truncating the shared one.
+ */
+bool ObjectCache::linkOrCopy(QString src, QString dest)
+{
+    if(QFile::exists(dest) && !QFile::remove(dest))
+        return false;
+#if defined(Q_OS_WIN32)
+    if(CreateHardLinkW((LPCWSTR)QDir::toNativeSeparators(dest).utf16(),
+                       (LPCWSTR)QDir::toNativeSeparators(src).utf16(), NULL))
+        return true;
+#else
+    if(::link(QFile::encodeName(src).constData(), QFile::encodeName(dest).constData()) == 0)
+        return true;
+#endif
+    return QFile::copy(src, dest);
+}
+
+bool ObjectCache::fetch(QString key, QString dest, QByteArray *output)
+{
+    if(!isEnabled())
+        return false;
+    QString path = entryPath(key);
+    if(!QFile::exists(path) || !linkOrCopy(path, dest)) {
+        misses++;
+        return false;
+    }
+    touch(path);
+    if(output) {
+        QFile file(outputPath(path));
+        if(file.open(QFile::ReadOnly)) {
+            *output = file.readAll();
+            file.close();
+        }
+        else {
+            output->clear();
+        }
+    }
+    hits++;
+    return true;
+}
+
+/*
+ * Entries are copied in under a temporary name and renamed so a
+ * concurrent reader never sees a partial object. Compiler output is
+ * written first, so an object is never found without its messages.
+ */
+bool ObjectCache::store(QString key, QString src, const QByteArray &output)
+{
+    if(!isEnabled())
+        return false;
+    QString path = entryPath(key);
+    if(QFile::exists(path))
+        return true;
+    QDir().mkpath(cacheDir+key.left(2));
+
+    QString tmp = path+QString(".%1.tmp").arg(QCoreApplication::applicationPid());
+    QString out = outputPath(path);
+    QFile::remove(out);
+    if(output.length() > 0) {
+        QFile file(tmp);
+        if(!file.open(QFile::WriteOnly | QFile::Truncate))
+            return false;
+        bool ok = file.write(output) == output.length();
+        file.close();
+        if(!ok || !QFile::rename(tmp, out)) {
+            QFile::remove(tmp);
+            return false;
+        }
+    }
+    QFile::remove(tmp);
+    if(!QFile::copy(src, tmp))
+        return false;
+    if(!QFile::rename(tmp, path)) {
+        QFile::remove(tmp);
+        return QFile::exists(path);
+    }
+    storedSize += QFileInfo(path).size();
+    return true;
+}
+
+static bool olderFirst(const QFileInfo &a, const QFileInfo &b)
+{
+    return a.lastModified() < b.lastModified();
+}
+
+/*
+ * Drop least recently used entries until the cache is within maxSize.
+ * Called once per build; the directory is only scanned when something
+ * was stored since the last trim.
+ */
+void ObjectCache::trim()
+{
+    if(!isEnabled() || storedSize == 0)
+        return;
+    storedSize = 0;
+
+    QList<QFileInfo> entries;
+    qint64 total = 0;
+    QDirIterator it(cacheDir, QStringList() << "*.o", QDir::Files, QDirIterator::Subdirectories);
+    while(it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        entries.append(info);
+        total += info.size();
+    }
+    if(total <= maxSize)
+        return;
+
+    qSort(entries.begin(), entries.end(), olderFirst);
+    foreach(QFileInfo info, entries) {
+        if(total <= maxSize*9/10)
+            break;
+        if(QFile::remove(info.absoluteFilePath())) {
+            total -= info.size();
+            QFile::remove(outputPath(info.absoluteFilePath()));
+        }
+    }
+}
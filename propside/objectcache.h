@@ -0,0 +1,66 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTCACHE_H
+#define OBJECTCACHE_H
+
+#include "qtversion.h"
+
+/*
+ * Compiled object cache shared by all projects.
+ * Entries are keyed by a hash of the preprocessed source, the compiler
+ * identity, the memory model and the flags, and are evicted least
+ * recently used first once the cache grows past its size limit.
+ */
+class ObjectCache
+{
+public:
+    ObjectCache();
+
+    void    setDirectory(QString dir);
+    QString directory() const { return cacheDir; }
+    void    setMaxSize(qint64 bytes) { maxSize = bytes; }
+    bool    isEnabled() const { return !cacheDir.isEmpty(); }
+
+    static QString defaultDirectory();
+    static QString compilerIdentity(QString compiler);
+
+    QString key(QString compilerId, QString model, QStringList flags, const QByteArray &source);
+    bool    fetch(QString key, QString dest, QByteArray *output = 0);
+    bool    store(QString key, QString src, const QByteArray &output = QByteArray());
+    void    trim();
+
+    void    resetStats() { hits = 0; misses = 0; }
+    int     hitCount() const { return hits; }
+    int     missCount() const { return misses; }
+
+private:
+    QString entryPath(QString key);
+    static QString outputPath(QString entry);
+    bool    linkOrCopy(QString src, QString dest);
+    void    touch(QString path);
+
+    QString cacheDir;
+    qint64  maxSize;
+    qint64  storedSize;
+    int     hits;
+    int     misses;
+};
+
+#endif // OBJECTCACHE_H
@@ -19,6 +19,7 @@
 
 #include "properties.h"
 #include "directory.h"
+#include "treecopy.h"
 #include "zipper.h"
 
 #include <QDir>
@@ -39,9 +40,9 @@ Properties::Properties(QWidget *parent) : QDialog(parent)
 {
     this->setWindowTitle(QString(ASideGuiKey)+tr(" Properties"));
 
-    QSettings settings(publisherKey, ASideGuiKey);
-    //QStringList list = settings.allKeys();
-    settings.setValue(useKeys,1);
+    SettingsCache *settings = SettingsCache::instance();
+    //QStringList list = settings->allKeys();
+    settings->setValue(useKeys,1);
 
     statDialog = new StatusDialog(this);
 
@@ -65,19 +66,19 @@ Properties::Properties(QWidget *parent) : QDialog(parent)
 
 void Properties::cleanSettings()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    QStringList list = settings.allKeys();
+    SettingsCache *settings = SettingsCache::instance();
+    QStringList list = settings->allKeys();
 
     foreach(QString key, list) {
         if(key.indexOf(ASideGuiKey) == 0) {
-            settings.remove(key);
+            settings->remove(key);
         }
     }
 
     // mac doesn't filter settings by publisher, etc...
-    //settings.setValue(useKeys,1);
-    //list = settings.allKeys(); // debug only
-    settings.setValue(useKeys,0);
+    //settings->setValue(useKeys,1);
+    //list = settings->allKeys(); // debug only
+    settings->setValue(useKeys,0);
 }
 
 int highlightIndex = 0;
@@ -142,7 +143,7 @@ void Properties::setupFolders()
  */
 QString Properties::getApplicationWorkspace()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
 
     /*
      * By convention in Windows we keep a SimpleIDE workspace in
@@ -156,7 +157,7 @@ QString Properties::getApplicationWorkspace()
 #elif defined(Q_OS_MAC)
     pkwrk = QApplication::applicationDirPath()+"/";
 #else
-    QVariant compv  = settings.value(gccCompilerKey, pkwrk);
+    QVariant compv  = settings->value(gccCompilerKey, pkwrk);
     if(compv.canConvert(QVariant::String)) {
         QString s = compv.toString();
         s = s.mid(0,s.lastIndexOf("/")+1);
@@ -165,21 +166,21 @@ QString Properties::getApplicationWorkspace()
 #endif
     pkwrk += "../Workspace/";
 
-    QVariant pkgv  = settings.value(packageKey, pkwrk);
+    QVariant pkgv  = settings->value(packageKey, pkwrk);
     if(pkgv.canConvert(QVariant::String)) {
         QString s = pkgv.toString();
         if(s.length() > 0)
-            settings.setValue(packageKey, s);
+            settings->setValue(packageKey, s);
     }
     else {
-        settings.setValue(packageKey,pkwrk);
+        settings->setValue(packageKey,pkwrk);
     }
     return pkwrk;
 }
 
 void Properties::setupPropGccWorkspace()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
 
     QString pkwrk = this->getApplicationWorkspace();
 
@@ -211,7 +212,7 @@ void Properties::setupPropGccWorkspace()
         qDebug() << wtime.date() << wtime.time() << wtime.toMSecsSinceEpoch();
 
         bool keepwrk = false;
-        QVariant keep = settings.value(keepOldWorkspaceKey, false);
+        QVariant keep = settings->value(keepOldWorkspaceKey, false);
         if(keep.canConvert(QVariant::Bool)) {
             keepwrk = keep.toBool();
         }
@@ -247,7 +248,7 @@ void Properties::setupPropGccWorkspace()
                         QApplication::processEvents();
                     }
                 } else {
-                    settings.setValue(keepOldWorkspaceKey, true);
+                    settings->setValue(keepOldWorkspaceKey, true);
                 }
             } else {
                 qDebug() << pkwrk << "is older";
@@ -256,7 +257,7 @@ void Properties::setupPropGccWorkspace()
     }
 #endif
 
-    QVariant wrkrv = settings.value(gccWorkspaceKey);
+    QVariant wrkrv = settings->value(gccWorkspaceKey);
     QString wrkreg;
 
     if(wrkrv.canConvert(QVariant::String)) {
@@ -277,7 +278,7 @@ void Properties::setupPropGccWorkspace()
     }
 
 
-    QVariant librv = settings.value(gccLibraryKey);
+    QVariant librv = settings->value(gccLibraryKey);
     QString libreg;
 
     QString mylib;
@@ -299,8 +300,8 @@ void Properties::setupPropGccWorkspace()
         qDebug() << "Default simple library path not found.";
     }
 
-    QVariant libv  = settings.value(gccLibraryKey, mylib);
-    QVariant wrkv  = settings.value(gccWorkspaceKey, mywrk);
+    QVariant libv  = settings->value(gccLibraryKey, mylib);
+    QVariant wrkv  = settings->value(gccWorkspaceKey, mywrk);
 
     fileStringProperty(&wrkv,  leditGccWorkspace, gccWorkspaceKey, &mywrk);
     fileStringProperty(&libv,  leditGccLibrary,   gccLibraryKey,   &mylib);
@@ -308,13 +309,13 @@ void Properties::setupPropGccWorkspace()
     QString ledLib = leditGccLibrary->text();
     QString ledWrk = leditGccWorkspace->text();
 
-    settings.setValue(gccLibraryKey,leditGccLibrary->text());
-    settings.setValue(gccWorkspaceKey,leditGccWorkspace->text());
+    settings->setValue(gccLibraryKey,leditGccLibrary->text());
+    settings->setValue(gccWorkspaceKey,leditGccWorkspace->text());
 }
 
 void Properties::setupPropGccCompiler()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
     QString mygcc;
     QString apath = QApplication::applicationDirPath();
 
@@ -357,7 +358,7 @@ void Properties::setupPropGccCompiler()
 
 #endif
 
-    QVariant compv = settings.value(gccCompilerKey);
+    QVariant compv = settings->value(gccCompilerKey);
     QString gccreg;
 
     if(compv.canConvert(QVariant::String)) {
@@ -378,7 +379,7 @@ void Properties::setupPropGccCompiler()
         qDebug() << "Propeller GCC compiler path not found.";
     }
     fileStringProperty(&compv, leditGccCompiler,  gccCompilerKey,  &mygcc);
-    settings.setValue(gccCompilerKey,mygcc);
+    settings->setValue(gccCompilerKey,mygcc);
 }
 
 void Properties::showStatusDialog(QString title, const QString text)
@@ -393,6 +394,18 @@ void Properties::stopStatusDialog()
     statDialog->stop(4);
 }
 
+void Properties::copyWorkspace(QString src, QString dst)
+{
+    TreeCopy copier;
+    connect(&copier, SIGNAL(progress(int,int)), this, SLOT(copyProgress(int,int)));
+    copier.copy(src, dst);
+}
+
+void Properties::copyProgress(int done, int total)
+{
+    statDialog->setMessage(tr("Copying %1 of %2 files.").arg(done).arg(total));
+}
+
 void Properties::saveUpdateFile(QString name, QString timestamp)
 {
     // create a timestamp file
@@ -417,7 +430,7 @@ bool Properties::createPackageWorkspace(QString pkwrk, QString &mywrk, QString u
 
         mywrk = wrk;
         mylib = wrk+LEARNLIB;
-        Directory::recursiveCopyDir(pkwrk, mywrk);
+        copyWorkspace(pkwrk, mywrk);
         saveUpdateFile(mywrk+updateFile, timestamp);
 
         stopStatusDialog();
@@ -491,13 +504,13 @@ bool Properties::updatePackageWorkspace(QString pkwrk, QString mywrk, QString up
         }
         if(!rc) {
 
-            Directory::recursiveCopyDir(mywrk, temp);
-            Directory::recursiveCopyDir(pkwrk, mywrk);
+            copyWorkspace(mywrk, temp);
+            copyWorkspace(pkwrk, mywrk);
 
             saveUpdateFile(mywrk+updateFile, timestamp);
 
-            QSettings settings(publisherKey, ASideGuiKey);
-            settings.setValue(keepOldWorkspaceKey, true);
+            SettingsCache *settings = SettingsCache::instance();
+            settings->setValue(keepOldWorkspaceKey, true);
 
             stopStatusDialog();
 
@@ -593,7 +606,7 @@ bool Properties::replaceLearnWorkspace()
 {
     bool retval = false;
 
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
 
     QString pkwrk = this->getApplicationWorkspace();
 
@@ -619,8 +632,8 @@ bool Properties::replaceLearnWorkspace()
     QString pklib;
     QVariant var;
 
-    QVariant libv  = settings.value(gccLibraryKey, mylib);
-    QVariant wrkv  = settings.value(gccWorkspaceKey, mywrk);
+    QVariant libv  = settings->value(gccLibraryKey, mylib);
+    QVariant wrkv  = settings->value(gccWorkspaceKey, mywrk);
 
     QString libs = libv.toString();
     QString wrks = wrkv.toString();
@@ -684,7 +697,7 @@ bool Properties::replaceLearnWorkspace()
         qDebug() << "mywrk" << wtime.date() << wtime.time() << wtime.toTime_t()*1000;
 
         bool keepwrk = false;
-        QVariant keep = settings.value(keepOldWorkspaceKey, false);
+        QVariant keep = settings->value(keepOldWorkspaceKey, false);
         if(keep.canConvert(QVariant::Bool)) {
             keepwrk = keep.toBool();
         }
@@ -713,8 +726,8 @@ bool Properties::replaceLearnWorkspace()
     else {
         fileStringProperty(&wrkv,  leditGccWorkspace, gccWorkspaceKey, &mywrk);
     }
-    settings.setValue(gccLibraryKey,leditGccLibrary->text());
-    settings.setValue(gccWorkspaceKey,leditGccWorkspace->text());
+    settings->setValue(gccLibraryKey,leditGccLibrary->text());
+    settings->setValue(gccWorkspaceKey,leditGccWorkspace->text());
 
     return retval;
 }
@@ -730,14 +743,14 @@ bool Properties::updateLearnWorkspace()
 
     QString mywrk;
 
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
 
     QDateTime dt = QDateTime::currentDateTime();
     QString timestamp = dt.toString(Qt::ISODate)+ "";
     timestamp = timestamp.replace(":","-");
     timestamp = timestamp.replace("T","_");
 
-    QVariant wrkv  = settings.value(gccWorkspaceKey, mywrk);
+    QVariant wrkv  = settings->value(gccWorkspaceKey, mywrk);
 
     QString  ws = wrkv.toString();
     if(ws.length() < 1) {
@@ -858,9 +871,9 @@ void Properties::setupSpinFolders()
     layout->addWidget(gbLibrary);
     layout->addWidget(gbWorkspace);
 
-    QSettings settings(publisherKey, ASideGuiKey,this);
+    SettingsCache *settings = SettingsCache::instance();
 
-    QVariant gv = settings.value(gccCompilerKey,"");
+    QVariant gv = settings->value(gccCompilerKey,"");
 
     QString mygcc = mypath+"bin/propeller-elf-gcc";
 #if defined(Q_OS_WIN32)
@@ -919,11 +932,11 @@ void Properties::setupSpinFolders()
     qDebug() << "Default Spin Library: ";
     qDebug() << mypath;
 
-    //QStringList list = settings.allKeys();
+    //QStringList list = settings->allKeys();
 
-    QVariant compv = settings.value(spinCompilerKey, myspin);
-    QVariant incv  = settings.value(spinLibraryKey, mylib);
-    QVariant wrkv  = settings.value(spinWorkspaceKey);
+    QVariant compv = settings->value(spinCompilerKey, myspin);
+    QVariant incv  = settings->value(spinLibraryKey, mylib);
+    QVariant wrkv  = settings->value(spinWorkspaceKey);
 
     fileStringProperty(&compv, leditSpinCompiler, spinCompilerKey, &myspin);
     fileStringProperty(&incv,  leditSpinLibrary,  spinLibraryKey,  &mylib);
@@ -947,7 +960,7 @@ void Properties::setupSpinFolders()
 
 void Properties::fileStringProperty(QVariant *var, QLineEdit *ledit, const char *key, QString *value)
 {
-    QSettings settings(publisherKey, ASideGuiKey,this);
+    SettingsCache *settings = SettingsCache::instance();
     if(var->canConvert(QVariant::String)) {
         QString s = var->toString();
         if(s.length() > 0) {
@@ -960,14 +973,14 @@ void Properties::fileStringProperty(QVariant *var, QLineEdit *ledit, const char
         }
         else {
             ledit->setText(*value);
-            settings.setValue(key,*value);
+            settings->setValue(key,*value);
             qDebug() << "Set Key Value " << key;
             qDebug() << *value;
         }
     }
     else {
         ledit->setText(*value);
-        settings.setValue(key,*value);
+        settings->setValue(key,*value);
         qDebug() << "Set Key Value " << key;
         qDebug() << *value;
     }
@@ -984,7 +997,7 @@ void Properties::setupGeneral()
     QVBoxLayout *glayout = new QVBoxLayout();
     tbox->setLayout(glayout);
 
-    QSettings settings(publisherKey, ASideGuiKey,this);
+    SettingsCache *settings = SettingsCache::instance();
     QVariant var;
 
     QGroupBox *gbLoader = new QGroupBox(tr("Loader Folder"), tbox);
@@ -1005,11 +1018,11 @@ void Properties::setupGeneral()
     if(QFile::exists(myloader))
         qDebug() << "Found Default Loader Path.";
 
-    QVariant loadv = settings.value(propLoaderKey, myloader);
+    QVariant loadv = settings->value(propLoaderKey, myloader);
 
     fileStringProperty(&loadv, leditLoader, propLoaderKey, &myloader);
 
-    settings.setValue(propLoaderKey, myloader);
+    settings->setValue(propLoaderKey, myloader);
 
     gbLoader->setLayout(ilayout);
 
@@ -1025,7 +1038,7 @@ void Properties::setupGeneral()
     tabSpaces.setAlignment(Qt::AlignHCenter);
     tlayout->addWidget(&tabSpaces,row++,1);
 
-    var = settings.value(tabSpacesKey);
+    var = settings->value(tabSpacesKey);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         tabSpaces.setText(s);
@@ -1038,7 +1051,7 @@ void Properties::setupGeneral()
     loadDelay.setAlignment(Qt::AlignHCenter);
     tlayout->addWidget(&loadDelay,row++,1);
 
-    var = settings.value(loadDelayKey);
+    var = settings->value(loadDelayKey);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         loadDelay.setText(s);
@@ -1052,7 +1065,7 @@ void Properties::setupGeneral()
     resetType.setCurrentIndex((int)DTR);
     tlayout->addWidget(&resetType,row++,1);
 
-    var = settings.value(resetTypeKey,(int)DTR);
+    var = settings->value(resetTypeKey,(int)DTR);
     if(var.canConvert(QVariant::Int)) {
         resetType.setCurrentIndex(var.toInt());
     }
@@ -1066,7 +1079,7 @@ void Properties::setupGeneral()
     // no more save autolib check
     autoLibCheck.setChecked(true);
 /*
-    var = settings.value(autoLibIncludeKey);
+    var = settings->value(autoLibIncludeKey);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         autoLibCheck.setChecked(var.toBool());
@@ -1077,7 +1090,7 @@ void Properties::setupGeneral()
     projectsCheck.setText(tr("View Mode"));
     projectsCheck.setToolTip(tr("Allow switching between Simple View and Project View modes."));
 
-    var = settings.value(allowProjectViewKey);
+    var = settings->value(allowProjectViewKey);
     if(!var.isNull() && var.canConvert(QVariant::Int)) {
         if(var.toInt() != 0) {
             projectsCheck.setChecked(true);
@@ -1117,8 +1130,8 @@ void Properties::setupGeneral()
 
 void Properties::allowProjects()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    settings.setValue(allowProjectViewKey,0);
+    SettingsCache *settings = SettingsCache::instance();
+    settings->setValue(allowProjectViewKey,0);
 
     if(projectsCheck.isChecked()) {
 /*
@@ -1131,8 +1144,8 @@ void Properties::allowProjects()
 
         if(s.compare("Arthur") == 0) {
             projectsCheck.setChecked(true);
-            settings.setValue(allowProjectViewKey,1);
-            settings.setValue(simpleViewKey, 0);
+            settings->setValue(allowProjectViewKey,1);
+            settings->setValue(simpleViewKey, 0);
             QMessageBox::information(this,
                 tr("Restart IDE"), tr("Please restart the IDE to enter Project View."));
         }
@@ -1140,7 +1153,7 @@ void Properties::allowProjects()
             projectsCheck.setChecked(false);
         }
  */
-        settings.setValue(allowProjectViewKey,1);
+        settings->setValue(allowProjectViewKey,1);
         emit enableProjectView(true);
     }
     else {
@@ -1158,7 +1171,7 @@ void Properties::setupOptional()
     QVBoxLayout *glayout = new QVBoxLayout();
     tbox->setLayout(glayout);
 
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
     QVariant var;
 
     QGroupBox *gbCompiler = new QGroupBox(tr("Spin Compiler"),tbox);
@@ -1166,7 +1179,7 @@ void Properties::setupOptional()
 
     QLabel *compLabel = new QLabel();
     // spin compiler either BSTC or Roy's SPIN compiler
-    var = settings.value(spinCompilerKey);
+    var = settings->value(spinCompilerKey);
     if(var.canConvert(QVariant::String)) {
         QString s = var.toString();
         if(s.length() > 0)
@@ -1186,7 +1199,7 @@ void Properties::setupOptional()
 
     QLabel *altTermLabel = new QLabel();
     // spin compiler either BSTC or Roy's SPIN compiler
-    var = settings.value(altTerminalKey);
+    var = settings->value(altTerminalKey);
     if(var.canConvert(QVariant::String)) {
         QString s = var.toString();
         if(s.length() > 0)
@@ -1248,7 +1261,7 @@ void Properties::setupHighlight()
         colorlist.append(static_cast<PColor*>(propertyColors[n])->getName());
     }
 
-    QSettings settings(publisherKey, ASideGuiKey);
+    SettingsCache *settings = SettingsCache::instance();
     QVariant var;
 
     int hlrow = 0;
@@ -1297,26 +1310,26 @@ void Properties::setupHighlight()
     hlNumColor.setCurrentIndex(PColor::Magenta);
     hlrow++;
 
-    var = settings.value(hlNumWeightKey,checkBold);
+    var = settings->value(hlNumWeightKey,checkBold);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlNumWeight.setChecked(var.toBool());
-        settings.setValue(hlNumWeightKey,var.toBool());
+        settings->setValue(hlNumWeightKey,var.toBool());
     }
 
-    var = settings.value(hlNumStyleKey,false);
+    var = settings->value(hlNumStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlNumStyle.setChecked(var.toBool());
-        settings.setValue(hlNumStyleKey,var.toBool());
+        settings->setValue(hlNumStyleKey,var.toBool());
     }
 
-    var = settings.value(hlNumColorKey,PColor::Magenta);
+    var = settings->value(hlNumColorKey,PColor::Magenta);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlNumColor.setCurrentIndex(n);
-        settings.setValue(hlNumColorKey,n);
+        settings->setValue(hlNumColorKey,n);
     }
 
     QLabel *lFuncStyle = new QLabel(tr("Functions"));
@@ -1332,26 +1345,26 @@ void Properties::setupHighlight()
     hlFuncColor.setCurrentIndex(PColor::Blue);
     hlrow++;
 
-    var = settings.value(hlFuncWeightKey,false);
+    var = settings->value(hlFuncWeightKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlFuncWeight.setChecked(var.toBool());
-        settings.setValue(hlFuncWeightKey,var.toBool());
+        settings->setValue(hlFuncWeightKey,var.toBool());
     }
 
-    var = settings.value(hlFuncStyleKey,checkBold);
+    var = settings->value(hlFuncStyleKey,checkBold);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlFuncStyle.setChecked(var.toBool());
-        settings.setValue(hlFuncStyleKey,var.toBool());
+        settings->setValue(hlFuncStyleKey,var.toBool());
     }
 
-    var = settings.value(hlFuncColorKey,PColor::Blue);
+    var = settings->value(hlFuncColorKey,PColor::Blue);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlFuncColor.setCurrentIndex(n);
-        settings.setValue(hlFuncColorKey,n);
+        settings->setValue(hlFuncColorKey,n);
     }
 
     QLabel *lKeyWordStyle = new QLabel(tr("Key Words"));
@@ -1367,26 +1380,26 @@ void Properties::setupHighlight()
     hlKeyWordColor.setCurrentIndex(PColor::DarkBlue);
     hlrow++;
 
-    var = settings.value(hlKeyWordWeightKey,checkBold);
+    var = settings->value(hlKeyWordWeightKey,checkBold);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlKeyWordWeight.setChecked(var.toBool());
-        settings.setValue(hlKeyWordWeightKey,var.toBool());
+        settings->setValue(hlKeyWordWeightKey,var.toBool());
     }
 
-    var = settings.value(hlKeyWordStyleKey,false);
+    var = settings->value(hlKeyWordStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlKeyWordStyle.setChecked(var.toBool());
-        settings.setValue(hlKeyWordStyleKey,var.toBool());
+        settings->setValue(hlKeyWordStyleKey,var.toBool());
     }
 
-    var = settings.value(hlKeyWordColorKey,PColor::DarkBlue);
+    var = settings->value(hlKeyWordColorKey,PColor::DarkBlue);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlKeyWordColor.setCurrentIndex(n);
-        settings.setValue(hlKeyWordColorKey,n);
+        settings->setValue(hlKeyWordColorKey,n);
     }
 
     QLabel *lPreProcStyle = new QLabel(tr("Pre-Processor"));
@@ -1402,26 +1415,26 @@ void Properties::setupHighlight()
     hlPreProcColor.setCurrentIndex(PColor::DarkYellow);
     hlrow++;
 
-    var = settings.value(hlPreProcWeightKey,false);
+    var = settings->value(hlPreProcWeightKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlPreProcWeight.setChecked(var.toBool());
-        settings.setValue(hlPreProcWeightKey,var.toBool());
+        settings->setValue(hlPreProcWeightKey,var.toBool());
     }
 
-    var = settings.value(hlPreProcStyleKey,false);
+    var = settings->value(hlPreProcStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlPreProcStyle.setChecked(var.toBool());
-        settings.setValue(hlPreProcStyleKey,var.toBool());
+        settings->setValue(hlPreProcStyleKey,var.toBool());
     }
 
-    var = settings.value(hlPreProcColorKey,PColor::DarkYellow);
+    var = settings->value(hlPreProcColorKey,PColor::DarkYellow);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlPreProcColor.setCurrentIndex(n);
-        settings.setValue(hlPreProcColorKey,n);
+        settings->setValue(hlPreProcColorKey,n);
     }
 
     QLabel *lQuoteStyle = new QLabel(tr("Quotes"));
@@ -1437,26 +1450,26 @@ void Properties::setupHighlight()
     hlQuoteColor.setCurrentIndex(PColor::Red);
     hlrow++;
 
-    var = settings.value(hlQuoteWeightKey,false);
+    var = settings->value(hlQuoteWeightKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlQuoteWeight.setChecked(var.toBool());
-        settings.setValue(hlQuoteWeightKey,var.toBool());
+        settings->setValue(hlQuoteWeightKey,var.toBool());
     }
 
-    var = settings.value(hlQuoteStyleKey,false);
+    var = settings->value(hlQuoteStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlQuoteStyle.setChecked(var.toBool());
-        settings.setValue(hlQuoteStyleKey,var.toBool());
+        settings->setValue(hlQuoteStyleKey,var.toBool());
     }
 
-    var = settings.value(hlQuoteColorKey,PColor::Red);
+    var = settings->value(hlQuoteColorKey,PColor::Red);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlQuoteColor.setCurrentIndex(n);
-        settings.setValue(hlQuoteColorKey,n);
+        settings->setValue(hlQuoteColorKey,n);
     }
 
     QLabel *lLineComStyle = new QLabel(tr("Line Comments"));
@@ -1472,26 +1485,26 @@ void Properties::setupHighlight()
     hlLineComColor.setCurrentIndex(PColor::Green);
     hlrow++;
 
-    var = settings.value(hlLineComWeightKey,false);
+    var = settings->value(hlLineComWeightKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlLineComWeight.setChecked(var.toBool());
-        settings.setValue(hlLineComWeightKey,var.toBool());
+        settings->setValue(hlLineComWeightKey,var.toBool());
     }
 
-    var = settings.value(hlLineComStyleKey,false);
+    var = settings->value(hlLineComStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlLineComStyle.setChecked(var.toBool());
-        settings.setValue(hlLineComStyleKey,var.toBool());
+        settings->setValue(hlLineComStyleKey,var.toBool());
     }
 
-    var = settings.value(hlLineComColorKey,PColor::DarkGreen);
+    var = settings->value(hlLineComColorKey,PColor::DarkGreen);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlLineComColor.setCurrentIndex(n);
-        settings.setValue(hlLineComColorKey,n);
+        settings->setValue(hlLineComColorKey,n);
     }
 
     QLabel *lBlockComStyle = new QLabel(tr("Block Comments"));
@@ -1507,26 +1520,26 @@ void Properties::setupHighlight()
     hlBlockComColor.setCurrentIndex(PColor::Green);
     hlrow++;
 
-    var = settings.value(hlBlockComWeightKey,false);
+    var = settings->value(hlBlockComWeightKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlBlockComWeight.setChecked(var.toBool());
-        settings.setValue(hlBlockComWeightKey,var.toBool());
+        settings->setValue(hlBlockComWeightKey,var.toBool());
     }
 
-    var = settings.value(hlBlockComStyleKey,false);
+    var = settings->value(hlBlockComStyleKey,false);
     if(var.canConvert(QVariant::Bool)) {
         QString s = var.toString();
         hlBlockComStyle.setChecked(var.toBool());
-        settings.setValue(hlBlockComStyleKey,var.toBool());
+        settings->setValue(hlBlockComStyleKey,var.toBool());
     }
 
-    var = settings.value(hlBlockComColorKey,PColor::DarkGreen);
+    var = settings->value(hlBlockComColorKey,PColor::DarkGreen);
     if(var.canConvert(QVariant::Int)) {
         QString s = var.toString();
         int n = var.toInt();
         hlBlockComColor.setCurrentIndex(n);
-        settings.setValue(hlBlockComColorKey,n);
+        settings->setValue(hlBlockComColorKey,n);
     }
 
 }
@@ -1607,8 +1620,8 @@ void Properties::browseGccLibrary()
 
 void Properties::browseGccWorkspace()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    QVariant vpath = settings.value(gccWorkspaceKey,QVariant("~/."));
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant vpath = settings->value(gccWorkspaceKey,QVariant("~/."));
     QString path = "";
     if(vpath.canConvert(QVariant::String)) {
         path = vpath.toString();
@@ -1638,7 +1651,7 @@ void Properties::browseGccWorkspace()
     }
 
     leditGccWorkspace->setText(s);
-    settings.setValue(gccWorkspaceKey, s);
+    settings->setValue(gccWorkspaceKey, s);
 }
 
 void Properties::browseSpinCompiler()
@@ -1688,8 +1701,8 @@ void Properties::browseSpinLibrary()
 
 void Properties::browseSpinWorkspace()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    QVariant vpath = settings.value(spinWorkspaceKey,QVariant("~/."));
+    SettingsCache *settings = SettingsCache::instance();
+    QVariant vpath = settings->value(spinWorkspaceKey,QVariant("~/."));
     QString path = "";
     if(vpath.canConvert(QVariant::String)) {
         path = vpath.toString();
@@ -1719,7 +1732,7 @@ void Properties::browseSpinWorkspace()
             s += "/";
     }
     leditSpinWorkspace->setText(s);
-    settings.setValue(spinWorkspaceKey, s);
+    settings->setValue(spinWorkspaceKey, s);
 }
 
 void Properties::browseLoader()
@@ -1747,54 +1760,54 @@ void Properties::browseLoader()
 
 void Properties::accept()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    if(settings.value(useKeys).toInt() == 0) {
+    SettingsCache *settings = SettingsCache::instance();
+    if(settings->value(useKeys).toInt() == 0) {
         done(QDialog::Accepted);
         return;
     }
 
-    settings.setValue(gccCompilerKey,leditGccCompiler->text());
-    settings.setValue(gccLibraryKey,leditGccLibrary->text());
-    settings.setValue(gccWorkspaceKey,leditGccWorkspace->text());
-    settings.setValue(spinCompilerKey,leditSpinCompiler->text());
-    settings.setValue(spinLibraryKey,leditSpinLibrary->text());
-    settings.setValue(spinWorkspaceKey,leditSpinWorkspace->text());
-    settings.setValue(configFileKey,leditLoader->text());
-
-    //settings.setValue(autoLibIncludeKey,autoLibCheck.isChecked());
-    settings.setValue(tabSpacesKey,tabSpaces.text());
-    settings.setValue(loadDelayKey,loadDelay.text());
-    settings.setValue(resetTypeKey,resetType.currentIndex());
-
-    settings.setValue(hlNumStyleKey,hlNumStyle.isChecked());
-    settings.setValue(hlNumWeightKey,hlNumWeight.isChecked());
-    settings.setValue(hlNumColorKey,hlNumColor.currentIndex());
-    settings.setValue(hlFuncStyleKey,hlFuncStyle.isChecked());
-    settings.setValue(hlFuncWeightKey,hlFuncWeight.isChecked());
-    settings.setValue(hlFuncColorKey,hlFuncColor.currentIndex());
-    settings.setValue(hlKeyWordStyleKey,hlKeyWordStyle.isChecked());
-    settings.setValue(hlKeyWordWeightKey,hlKeyWordWeight.isChecked());
-    settings.setValue(hlKeyWordColorKey,hlKeyWordColor.currentIndex());
-    settings.setValue(hlPreProcStyleKey,hlPreProcStyle.isChecked());
-    settings.setValue(hlPreProcWeightKey,hlPreProcWeight.isChecked());
-    settings.setValue(hlPreProcColorKey,hlPreProcColor.currentIndex());
-    settings.setValue(hlQuoteStyleKey,hlQuoteStyle.isChecked());
-    settings.setValue(hlQuoteWeightKey,hlQuoteWeight.isChecked());
-    settings.setValue(hlQuoteColorKey,hlQuoteColor.currentIndex());
-    settings.setValue(hlLineComStyleKey,hlLineComStyle.isChecked());
-    settings.setValue(hlLineComWeightKey,hlLineComWeight.isChecked());
-    settings.setValue(hlLineComColorKey,hlLineComColor.currentIndex());
-    settings.setValue(hlBlockComStyleKey,hlBlockComStyle.isChecked());
-    settings.setValue(hlBlockComWeightKey,hlBlockComWeight.isChecked());
-    settings.setValue(hlBlockComColorKey,hlBlockComColor.currentIndex());
+    settings->setValue(gccCompilerKey,leditGccCompiler->text());
+    settings->setValue(gccLibraryKey,leditGccLibrary->text());
+    settings->setValue(gccWorkspaceKey,leditGccWorkspace->text());
+    settings->setValue(spinCompilerKey,leditSpinCompiler->text());
+    settings->setValue(spinLibraryKey,leditSpinLibrary->text());
+    settings->setValue(spinWorkspaceKey,leditSpinWorkspace->text());
+    settings->setValue(configFileKey,leditLoader->text());
+
+    //settings->setValue(autoLibIncludeKey,autoLibCheck.isChecked());
+    settings->setValue(tabSpacesKey,tabSpaces.text());
+    settings->setValue(loadDelayKey,loadDelay.text());
+    settings->setValue(resetTypeKey,resetType.currentIndex());
+
+    settings->setValue(hlNumStyleKey,hlNumStyle.isChecked());
+    settings->setValue(hlNumWeightKey,hlNumWeight.isChecked());
+    settings->setValue(hlNumColorKey,hlNumColor.currentIndex());
+    settings->setValue(hlFuncStyleKey,hlFuncStyle.isChecked());
+    settings->setValue(hlFuncWeightKey,hlFuncWeight.isChecked());
+    settings->setValue(hlFuncColorKey,hlFuncColor.currentIndex());
+    settings->setValue(hlKeyWordStyleKey,hlKeyWordStyle.isChecked());
+    settings->setValue(hlKeyWordWeightKey,hlKeyWordWeight.isChecked());
+    settings->setValue(hlKeyWordColorKey,hlKeyWordColor.currentIndex());
+    settings->setValue(hlPreProcStyleKey,hlPreProcStyle.isChecked());
+    settings->setValue(hlPreProcWeightKey,hlPreProcWeight.isChecked());
+    settings->setValue(hlPreProcColorKey,hlPreProcColor.currentIndex());
+    settings->setValue(hlQuoteStyleKey,hlQuoteStyle.isChecked());
+    settings->setValue(hlQuoteWeightKey,hlQuoteWeight.isChecked());
+    settings->setValue(hlQuoteColorKey,hlQuoteColor.currentIndex());
+    settings->setValue(hlLineComStyleKey,hlLineComStyle.isChecked());
+    settings->setValue(hlLineComWeightKey,hlLineComWeight.isChecked());
+    settings->setValue(hlLineComColorKey,hlLineComColor.currentIndex());
+    settings->setValue(hlBlockComStyleKey,hlBlockComStyle.isChecked());
+    settings->setValue(hlBlockComWeightKey,hlBlockComWeight.isChecked());
+    settings->setValue(hlBlockComColorKey,hlBlockComColor.currentIndex());
 
     done(QDialog::Accepted);
 }
 
 void Properties::reject()
 {
-    QSettings settings(publisherKey, ASideGuiKey);
-    if(settings.value(useKeys).toInt() == 0) {
+    SettingsCache *settings = SettingsCache::instance();
+    if(settings->value(useKeys).toInt() == 0) {
         done(QDialog::Rejected);
         return;
     }
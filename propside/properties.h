@@ -34,6 +34,7 @@
 #include "propertycolor.h"
 #include "StatusDialog.h"
 #include "workspacedialog.h"
+#include "settingscache.h"
 
 #include <QWidget>
 #include <QDialog>
@@ -58,6 +59,9 @@
 #define simpleViewKey       "SimpleIDE_SimpleViewType"
 #define allowProjectViewKey "SimpleIDE_AllowProjectView"
 #define autoLibIncludeKey   "SimpleIDE_AutoLibInclude"
+#define objectCacheKey      "SimpleIDE_ObjectCacheDir"
+#define objectCacheSizeKey  "SimpleIDE_ObjectCacheMB"
+#define buildTraceKey       "SimpleIDE_BuildTrace"
 #define oldViewBoxKey       "SimpleIDE_OldViewBoxReminder"
 #define ASideGuiGeometry    "SimpleIDE_WindowGeometry"
 #define helpStartupKey      "SimpleIDE_ShowHelpStart"
@@ -124,6 +128,7 @@ public:
 
     void showStatusDialog(QString title, const QString text);
     void stopStatusDialog();
+    void copyWorkspace(QString src, QString dst);
     void saveUpdateFile(QString name, QString timestamp);
     bool workspaceSane(QString pkwrk, QString mywrk);
     bool replaceLearnWorkspace();
@@ -140,6 +145,7 @@ signals:
 
 public slots:
 
+    void copyProgress(int done, int total);
     void cleanSettings();
     void reloadDefaultSettings();
     void browseGccCompiler();
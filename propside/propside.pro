@@ -62,6 +62,7 @@ DEFINES += ENABLE_FILETO_SDCARD
 SOURCES += mainspin.cpp \
     PortConnectionMonitor.cpp \
     PropellerID.cpp \
+    PropellerProbe.cpp \
     editor.cpp \
     ctags.cpp \
     mainspinwindow.cpp \
@@ -103,10 +104,27 @@ SOURCES += mainspin.cpp \
     StatusDialog.cpp \
     workspacedialog.cpp \
     rescuedialog.cpp \
-    xesp8266port.cpp
+    xesp8266port.cpp \
+    xbeeserialport.cpp \
+    scrollback.cpp \
+    wxdiscovery.cpp \
+    diagnostics.cpp \
+    elfreader.cpp \
+    objectcache.cpp \
+    buildtrace.cpp \
+    depscanner.cpp \
+    treecopy.cpp \
+    treeremove.cpp \
+    startuptimer.cpp \
+    termbench.cpp \
+    settingscache.cpp \
+    fileindex.cpp \
+    helpindex.cpp \
+    helpsearch.cpp
 HEADERS += mainspinwindow.h \
     PortConnectionMonitor.h \
     PropellerID.h \
+    PropellerProbe.h \
     editor.h \
     ctags.h \
     highlighter.h \
@@ -154,7 +172,23 @@ HEADERS += mainspinwindow.h \
     workspacedialog.h \
     rescuedialog.h \
     qtversion.h \
-    xesp8266port.h
+    xesp8266port.h \
+    xbeeserialport.h \
+    scrollback.h \
+    wxdiscovery.h \
+    diagnostics.h \
+    elfreader.h \
+    objectcache.h \
+    buildtrace.h \
+    depscanner.h \
+    treecopy.h \
+    treeremove.h \
+    startuptimer.h \
+    termbench.h \
+    settingscache.h \
+    fileindex.h \
+    helpindex.h \
+    helpsearch.h
 FORMS += hardware.ui \
     project.ui \
     TermPrefs.ui \
@@ -0,0 +1,164 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * propsim - Propeller board simulator for hardware-free testing.
+ *
+ * propsim [options]
+ *   -link <path>        also make a symlink to the PTY slave
+ *   -version <n>        chip version to report (default 1)
+ *   -rate <bytes/s>     terminal output rate after a run download (default 11520)
+ *   -ctrl <percent>     percent of lines that carry a control code (default 0)
+ *   -lf                 end lines with LF instead of CR
+ *   -stream             stream output right away without a download
+ *   -bench-detect <n>   run PropellerID::isDevice n times and report latency
+ *   -bench-read <sec>   read the raw port for sec seconds and report throughput
+ *
+ * -bench-read only measures the serial port. For what the terminal window
+ * keeps up with run SimpleIDE -bench-terminal <port> <sec> against a
+ * propsim -stream -link <path> instance.
+ *   -v                  verbose
+ */
+
+#include <stdio.h>
+#include <QtCore>
+
+#include "propsim.h"
+#include "PropellerID.h"
+#include "qextserialport.h"
+
+static int benchDetect(PropellerSim *sim, int count)
+{
+    PropellerID propId;
+    QList<int> times;
+    int found = 0;
+
+    for(int n = 0; n < count; n++) {
+        QElapsedTimer timer;
+        timer.start();
+        int rc = propId.isDevice(sim->portName());
+        times.append((int)timer.elapsed());
+        if(rc > 0)
+            found++;
+    }
+
+    qSort(times);
+    qint64 total = 0;
+    foreach(int ms, times)
+        total += ms;
+
+    printf("detect: %d/%d found, version %d\n", found, count, propId.getVersion());
+    if(count > 0) {
+        printf("detect ms: min %d median %d max %d avg %.1f\n",
+               times.first(), times.at(times.count()/2), times.last(), (double)total/count);
+    }
+    return found == count ? 0 : 1;
+}
+
+static int benchRead(PropellerSim *sim, int seconds)
+{
+    QextSerialPort port(sim->portName(), QextSerialPort::Polling);
+    port.setBaudRate(BAUD115200);
+    port.setFlowControl(FLOW_OFF);
+    port.setParity(PAR_NONE);
+    port.setDataBits(DATA_8);
+    port.setStopBits(STOP_1);
+    port.setTimeout(10);
+    if(port.open(QIODevice::ReadWrite) == false) {
+        printf("can't open %s\n", sim->portName().toLatin1().constData());
+        return 1;
+    }
+
+    qint64 total = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while(timer.elapsed() < seconds*1000) {
+        if(port.waitForReadyRead(50))
+            total += port.readAll().size();
+    }
+    port.close();
+
+    double secs = timer.elapsed() / 1000.0;
+    printf("raw read: %lld bytes in %.2f s, %.0f bytes/s\n", total, secs, total/secs);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    PropellerSim sim;
+    QString link;
+    int benchDetectCount = 0;
+    int benchReadSeconds = 0;
+    bool stream = false;
+
+    for(int n = 1; n < args.count(); n++) {
+        QString arg = args.at(n);
+        QString val = (n+1 < args.count()) ? args.at(n+1) : QString();
+        if(arg == "-link") {
+            link = val; n++;
+        }
+        else if(arg == "-version") {
+            sim.setVersion(val.toInt()); n++;
+        }
+        else if(arg == "-rate") {
+            sim.setStreamRate(val.toInt()); n++;
+        }
+        else if(arg == "-ctrl") {
+            sim.setControlMix(val.toInt()); n++;
+        }
+        else if(arg == "-lf") {
+            sim.setNewline(10);
+        }
+        else if(arg == "-stream") {
+            stream = true;
+        }
+        else if(arg == "-bench-detect") {
+            benchDetectCount = val.toInt(); n++;
+        }
+        else if(arg == "-bench-read") {
+            benchReadSeconds = val.toInt(); n++;
+        }
+        else if(arg == "-v") {
+            sim.setVerbose(true);
+        }
+        else {
+            printf("unknown option %s\n", arg.toLatin1().constData());
+            return 2;
+        }
+    }
+
+    sim.setStreamOnly(stream || benchReadSeconds > 0);
+    if(!sim.open(link)) {
+        printf("can't create pseudo-terminal\n");
+        return 1;
+    }
+    printf("Propeller simulator on %s\n", sim.portName().toLatin1().constData());
+    fflush(stdout);
+    sim.start();
+
+    if(benchDetectCount > 0)
+        return benchDetect(&sim, benchDetectCount);
+    if(benchReadSeconds > 0)
+        return benchRead(&sim, benchReadSeconds);
+
+    return app.exec();
+}
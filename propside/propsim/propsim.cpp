@@ -0,0 +1,377 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "propsim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+
+PropellerSim::PropellerSim(QObject *parent) : QThread(parent)
+{
+    masterFd = -1;
+    slaveFd = -1;
+    running = false;
+    state = WaitSync;
+    LFSR = 'P';
+    count = 0;
+    version = 1;
+    verbose = false;
+    handshakes = 0;
+    command = 0;
+    imageLongs = 0;
+    imageCount = 0;
+    acks = 0;
+    longValue = 0;
+    longBytes = 0;
+    streamOnly = false;
+    streaming = false;
+    streamRate = 11520;
+    controlMix = 0;
+    newline = 13;
+    streamed = 0;
+    lineNumber = 0;
+}
+
+PropellerSim::~PropellerSim()
+{
+    stop();
+    if(!linkName.isEmpty())
+        QFile::remove(linkName);
+    if(slaveFd > -1)
+        close(slaveFd);
+    if(masterFd > -1)
+        close(masterFd);
+}
+
+/*
+ * Create the PTY pair. The slave is kept open here so the master
+ * does not get EIO while the IDE or a benchmark has the port closed.
+ */
+bool PropellerSim::open(QString link)
+{
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if(masterFd < 0)
+        return false;
+    if(grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+        return false;
+    slaveName = QString(ptsname(masterFd));
+
+    slaveFd = ::open(slaveName.toLatin1().constData(), O_RDWR | O_NOCTTY);
+    if(slaveFd > -1) {
+        struct termios tio;
+        tcgetattr(slaveFd, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slaveFd, TCSANOW, &tio);
+    }
+
+    if(!link.isEmpty()) {
+        QFile::remove(link);
+        if(QFile::link(slaveName, link))
+            linkName = link;
+    }
+    return true;
+}
+
+QString PropellerSim::portName()
+{
+    return linkName.isEmpty() ? slaveName : linkName;
+}
+
+void PropellerSim::setVersion(int value)
+{
+    version = value;
+}
+
+void PropellerSim::setStreamRate(int bytesPerSecond)
+{
+    streamRate = bytesPerSecond;
+}
+
+void PropellerSim::setControlMix(int percent)
+{
+    controlMix = percent;
+}
+
+void PropellerSim::setNewline(char ch)
+{
+    newline = ch;
+}
+
+void PropellerSim::setStreamOnly(bool enable)
+{
+    streamOnly = enable;
+}
+
+void PropellerSim::setVerbose(bool enable)
+{
+    verbose = enable;
+}
+
+int PropellerSim::handshakeCount()
+{
+    return handshakes;
+}
+
+qint64 PropellerSim::bytesStreamed()
+{
+    return streamed;
+}
+
+void PropellerSim::stop()
+{
+    running = false;
+    wait();
+}
+
+/*
+ * Same LFSR as PropellerID::iterate
+ */
+int PropellerSim::iterate()
+{
+    int bit = LFSR & 1;
+    LFSR = (char)((LFSR << 1) | (((LFSR >> 7) ^ (LFSR >> 5) ^ (LFSR >> 4) ^ (LFSR >> 1)) & 1));
+    return bit;
+}
+
+void PropellerSim::startSync()
+{
+    LFSR = 'P';
+    count = 0;
+    streaming = false;
+    state = CheckLfsr;
+    handshakeTimer.start();
+}
+
+void PropellerSim::startRunning()
+{
+    state = Running;
+    streaming = streamRate > 0;
+    streamTimer.start();
+    streamed = 0;
+}
+
+/*
+ * Longs are sent as 11 bytes of 3 bits each, see PropellerID::makelong.
+ * Bits are at positions 0, 3 and 6 of every byte.
+ */
+bool PropellerSim::decodeLong(unsigned char ch)
+{
+    if(longBytes == 0)
+        longValue = 0;
+    int shift = longBytes * 3;
+    longValue |= (quint32)(ch & 1) << shift;
+    if(shift+1 < 32)
+        longValue |= (quint32)((ch >> 3) & 1) << (shift+1);
+    if(shift+2 < 32)
+        longValue |= (quint32)((ch >> 6) & 1) << (shift+2);
+    if(++longBytes < 11)
+        return false;
+    longBytes = 0;
+    return true;
+}
+
+void PropellerSim::handleByte(unsigned char ch)
+{
+    /* 0xF9 is never part of an encoded long, so it always means a new sync */
+    if(ch == 0xF9 && (state == ReadCommand || state == ReadCount || state == ReadImage)) {
+        startSync();
+        return;
+    }
+
+    switch(state) {
+    case WaitSync:
+    case Running:
+        if(ch == 0xF9)
+            startSync();
+        break;
+
+    case CheckLfsr:
+        if(ch != (unsigned char)(iterate() | 0xfe)) {
+            if(verbose)
+                printf("LFSR mismatch at %d\n", count);
+            state = WaitSync;
+            if(ch == 0xF9)
+                startSync();
+            break;
+        }
+        if(++count >= LFSR_BYTES) {
+            count = 0;
+            state = SendReply;
+        }
+        break;
+
+    case SendReply:
+        if(ch != 0xF9)
+            break;
+        if(count < LFSR_BYTES)
+            output.append((char)(0xfe | iterate()));
+        else
+            output.append((char)(0xfe | ((version >> (count - LFSR_BYTES)) & 1)));
+        if(++count >= REPLY_BYTES) {
+            handshakes++;
+            int ms = (int)handshakeTimer.elapsed();
+            if(verbose)
+                printf("Handshake %d done in %d ms\n", handshakes, ms);
+            emit handshakeDone(ms);
+            longBytes = 0;
+            state = ReadCommand;
+            if(streamOnly)
+                startRunning();
+        }
+        break;
+
+    case ReadCommand:
+        if(!decodeLong(ch))
+            break;
+        command = (int)longValue;
+        if(command == SHUTDOWN_CMD) {
+            state = WaitSync;
+        }
+        else {
+            state = ReadCount;
+        }
+        break;
+
+    case ReadCount:
+        if(!decodeLong(ch))
+            break;
+        imageLongs = (int)longValue;
+        imageCount = 0;
+        acks = (command == DOWNLOAD_EEPROM || command == DOWNLOAD_RUN_EEPROM) ? 3 : 1;
+        state = imageLongs > 0 ? ReadImage : SendAcks;
+        break;
+
+    case ReadImage:
+        if(!decodeLong(ch))
+            break;
+        if(++imageCount >= imageLongs)
+            state = SendAcks;
+        break;
+
+    case SendAcks:
+        /* checksum, then EEPROM program and verify. 0 bit is success. */
+        if(ch != 0xF9)
+            break;
+        output.append((char)0xfe);
+        if(--acks > 0)
+            break;
+        if(verbose)
+            printf("Download command %d with %d longs done\n", command, imageLongs);
+        emit downloadDone(command, imageLongs);
+        if(command == DOWNLOAD_RUN_BINARY || command == DOWNLOAD_RUN_EEPROM)
+            startRunning();
+        else
+            state = WaitSync;
+        break;
+    }
+}
+
+/*
+ * Text lines with control codes mixed in. The codes are the ones
+ * Console handles, so the terminal cursor paths get exercised.
+ */
+void PropellerSim::appendLine()
+{
+    static const char codes[] = { 1, 3, 4, 5, 6, 9, 11 };
+
+    lineNumber++;
+    if(controlMix > 0 && (rand() % 100) < controlMix) {
+        int pick = rand() % 10;
+        if(pick < 7) {
+            pending.append(codes[pick]);
+        }
+        else if(pick == 7) {
+            pending.append((char)2);
+            pending.append((char)(rand() % 40));
+            pending.append((char)(rand() % 20));
+        }
+        else if(pick == 8) {
+            pending.append((char)14);
+            pending.append((char)(rand() % 40));
+        }
+        else if(lineNumber % 100 == 0) {
+            pending.append((char)16);
+        }
+    }
+    pending.append(QString("%1 The quick brown fox jumps over the lazy dog 0123456789")
+                   .arg(lineNumber, 8, 10, QChar('0')).toLatin1());
+    pending.append(newline);
+}
+
+void PropellerSim::streamOutput()
+{
+    qint64 due = streamTimer.elapsed() * streamRate / 1000 - streamed;
+    if(due <= 0)
+        return;
+    while(pending.size() < due)
+        appendLine();
+    output.append(pending.left((int)due));
+    pending.remove(0, (int)due);
+    streamed += due;
+}
+
+void PropellerSim::flushOutput()
+{
+    while(output.size() > 0) {
+        int rc = ::write(masterFd, output.constData(), output.size());
+        if(rc < 0) {
+            if(errno == EINTR)
+                continue;
+            if(errno == EAGAIN) {
+                msleep(1);
+                continue;
+            }
+            output.clear();
+            return;
+        }
+        output.remove(0, rc);
+    }
+}
+
+void PropellerSim::run()
+{
+    unsigned char buf[1024];
+    struct pollfd fds;
+
+    running = true;
+    if(streamOnly)
+        startRunning();
+
+    while(running) {
+        fds.fd = masterFd;
+        fds.events = POLLIN;
+        fds.revents = 0;
+        int rc = poll(&fds, 1, streaming ? 5 : 50);
+        if(rc < 0 && errno != EINTR)
+            break;
+        if(rc > 0 && (fds.revents & POLLIN)) {
+            int len = ::read(masterFd, buf, sizeof(buf));
+            for(int n = 0; n < len; n++)
+                handleByte(buf[n]);
+        }
+        if(streaming)
+            streamOutput();
+        flushOutput();
+    }
+}
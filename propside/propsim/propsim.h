@@ -0,0 +1,123 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROPSIM_H
+#define PROPSIM_H
+
+#include <QtCore>
+
+/*
+ * PropellerSim pretends to be a Propeller board on the far end of a
+ * pseudo-terminal. It answers the LFSR handshake with a version byte,
+ * accepts the classic serial download and acknowledges it, and can
+ * produce terminal output at a chosen rate and control code mix.
+ *
+ * The PTY has no modem lines, so a board reset cannot be seen. Every
+ * 0xF9 calibration byte followed by the LFSR stream starts a new handshake.
+ */
+class PropellerSim : public QThread
+{
+    Q_OBJECT
+public:
+    explicit PropellerSim(QObject *parent = 0);
+    virtual ~PropellerSim();
+
+    bool    open(QString link = QString());
+    QString portName();
+
+    void    setVersion(int version);
+    void    setStreamRate(int bytesPerSecond);
+    void    setControlMix(int percent);
+    void    setNewline(char ch);
+    void    setStreamOnly(bool enable);
+    void    setVerbose(bool enable);
+
+    int     handshakeCount();
+    qint64  bytesStreamed();
+
+    void    stop();
+    void    run();
+
+signals:
+    void    handshakeDone(int msecs);
+    void    downloadDone(int command, int longs);
+
+private:
+    enum State {
+        WaitSync,
+        CheckLfsr,
+        SendReply,
+        ReadCommand,
+        ReadCount,
+        ReadImage,
+        SendAcks,
+        Running
+    };
+
+    enum { LFSR_BYTES = 250, REPLY_BYTES = 258 };
+
+    enum { SHUTDOWN_CMD = 0 };
+    enum { DOWNLOAD_RUN_BINARY = 1 };
+    enum { DOWNLOAD_EEPROM = 2 };
+    enum { DOWNLOAD_RUN_EEPROM = 3 };
+
+    int     iterate();
+    void    handleByte(unsigned char ch);
+    bool    decodeLong(unsigned char ch);
+    void    startSync();
+    void    startRunning();
+    void    streamOutput();
+    void    appendLine();
+    void    flushOutput();
+
+    int         masterFd;
+    int         slaveFd;
+    QString     slaveName;
+    QString     linkName;
+    volatile bool running;
+
+    State       state;
+    char        LFSR;
+    int         count;
+    int         version;
+    bool        verbose;
+    QElapsedTimer handshakeTimer;
+    int         handshakes;
+
+    int         command;
+    int         imageLongs;
+    int         imageCount;
+    int         acks;
+    quint32     longValue;
+    int         longBytes;
+
+    bool        streamOnly;
+    bool        streaming;
+    int         streamRate;
+    int         controlMix;
+    char        newline;
+    qint64      streamed;
+    int         lineNumber;
+    QElapsedTimer streamTimer;
+
+    QByteArray  output;
+    QByteArray  pending;
+};
+
+#endif // PROPSIM_H
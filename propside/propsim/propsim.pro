@@ -0,0 +1,30 @@
+# -------------------------------------------------
+# propsim emulates a Propeller board on a pseudo-terminal so the
+# loader and terminal can be tested without hardware. Linux/Unix only.
+# -------------------------------------------------
+
+QT += core
+QT += gui
+
+greaterThan(QT_MAJOR_VERSION, 4): {
+    QT -= gui
+    QT += widgets
+    DEFINES += QT5
+}
+
+TARGET   = propsim
+TEMPLATE = app
+CONFIG  += console
+CONFIG  -= app_bundle
+DEFINES += QEXTSERIALPORT_LIB
+
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    propsim.cpp \
+    ../PropellerID.cpp \
+    ../qextserialport.cpp \
+    ../qextserialport_unix.cpp
+HEADERS += propsim.h \
+    ../PropellerID.h \
+    ../qextserialport.h
@@ -542,6 +542,24 @@ void QextSerialPort::flush()
         d->flush_sys();
 }
 
+/*! \reimp
+    Blocks until data is available to read or \a msecs milliseconds have passed.
+    The port lock is not held while waiting, so other threads can write to the
+    port in the meantime. Returns true if data is available.
+*/
+bool QextSerialPort::waitForReadyRead(int msecs)
+{
+    Q_D(QextSerialPort);
+    {
+        QReadLocker locker(&d->lock);
+        if (!isOpen())
+            return false;
+        if (!d->readBuffer.isEmpty())
+            return true;
+    }
+    return d->waitForReadyRead_sys(msecs);
+}
+
 /*! \reimp
     Returns the number of bytes waiting in the port's receive queue.  This function will return 0 if
     the port is not currently open, or -1 on error.
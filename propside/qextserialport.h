@@ -199,6 +199,7 @@ public:
     void flush();
     qint64 bytesAvailable() const;
     QByteArray readAll();
+    bool waitForReadyRead(int msecs);
 
     ulong lastError() const;
 
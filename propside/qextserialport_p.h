@@ -230,6 +230,7 @@ public:
     bool flush_sys();
     ulong lineStatus_sys();
     qint64 bytesAvailable_sys() const;
+    bool waitForReadyRead_sys(int msecs);
 
 #ifdef Q_OS_WIN
     void _q_onWinEvent(HANDLE h);
@@ -137,6 +137,17 @@ qint64 QextSerialPortPrivate::bytesAvailable_sys() const
     return bytesQueued;
 }
 
+bool QextSerialPortPrivate::waitForReadyRead_sys(int msecs)
+{
+    fd_set fds;
+    struct timeval tv;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    tv.tv_sec = msecs / 1000;
+    tv.tv_usec = (msecs % 1000) * 1000;
+    return ::select(fd+1, &fds, NULL, NULL, msecs < 0 ? NULL : &tv) > 0;
+}
+
 /*!
     Translates a system-specific error code to a QextSerialPort error code.  Used internally.
 */
@@ -159,6 +159,19 @@ qint64 QextSerialPortPrivate::bytesAvailable_sys() const
     return (qint64)-1;
 }
 
+bool QextSerialPortPrivate::waitForReadyRead_sys(int msecs)
+{
+    DWORD start = GetTickCount();
+    for (;;) {
+        qint64 bytes = bytesAvailable_sys();
+        if (bytes != 0)
+            return bytes > 0;
+        if (msecs >= 0 && GetTickCount() - start >= (DWORD)msecs)
+            return false;
+        ::Sleep(1);
+    }
+}
+
 /*
     Translates a system-specific error code to a QextSerialPort error code.  Used internally.
 */
@@ -0,0 +1,235 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scrollback.h"
+
+Scrollback::Scrollback(qint64 maxLines) : maxCount(maxLines)
+{
+    clear();
+}
+
+void Scrollback::clear()
+{
+    pages.clear();
+    first = 0;
+    end = 0;
+    cachedFirst = -1;
+    cachedData.clear();
+}
+
+void Scrollback::setMaxLines(qint64 lines)
+{
+    maxCount = lines;
+    dropPages();
+}
+
+qint64 Scrollback::maxLines()
+{
+    return maxCount;
+}
+
+void Scrollback::appendLine(const QString &line)
+{
+    if(pages.isEmpty() || pages.last().packed) {
+        Page page;
+        page.first = end;
+        page.packed = false;
+        page.offsets.reserve(PageLines);
+        page.data.reserve(PageBytes+1024);
+        pages.append(page);
+    }
+
+    Page &page = pages.last();
+    page.offsets.append(page.data.size());
+    page.data.append(line.toUtf8());
+    page.data.append('\n');
+    end++;
+
+    if(page.offsets.count() >= PageLines || page.data.size() >= PageBytes) {
+        sealPage();
+        dropPages();
+    }
+}
+
+qint64 Scrollback::firstLine()
+{
+    return first;
+}
+
+qint64 Scrollback::endLine()
+{
+    return end;
+}
+
+qint64 Scrollback::lineCount()
+{
+    return end - first;
+}
+
+QString Scrollback::line(qint64 number)
+{
+    int index = pageIndex(number);
+    if(index < 0)
+        return QString("");
+    QByteArray raw = pageData(index);
+    return QString::fromUtf8(pageLine(index, raw, (int)(number - pages[index].first)));
+}
+
+QStringList Scrollback::lines(qint64 number, int count)
+{
+    QStringList list;
+    if(number < first) {
+        count -= (int)(first - number);
+        number = first;
+    }
+    while(count > 0 && number < end) {
+        int index = pageIndex(number);
+        if(index < 0)
+            break;
+        const Page &page = pages[index];
+        QByteArray raw = pageData(index);
+        int n = (int)(number - page.first);
+        for(; n < page.offsets.count() && count > 0; n++, count--, number++) {
+            list.append(QString::fromUtf8(pageLine(index, raw, n)));
+        }
+    }
+    return list;
+}
+
+/*
+ * Search the whole history for text starting at line "from".
+ * Forward searches return the first match on or after from,
+ * backward searches return the last match on or before from.
+ * Returns the absolute line number or -1 if text is not found.
+ */
+qint64 Scrollback::find(const QString &text, qint64 from, bool forward, Qt::CaseSensitivity cs)
+{
+    if(text.isEmpty() || end == first)
+        return -1;
+
+    QByteArray needle = text.toUtf8();
+    if(cs == Qt::CaseInsensitive)
+        needle = needle.toLower();
+
+    if(forward) {
+        if(from >= end)
+            return -1;
+        if(from < first)
+            from = first;
+        for(int index = pageIndex(from); index < pages.count(); index++) {
+            const Page &page = pages[index];
+            QByteArray hay = pageData(index);
+            if(cs == Qt::CaseInsensitive)
+                hay = hay.toLower();
+            int start = 0;
+            if(from > page.first)
+                start = page.offsets[(int)(from - page.first)];
+            int pos = hay.indexOf(needle, start);
+            if(pos > -1) {
+                QVector<quint32>::const_iterator it = qUpperBound(page.offsets.begin(), page.offsets.end(), (quint32)pos);
+                return page.first + (it - page.offsets.begin()) - 1;
+            }
+        }
+    }
+    else {
+        if(from < first)
+            return -1;
+        if(from >= end)
+            from = end-1;
+        for(int index = pageIndex(from); index > -1; index--) {
+            const Page &page = pages[index];
+            QByteArray hay = pageData(index);
+            if(cs == Qt::CaseInsensitive)
+                hay = hay.toLower();
+            int stop = hay.size();
+            int n = (int)(from - page.first);
+            if(n+1 < page.offsets.count())
+                stop = page.offsets[n+1];
+            int pos = hay.lastIndexOf(needle, stop-1);
+            if(pos > -1) {
+                QVector<quint32>::const_iterator it = qUpperBound(page.offsets.begin(), page.offsets.end(), (quint32)pos);
+                return page.first + (it - page.offsets.begin()) - 1;
+            }
+        }
+    }
+    return -1;
+}
+
+int Scrollback::pageIndex(qint64 number)
+{
+    if(number < first || number >= end)
+        return -1;
+    int lo = 0;
+    int hi = pages.count()-1;
+    while(lo < hi) {
+        int mid = (lo+hi+1)/2;
+        if(pages[mid].first <= number)
+            lo = mid;
+        else
+            hi = mid-1;
+    }
+    return lo;
+}
+
+QByteArray Scrollback::pageData(int index)
+{
+    const Page &page = pages[index];
+    if(!page.packed)
+        return page.data;
+    if(cachedFirst != page.first) {
+        cachedData = qUncompress(page.data);
+        cachedFirst = page.first;
+    }
+    return cachedData;
+}
+
+QByteArray Scrollback::pageLine(int index, const QByteArray &raw, int n)
+{
+    const Page &page = pages[index];
+    int start = page.offsets[n];
+    int stop = raw.size();
+    if(n+1 < page.offsets.count())
+        stop = page.offsets[n+1];
+    return raw.mid(start, stop-start-1);
+}
+
+void Scrollback::sealPage()
+{
+    Page &page = pages.last();
+    page.data = qCompress(page.data);
+    page.offsets.squeeze();
+    page.packed = true;
+}
+
+/*
+ * Only whole pages are dropped, so between maxLines and maxLines+PageLines
+ * lines are kept. A maxLines of 0 keeps everything.
+ */
+void Scrollback::dropPages()
+{
+    if(maxCount < 1)
+        return;
+    while(pages.count() > 1) {
+        const Page &page = pages.first();
+        if(end - (page.first + page.offsets.count()) < maxCount)
+            break;
+        pages.removeFirst();
+    }
+    first = pages.isEmpty() ? end : pages.first().first;
+}
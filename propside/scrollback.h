@@ -0,0 +1,76 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCROLLBACK_H
+#define SCROLLBACK_H
+
+#include <QtCore>
+
+/*
+ * Scrollback keeps terminal lines that have scrolled out of the Console widget.
+ * Lines are appended to an open page. When a page fills up it is compressed
+ * and only the per-line offset index stays unpacked, so millions of lines can
+ * be kept without slowing the widget down. Line numbers are absolute and keep
+ * counting when old pages are dropped to honor maxLines.
+ */
+class Scrollback
+{
+public:
+    explicit Scrollback(qint64 maxLines = 0);
+
+    void    clear();
+    void    setMaxLines(qint64 lines);
+    qint64  maxLines();
+
+    void    appendLine(const QString &line);
+
+    qint64  firstLine();
+    qint64  endLine();
+    qint64  lineCount();
+
+    QString line(qint64 number);
+    QStringList lines(qint64 first, int count);
+    qint64  find(const QString &text, qint64 from, bool forward, Qt::CaseSensitivity cs = Qt::CaseInsensitive);
+
+private:
+    enum { PageLines = 2048, PageBytes = 64*1024 };
+
+    struct Page {
+        qint64              first;
+        QVector<quint32>    offsets;
+        QByteArray          data;
+        bool                packed;
+    };
+
+    int         pageIndex(qint64 number);
+    QByteArray  pageData(int index);
+    QByteArray  pageLine(int index, const QByteArray &raw, int n);
+    void        sealPage();
+    void        dropPages();
+
+    QList<Page> pages;
+    qint64      first;
+    qint64      end;
+    qint64      maxCount;
+
+    qint64      cachedFirst;
+    QByteArray  cachedData;
+};
+
+#endif // SCROLLBACK_H
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "settingscache.h"
+#include "properties.h"
+
+/*
+ * Applies a batch of changes to the real settings store in order.
+ */
+class SettingsWriter : public QRunnable
+{
+public:
+    SettingsWriter(QList<SettingsCache::Change> changes) : changes(changes) { }
+    void run() {
+        QSettings settings(publisherKey, ASideGuiKey);
+        foreach(SettingsCache::Change change, changes) {
+            if(change.remove)
+                settings.remove(change.key);
+            else
+                settings.setValue(change.key, change.value);
+        }
+        settings.sync();
+    }
+private:
+    QList<SettingsCache::Change> changes;
+};
+
+SettingsCache *SettingsCache::instance()
+{
+    static QMutex createMutex;
+    static QPointer<SettingsCache> cache;
+    QMutexLocker lock(&createMutex);
+    if(!cache) {
+        cache = new SettingsCache(QCoreApplication::instance());
+        if(QCoreApplication::instance())
+            cache->moveToThread(QCoreApplication::instance()->thread());
+    }
+    return cache;
+}
+
+SettingsCache::SettingsCache(QObject *parent) : QObject(parent), writeTimer(this)
+{
+    /* one thread keeps writes in the order they were made */
+    writePool.setMaxThreadCount(1);
+    writeTimer.setSingleShot(true);
+    writeTimer.setInterval(250);
+    connect(&writeTimer, SIGNAL(timeout()), this, SLOT(writeBack()));
+    if(parent)
+        connect(parent, SIGNAL(aboutToQuit()), this, SLOT(sync()));
+    reload();
+}
+
+SettingsCache::~SettingsCache()
+{
+    sync();
+}
+
+/*
+ * Read every key from the settings store. Only needed if something
+ * outside this process changed the settings.
+ */
+void SettingsCache::reload()
+{
+    sync();
+    QSettings settings(publisherKey, ASideGuiKey);
+    QHash<QString,QVariant> loaded;
+    foreach(QString key, settings.allKeys())
+        loaded.insert(key, settings.value(key));
+    QMutexLocker lock(&mutex);
+    values = loaded;
+}
+
+QVariant SettingsCache::value(const QString &key, const QVariant &defaultValue)
+{
+    QMutexLocker lock(&mutex);
+    QHash<QString,QVariant>::const_iterator it = values.constFind(key);
+    if(it == values.constEnd())
+        return defaultValue;
+    return it.value();
+}
+
+QString SettingsCache::stringValue(const QString &key, const QString &defaultValue)
+{
+    QVariant var = value(key);
+    if(!var.canConvert(QVariant::String))
+        return defaultValue;
+    return var.toString();
+}
+
+int SettingsCache::intValue(const QString &key, int defaultValue)
+{
+    bool ok = false;
+    int n = value(key).toInt(&ok);
+    return ok ? n : defaultValue;
+}
+
+bool SettingsCache::boolValue(const QString &key, bool defaultValue)
+{
+    QVariant var = value(key);
+    if(!var.isValid() || !var.canConvert(QVariant::Bool))
+        return defaultValue;
+    return var.toBool();
+}
+
+bool SettingsCache::contains(const QString &key)
+{
+    QMutexLocker lock(&mutex);
+    return values.contains(key);
+}
+
+QStringList SettingsCache::allKeys()
+{
+    QMutexLocker lock(&mutex);
+    QStringList keys = values.keys();
+    keys.sort();
+    return keys;
+}
+
+void SettingsCache::setValue(const QString &key, const QVariant &value)
+{
+    {
+        QMutexLocker lock(&mutex);
+        QHash<QString,QVariant>::const_iterator it = values.constFind(key);
+        if(it != values.constEnd() && it.value() == value)
+            return;
+        values.insert(key, value);
+        Change change;
+        change.key = key;
+        change.value = value;
+        change.remove = false;
+        pending.append(change);
+    }
+    scheduleWriteBack();
+    emit valueChanged(key, value);
+}
+
+/*
+ * Like QSettings::remove, removes the key and any keys under it.
+ * An empty key removes everything.
+ */
+void SettingsCache::remove(const QString &key)
+{
+    QStringList removed;
+    {
+        QMutexLocker lock(&mutex);
+        QString group = key+"/";
+        foreach(QString k, values.keys()) {
+            if(key.isEmpty() || k == key || k.startsWith(group))
+                removed.append(k);
+        }
+        foreach(QString k, removed)
+            values.remove(k);
+        Change change;
+        change.key = key;
+        change.remove = true;
+        pending.append(change);
+    }
+    scheduleWriteBack();
+    foreach(QString k, removed)
+        emit valueChanged(k, QVariant());
+}
+
+void SettingsCache::scheduleWriteBack()
+{
+    if(QThread::currentThread() == thread())
+        writeTimer.start();
+    else
+        QMetaObject::invokeMethod(&writeTimer, "start", Qt::QueuedConnection);
+}
+
+void SettingsCache::writeBack()
+{
+    QList<Change> changes;
+    {
+        QMutexLocker lock(&mutex);
+        changes = pending;
+        pending.clear();
+    }
+    if(changes.count() > 0)
+        writePool.start(new SettingsWriter(changes));
+}
+
+/*
+ * Write any pending changes now and wait until they are stored.
+ */
+void SettingsCache::sync()
+{
+    writeBack();
+    writePool.waitForDone();
+}
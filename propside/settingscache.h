@@ -0,0 +1,78 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SETTINGSCACHE_H
+#define SETTINGSCACHE_H
+
+#include <QtCore>
+
+/*
+ * All IDE settings, loaded once and served from memory.
+ * Changes are written back to QSettings on a background thread shortly
+ * after they are made, and valueChanged tells listeners what changed.
+ * Use SettingsCache::instance() instead of constructing QSettings.
+ */
+class SettingsCache : public QObject
+{
+    Q_OBJECT
+public:
+    static SettingsCache *instance();
+
+    QVariant    value(const QString &key, const QVariant &defaultValue = QVariant());
+    QString     stringValue(const QString &key, const QString &defaultValue = QString());
+    int         intValue(const QString &key, int defaultValue = 0);
+    bool        boolValue(const QString &key, bool defaultValue = false);
+    bool        contains(const QString &key);
+    QStringList allKeys();
+
+    void        setValue(const QString &key, const QVariant &value);
+    void        remove(const QString &key);
+
+    void        reload();
+
+signals:
+    void valueChanged(const QString &key, const QVariant &value);
+
+public slots:
+    void sync();
+
+private slots:
+    void writeBack();
+
+private:
+    explicit SettingsCache(QObject *parent);
+    ~SettingsCache();
+
+    void scheduleWriteBack();
+
+    struct Change {
+        QString  key;
+        QVariant value;
+        bool     remove;
+    };
+    friend class SettingsWriter;
+
+    QMutex                  mutex;
+    QHash<QString,QVariant> values;
+    QList<Change>           pending;
+    QTimer                  writeTimer;
+    QThreadPool             writePool;
+};
+
+#endif // SETTINGSCACHE_H
@@ -19,6 +19,7 @@
 
 #include <QWidget>
 #include "spinparser.h"
+#include "fileindex.h"
 
 #define KEY_ELEMENT_SEP ":"
 
@@ -572,15 +573,20 @@ QString SpinParser::checkFile(QString fileName)
         QString fs = this->currentFile;
         QString shortfile = fileName.mid(fileName.lastIndexOf("/")+1);
         QString path = fs.mid(0,fs.lastIndexOf("/")+1);
-        dir.setPath(path);
-        list = dir.entryList();
+        FileIndex *index = FileIndex::instance();
+        if(!index->entries(path, list)) {
+            dir.setPath(path);
+            list = dir.entryList();
+        }
         foreach(QString s, list) {
             if(s.compare(shortfile,Qt::CaseInsensitive) == 0) {
                 return path+s;
             }
         }
-        dir.setPath(libraryPath);
-        list = dir.entryList();
+        if(!index->entries(libraryPath, list)) {
+            dir.setPath(libraryPath);
+            list = dir.entryList();
+        }
         foreach(QString s, list) {
             if(s.contains(shortfile,Qt::CaseInsensitive)) {
                 return libraryPath+"/"+s;
@@ -0,0 +1,60 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "startuptimer.h"
+
+QElapsedTimer StartupTimer::clock;
+QList<StartupTimer::Phase> StartupTimer::phases;
+
+void StartupTimer::start()
+{
+    phases.clear();
+    clock.start();
+}
+
+/*
+ * Record the end of a startup phase. Marks are only taken on the GUI thread.
+ */
+void StartupTimer::mark(const QString &phase)
+{
+    if(!clock.isValid())
+        clock.start();
+    Phase p;
+    p.name = phase;
+    p.at = clock.elapsed();
+    phases.append(p);
+    qDebug() << "startup" << p.at << "ms" << phase;
+}
+
+qint64 StartupTimer::elapsed()
+{
+    return clock.isValid() ? clock.elapsed() : 0;
+}
+
+QString StartupTimer::report()
+{
+    QString text;
+    qint64 last = 0;
+    text += QString("%1 %2  %3\n").arg("ms",6).arg("total",6).arg("phase");
+    foreach(Phase p, phases) {
+        text += QString("%1 %2  %3\n").arg(p.at-last,6).arg(p.at,6).arg(p.name);
+        last = p.at;
+    }
+    return text;
+}
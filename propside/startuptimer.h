@@ -0,0 +1,47 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <QtCore>
+
+/*
+ * Startup timeline. Each mark records the time spent since the previous
+ * mark so the report shows where IDE startup goes.
+ */
+class StartupTimer
+{
+public:
+    static void start();
+    static void mark(const QString &phase);
+    static qint64 elapsed();
+    static QString report();
+
+private:
+    struct Phase {
+        QString name;
+        qint64  at;
+    };
+
+    static QElapsedTimer clock;
+    static QList<Phase>  phases;
+};
+
+#endif // STARTUPTIMER_H
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include "termbench.h"
+#include "console.h"
+#include "PortListener.h"
+
+int TerminalBench::run(const QString &portName, int seconds)
+{
+    Console console;
+    console.setEnableClearScreen(true);
+    console.setEnableHomeCursor(true);
+    console.setEnablePosXYCursor(true);
+    console.setEnableMoveCursorLeft(true);
+    console.setEnableMoveCursorRight(true);
+    console.setEnableMoveCursorUp(true);
+    console.setEnableMoveCursorDown(true);
+    console.setEnableBeepSpeaker(false);
+    console.setEnableBackspace(true);
+    console.setEnableTab(true);
+    console.setEnableCReturn(true);
+    console.setEnableClearToEOL(true);
+    console.setEnableClearLinesBelow(true);
+    console.setEnableNewLine(true);
+    console.setEnablePosCursorX(true);
+    console.setEnablePosCursorY(true);
+    console.setEnableClearScreen16(true);
+    console.setEnableEchoOn(false);
+    console.setEnableEnterIsNL(false);
+    console.setEnableSwapNLCR(false);
+    console.setWrapMode(0);
+    console.setTabSize(8);
+    console.setHexMode(false);
+    console.setHexDump(false);
+    console.resize(640, 480);
+    console.show();
+
+    PortListener listener(0, &console);
+    listener.init(portName, BAUD115200);
+    listener.setTerminalWindow(&console);
+    if(listener.open() == false || listener.isOpen() == false) {
+        printf("can't open %s\n", portName.toLatin1().constData());
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QEventLoop loop;
+    QTimer::singleShot(seconds*1000, &loop, SLOT(quit()));
+    loop.exec();
+
+    double secs = timer.elapsed() / 1000.0;
+    qint64 total = console.bytesReceived();
+    qint64 lines = console.historyEndLine();
+
+    listener.close();
+    listener.wait();
+
+    printf("terminal: %lld bytes %lld lines in %.2f s, %.0f bytes/s %.0f lines/s\n",
+           total, lines, secs, total/secs, lines/secs);
+    return 0;
+}
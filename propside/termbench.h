@@ -0,0 +1,36 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TERMBENCH_H
+#define TERMBENCH_H
+
+#include "qtversion.h"
+
+/*
+ * Terminal throughput benchmark. Runs a port through PortListener into a
+ * Console the way the terminal window does and reports what the console
+ * keeps up with. Use with propsim -stream for a board that never stops.
+ */
+class TerminalBench
+{
+public:
+    static int run(const QString &portName, int seconds);
+};
+
+#endif // TERMBENCH_H
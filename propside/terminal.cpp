@@ -23,7 +23,7 @@
 #define TERM_ENABLE_BUTTON
 //#endif
 
-Terminal::Terminal(QWidget *parent) : QDialog(parent), portListener(NULL), lastConnectedPortName("")
+Terminal::Terminal(QWidget *parent) : QDialog(parent), historyPos(-1), portListener(NULL), lastConnectedPortName("")
 {
     termEditor = new Console(parent);
     init();
@@ -42,9 +42,63 @@ void Terminal::init()
     pasteAction->setShortcuts(QKeySequence::Paste);
     termEditor->addAction(pasteAction);
 
-    termEditor->setMaximumBlockCount(512);
+    termEditor->setScrollbackLines(0);
     termLayout->addWidget(termEditor);
 
+    /*
+     * The terminal only shows a window of recent lines.
+     * Older lines are browsed from the scrollback in historyView.
+     */
+    historyView = new QPlainTextEdit(this);
+    historyView->setReadOnly(true);
+    historyView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    historyView->setFont(termEditor->font());
+    historyView->setVisible(false);
+    termLayout->addWidget(historyView);
+
+    QHBoxLayout *findLayout = new QHBoxLayout();
+    termLayout->addLayout(findLayout);
+
+    findEdit = new QLineEdit(this);
+#ifdef QT5
+    findEdit->setPlaceholderText(tr("Find in history"));
+#endif
+    connect(findEdit,SIGNAL(textChanged(QString)),this,SLOT(findIncremental(QString)));
+    connect(findEdit,SIGNAL(returnPressed()),this,SLOT(findNext()));
+    findLayout->addWidget(findEdit);
+
+    QAction *findAction = new QAction(tr("Find"),this);
+    findAction->setShortcuts(QKeySequence::Find);
+    connect(findAction,SIGNAL(triggered()),findEdit,SLOT(setFocus()));
+    termEditor->addAction(findAction);
+
+    QPushButton *buttonPrev = new QPushButton(tr("Previous"),this);
+    connect(buttonPrev,SIGNAL(clicked()), this, SLOT(findPrevious()));
+    buttonPrev->setAutoDefault(false);
+    findLayout->addWidget(buttonPrev);
+
+    QPushButton *buttonNext = new QPushButton(tr("Next"),this);
+    connect(buttonNext,SIGNAL(clicked()), this, SLOT(findNext()));
+    buttonNext->setAutoDefault(false);
+    findLayout->addWidget(buttonNext);
+
+    gotoSpin = new QSpinBox(this);
+    gotoSpin->setRange(1, INT_MAX);
+    findLayout->addWidget(gotoSpin);
+
+    QPushButton *buttonGoto = new QPushButton(tr("Go To Line"),this);
+    connect(buttonGoto,SIGNAL(clicked()), this, SLOT(gotoLine()));
+    buttonGoto->setAutoDefault(false);
+    findLayout->addWidget(buttonGoto);
+
+    QPushButton *buttonLive = new QPushButton(tr("Live"),this);
+    connect(buttonLive,SIGNAL(clicked()), this, SLOT(showLive()));
+    buttonLive->setAutoDefault(false);
+    findLayout->addWidget(buttonLive);
+
+    historyLabel = new QLabel(this);
+    findLayout->addWidget(historyLabel);
+
     QPushButton *buttonClear = new QPushButton(tr("Clear"),this);
     connect(buttonClear,SIGNAL(clicked()), this, SLOT(clearScreen()));
     buttonClear->setAutoDefault(false);
@@ -195,7 +249,7 @@ void Terminal::accept()
     buttonEnable->setText("Disable");
 #endif
     // save terminal geometry
-    QSettings *settings = new QSettings(publisherKey, ASideGuiKey, this);
+    SettingsCache *settings = SettingsCache::instance();
     if(settings->value(useKeys).toInt() == 1) {
         QByteArray geo = this->saveGeometry();
         settings->setValue(termGeometryKey,geo);
@@ -211,7 +265,7 @@ void Terminal::reject()
     buttonEnable->setText("Disable");
 #endif
     // save terminal geometry
-    QSettings *settings = new QSettings(publisherKey, ASideGuiKey, this);
+    SettingsCache *settings = SettingsCache::instance();
     QByteArray geo = this->saveGeometry();
     settings->setValue(termGeometryKey,geo);
     termEditor->setPortEnable(false);
@@ -222,6 +276,103 @@ void Terminal::reject()
 void Terminal::clearScreen()
 {
     termEditor->clear();
+    showLive();
+}
+
+void Terminal::findIncremental(const QString &text)
+{
+    qint64 from = historyPos;
+    if(from < termEditor->historyFirstLine())
+        from = termEditor->historyFirstLine();
+    qint64 line = termEditor->findInHistory(text, from, true);
+    if(line < 0)
+        line = termEditor->findInHistory(text, termEditor->historyFirstLine(), true);
+    if(line > -1)
+        showHistoryLine(line);
+    else
+        historyLabel->setText(text.isEmpty() ? "" : tr("Not found"));
+}
+
+void Terminal::findNext()
+{
+    QString text = findEdit->text();
+    qint64 line = termEditor->findInHistory(text, historyPos+1, true);
+    if(line < 0)
+        line = termEditor->findInHistory(text, termEditor->historyFirstLine(), true);
+    if(line > -1)
+        showHistoryLine(line);
+}
+
+void Terminal::findPrevious()
+{
+    QString text = findEdit->text();
+    qint64 line = -1;
+    if(historyPos > termEditor->historyFirstLine())
+        line = termEditor->findInHistory(text, historyPos-1, false);
+    if(line < 0)
+        line = termEditor->findInHistory(text, termEditor->historyEndLine()-1, false);
+    if(line > -1)
+        showHistoryLine(line);
+}
+
+void Terminal::gotoLine()
+{
+    qint64 line = gotoSpin->value()-1;
+    if(line < termEditor->historyFirstLine())
+        line = termEditor->historyFirstLine();
+    if(line >= termEditor->historyEndLine())
+        line = termEditor->historyEndLine()-1;
+    if(line > -1)
+        showHistoryLine(line);
+}
+
+void Terminal::showLive()
+{
+    historyPos = -1;
+    historyView->setVisible(false);
+    historyLabel->setText("");
+    termEditor->setExtraSelections(QList<QTextEdit::ExtraSelection>());
+    termEditor->moveCursor(QTextCursor::End);
+    termEditor->ensureCursorVisible();
+}
+
+/*
+ * Lines still in the terminal window are highlighted in place.
+ * Lines in the scrollback are shown in historyView with a window
+ * of lines around them. The console cursor is never moved here
+ * because incoming data is written at the cursor.
+ */
+void Terminal::showHistoryLine(qint64 line)
+{
+    QTextEdit::ExtraSelection sel;
+    sel.format.setBackground(QColor(Qt::yellow));
+    sel.format.setProperty(QTextFormat::FullWidthSelection, true);
+    QList<QTextEdit::ExtraSelection> list;
+
+    historyPos = line;
+    historyLabel->setText(tr("Line %1 of %2").arg(line+1).arg(termEditor->historyEndLine()));
+
+    if(line >= termEditor->historyWindowLine()) {
+        historyView->setVisible(false);
+        QTextBlock block = termEditor->document()->findBlockByNumber((int)(line - termEditor->historyWindowLine()));
+        sel.cursor = QTextCursor(block);
+        list.append(sel);
+        termEditor->setExtraSelections(list);
+        termEditor->verticalScrollBar()->setValue(block.blockNumber());
+        return;
+    }
+
+    qint64 start = line - HistoryWindow/2;
+    if(start < termEditor->historyFirstLine())
+        start = termEditor->historyFirstLine();
+    historyView->setPlainText(termEditor->historyLines(start, HistoryWindow).join("\n"));
+    historyView->setVisible(true);
+
+    QTextBlock block = historyView->document()->findBlockByNumber((int)(line - start));
+    sel.cursor = QTextCursor(block);
+    list.append(sel);
+    historyView->setExtraSelections(list);
+    historyView->verticalScrollBar()->setValue(block.blockNumber() > 4 ? block.blockNumber()-4 : 0);
 }
 
 void Terminal::toggleEnable()
@@ -55,6 +55,7 @@ signals:
 
 private:
     void init();
+    void showHistoryLine(qint64 line);
 
 public slots:
     void baudRateChange(int index);
@@ -66,6 +67,11 @@ public slots:
     void cutFromFile();
     void pasteToFile();
     void showOptions();
+    void findIncremental(const QString &text);
+    void findNext();
+    void findPrevious();
+    void gotoLine();
+    void showLive();
 
 public:
     Console *getEditor();
@@ -76,6 +82,13 @@ private:
     QCheckBox   *cbEchoOn;
     QLabel      portLabel;
 
+    enum { HistoryWindow = 256 };
+    QPlainTextEdit *historyView;
+    QLineEdit   *findEdit;
+    QSpinBox    *gotoSpin;
+    QLabel      *historyLabel;
+    qint64      historyPos;
+
 private:
     QPushButton     *buttonEnable;
     PortListener    *portListener;
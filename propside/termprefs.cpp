@@ -38,7 +38,7 @@ TermPrefs::TermPrefs(Terminal *term) : ui(new Ui::TermPrefs)
     QCoreApplication::setApplicationName(ASideGuiKey);
 
     /* global settings */
-    settings = new QSettings(QString(publisherKey), QString(ASideGuiKey));
+    settings = SettingsCache::instance();
 
     /* the order of these settings is critical for read/save */
     settingNames.clear();
@@ -103,7 +103,6 @@ TermPrefs::TermPrefs(Terminal *term) : ui(new Ui::TermPrefs)
 
 TermPrefs::~TermPrefs()
 {
-    delete settings;
 }
 
 void TermPrefs::resetSettings()
@@ -309,6 +308,7 @@ void TermPrefs::saveSettings()
     int lines = 512;
     settings->setValue(termKeyBufferLines,lineindex);
     QString s = ui->comboBoxBufferLines->itemText(lineindex);
+    settings->setValue(termKeyScrollbackLines,s);
     if(s.contains("infinite",Qt::CaseInsensitive)) {
         lines = 0; // 0 or -1 says buffer is infinite
     }
@@ -317,7 +317,7 @@ void TermPrefs::saveSettings()
         int temp = s.toInt(&ok, 10);
         if(ok) lines = temp;
     }
-    serialConsole->setMaximumBlockCount(lines);
+    serialConsole->setScrollbackLines(lines);
 
     /*
      * save tab size
@@ -577,6 +577,15 @@ void TermPrefs::readSettings()
     var = settings->value(termKeyBufferLines,QVariant(6));
     if(var.canConvert(QVariant::Int)) {
         lineindex = var.toInt();
+        /*
+         * Scrollback sizes were added before Infinite, so use the saved
+         * text if there is one. Older settings only have the index.
+         */
+        int found = ui->comboBoxBufferLines->findText(settings->value(termKeyScrollbackLines,QVariant("")).toString());
+        if(found > -1)
+            lineindex = found;
+        else if(lineindex == 7)
+            lineindex = ui->comboBoxBufferLines->count()-1;
         ui->comboBoxBufferLines->setCurrentIndex(lineindex);
         QString s = ui->comboBoxBufferLines->itemText(lineindex);
 
@@ -589,7 +598,7 @@ void TermPrefs::readSettings()
             if(ok) lines = temp;
         }
     }
-    serialConsole->setMaximumBlockCount(lines);
+    serialConsole->setScrollbackLines(lines);
 
     /*
      * read tab size
@@ -667,7 +676,6 @@ int  TermPrefs::getBaudRate()
 void TermPrefs::saveBaudRate(int baud)
 {
     settings->setValue(termKeyBaudRate,baud);
-    settings->sync();
 }
 
 bool TermPrefs::getEchoOn()
@@ -678,7 +686,6 @@ bool TermPrefs::getEchoOn()
 void TermPrefs::saveEchoOn(bool echoOn)
 {
     settings->setValue(termKeyEchoOn,echoOn);
-    settings->sync();
 }
 
 
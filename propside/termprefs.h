@@ -61,6 +61,7 @@ class TermPrefs;
 #define termKeyWrapMode             appNameKey "_termWrapMode"
 #define termKeyPageLineSize         appNameKey "_termPageLineSize"
 #define termKeyBufferLines          appNameKey "_termBufferLines"
+#define termKeyScrollbackLines      appNameKey "_termScrollbackLines"
 #define termKeyTabSize              appNameKey "_termTabSize"
 #define termKeyHexMode              appNameKey "_termHexMode"
 #define termKeyHexDump              appNameKey "_termHexDumpMode"
@@ -100,7 +101,7 @@ private:
     Ui::TermPrefs  *ui;
     Terminal       *terminal;
     Console        *serialConsole;
-    QSettings      *settings;
+    SettingsCache  *settings;
     QStringList     settingNames;
 
     QVector<PColor*> propertyColors;
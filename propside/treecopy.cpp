@@ -0,0 +1,189 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "treecopy.h"
+#include "directory.h"
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
+#endif
+
+/* files per pool job; keeps queueing overhead low for small sources */
+#define COPY_BATCH 32
+
+class TreeCopy::CopyJob : public QRunnable
+{
+public:
+    CopyJob(TreeCopy *owner, int first, int count)
+        : owner(owner), first(first), count(count) {}
+
+    void run()
+    {
+        int fails = 0;
+        qint64 size = 0;
+        for(int n = first; n < first+count; n++) {
+            const QPair<QString, QString> &item = owner->files.at(n);
+            if(copyFile(item.first, item.second))
+                size += QFileInfo(item.second).size();
+            else
+                fails++;
+        }
+        owner->finished(count, fails, size);
+    }
+
+private:
+    TreeCopy *owner;
+    int first;
+    int count;
+};
+
+TreeCopy::TreeCopy(QObject *parent) :
+    QObject(parent), done(0), failed(0), bytes(0)
+{
+}
+
+bool TreeCopy::copy(QString srcdir, QString dstdir, QString notlist)
+{
+    if(srcdir.length() < 1 || dstdir.length() < 1)
+        return false;
+
+    filters.clear();
+    foreach(QString item, notlist.split(" ", QString::SkipEmptyParts))
+        filters.append(QRegExp(item, Qt::CaseSensitive, QRegExp::Wildcard));
+
+    if(!srcdir.endsWith("/"))
+        srcdir += '/';
+    if(!dstdir.endsWith("/"))
+        dstdir += '/';
+
+    if(QDir(srcdir).exists() == false)
+        return false;
+    if(Directory::isPossibleInfiniteFolder(srcdir, dstdir))
+        return false;
+
+    files.clear();
+    done = 0;
+    failed = 0;
+    bytes = 0;
+    walk(srcdir, dstdir);
+
+    QThreadPool pool;
+    for(int n = 0; n < files.count(); n += COPY_BATCH)
+        pool.start(new CopyJob(this, n, qMin(COPY_BATCH, files.count()-n)));
+
+    while(!pool.waitForDone(50)) {
+        mutex.lock();
+        int count = done;
+        mutex.unlock();
+        emit progress(count, files.count());
+        QCoreApplication::processEvents();
+    }
+    emit progress(files.count(), files.count());
+
+    return failed == 0;
+}
+
+bool TreeCopy::isFiltered(const QString &name) const
+{
+    foreach(const QRegExp &reg, filters) {
+        if(reg.exactMatch(name))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Make the destination folders and collect the files to copy.
+ */
+void TreeCopy::walk(const QString &srcdir, const QString &dstdir)
+{
+    QDir().mkpath(dstdir);
+    QFileInfoList list = QDir(srcdir).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
+    foreach(QFileInfo info, list) {
+        QString name = info.fileName();
+        if(isFiltered(name))
+            continue;
+        if(info.isDir())
+            walk(srcdir+name+"/", dstdir+name+"/");
+        else
+            files.append(qMakePair(srcdir+name, dstdir+name));
+    }
+}
+
+void TreeCopy::finished(int count, int fails, qint64 size)
+{
+    QMutexLocker lock(&mutex);
+    done += count;
+    failed += fails;
+    bytes += size;
+}
+
+/*
+ * Replace dst with a copy of src. On Linux a reflink is tried first,
+ * then copy_file_range so the data never passes through user space.
+ */
+bool TreeCopy::copyFile(const QString &src, const QString &dst)
+{
+    if(QFile::exists(dst))
+        QFile::remove(dst);
+
+#if defined(Q_OS_LINUX)
+    QByteArray sname = QFile::encodeName(src);
+    QByteArray dname = QFile::encodeName(dst);
+    int in = ::open(sname.constData(), O_RDONLY);
+    if(in >= 0) {
+        struct stat st;
+        if(fstat(in, &st) == 0 && S_ISREG(st.st_mode)) {
+            int out = ::open(dname.constData(), O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 07777);
+            if(out >= 0) {
+                bool ok = false;
+#ifdef FICLONE
+                ok = ioctl(out, FICLONE, in) == 0;
+#endif
+#ifdef __NR_copy_file_range
+                if(!ok) {
+                    off_t left = st.st_size;
+                    ssize_t len = 1;
+                    while(left > 0 && len > 0) {
+                        len = syscall(__NR_copy_file_range, in, NULL, out, NULL, (size_t)left, 0);
+                        if(len > 0)
+                            left -= len;
+                    }
+                    ok = (left == 0);
+                }
+#endif
+                ::close(out);
+                if(ok) {
+                    ::close(in);
+                    return true;
+                }
+                ::unlink(dname.constData());
+            }
+        }
+        ::close(in);
+    }
+#endif
+
+    return QFile::copy(src, dst);
+}
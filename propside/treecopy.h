@@ -0,0 +1,63 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TREECOPY_H
+#define TREECOPY_H
+
+#include <QtCore>
+
+/*
+ * Copies a folder tree. The tree is walked once with the filters
+ * compiled up front, then files are copied on a thread pool while the
+ * calling thread keeps processing events and reports progress.
+ */
+class TreeCopy : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TreeCopy(QObject *parent = 0);
+
+    bool copy(QString srcdir, QString dstdir, QString notlist = "");
+
+    int    fileCount() const { return files.count(); }
+    int    failedCount() const { return failed; }
+    qint64 bytesCopied() const { return bytes; }
+
+    static bool copyFile(const QString &src, const QString &dst);
+
+signals:
+    void progress(int done, int total);
+
+private:
+    class CopyJob;
+
+    bool isFiltered(const QString &name) const;
+    void walk(const QString &srcdir, const QString &dstdir);
+    void finished(int count, int fails, qint64 size);
+
+    QList<QRegExp> filters;
+    QList<QPair<QString, QString> > files;
+
+    QMutex  mutex;
+    int     done;
+    int     failed;
+    qint64  bytes;
+};
+
+#endif // TREECOPY_H
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "treeremove.h"
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#endif
+
+class TreeRemove::RemoveJob : public QRunnable
+{
+public:
+    RemoveJob(TreeRemove *owner, const QString &dir)
+        : owner(owner), dir(dir), count(0), fails(0), size(0) {}
+
+    void run()
+    {
+#if defined(Q_OS_UNIX)
+        QByteArray name = QFile::encodeName(dir);
+        removeAt(AT_FDCWD, name.constData());
+#else
+        removeDir(dir);
+#endif
+        owner->removed(count, fails, size);
+    }
+
+private:
+#if defined(Q_OS_UNIX)
+    void removeAt(int parentfd, const char *name)
+    {
+        int fd = openat(parentfd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+        if(fd < 0) {
+            fails++;
+            return;
+        }
+        DIR *dp = fdopendir(fd);
+        if(dp == NULL) {
+            close(fd);
+            fails++;
+            return;
+        }
+        struct dirent *ent;
+        while((ent = readdir(dp)) != NULL) {
+            if(strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+                continue;
+            struct stat st;
+            if(fstatat(fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                fails++;
+                continue;
+            }
+            if(S_ISDIR(st.st_mode)) {
+                removeAt(fd, ent->d_name);
+            }
+            else if(unlinkat(fd, ent->d_name, 0) == 0) {
+                count++;
+                size += st.st_size;
+            }
+            else {
+                fails++;
+            }
+        }
+        closedir(dp);
+        if(unlinkat(parentfd, name, AT_REMOVEDIR) != 0)
+            fails++;
+    }
+#else
+    void removeDir(const QString &path)
+    {
+        QDir dpath(path);
+        QFileInfoList list = dpath.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+        foreach(QFileInfo info, list) {
+            if(info.isDir() && !info.isSymLink()) {
+                removeDir(info.filePath());
+            }
+            else {
+                qint64 len = info.size();
+                if(QFile::remove(info.filePath())) {
+                    count++;
+                    size += len;
+                }
+                else {
+                    fails++;
+                }
+            }
+        }
+        if(!dpath.rmdir(path))
+            fails++;
+    }
+#endif
+
+    TreeRemove *owner;
+    QString     dir;
+    int         count;
+    int         fails;
+    qint64      size;
+};
+
+TreeRemove::TreeRemove(QObject *parent) :
+    QObject(parent), files(0), failed(0), bytes(0)
+{
+}
+
+bool TreeRemove::remove(QString dir)
+{
+    return remove(QStringList(dir));
+}
+
+/*
+ * Files directly inside each folder are removed here; every subfolder
+ * becomes a pool job. The caller keeps processing events until done.
+ */
+bool TreeRemove::remove(QStringList dirs)
+{
+    files = 0;
+    failed = 0;
+    bytes = 0;
+
+    QThreadPool pool;
+    QStringList roots;
+    foreach(QString dir, dirs) {
+        if(dir.length() < 1)
+            continue;
+        if(dir.endsWith("/"))
+            dir = dir.left(dir.length()-1);
+        QFileInfo info(dir);
+        if(!info.exists() || !info.isDir() || info.isSymLink())
+            continue;
+        roots.append(dir);
+
+        QFileInfoList list = QDir(dir).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+        foreach(QFileInfo entry, list) {
+            if(entry.isDir() && !entry.isSymLink()) {
+                pool.start(new RemoveJob(this, entry.filePath()));
+            }
+            else {
+                qint64 len = entry.size();
+                if(QFile::remove(entry.filePath()))
+                    removed(1, 0, len);
+                else
+                    removed(0, 1, 0);
+            }
+        }
+    }
+
+    while(!pool.waitForDone(50)) {
+        mutex.lock();
+        int count = files;
+        qint64 size = bytes;
+        mutex.unlock();
+        emit progress(count, size);
+        QCoreApplication::processEvents();
+    }
+
+    foreach(QString dir, roots) {
+        if(!QDir().rmdir(dir))
+            removed(0, 1, 0);
+    }
+    emit progress(files, bytes);
+    return failed == 0;
+}
+
+void TreeRemove::removed(int count, int fails, qint64 size)
+{
+    QMutexLocker lock(&mutex);
+    files += count;
+    failed += fails;
+    bytes += size;
+}
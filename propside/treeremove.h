@@ -0,0 +1,57 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TREEREMOVE_H
+#define TREEREMOVE_H
+
+#include <QtCore>
+
+/*
+ * Removes folder trees on a thread pool. Each top level folder is its
+ * own job; on unix the walk uses openat/unlinkat relative to the parent
+ * descriptor and never follows symbolic links.
+ */
+class TreeRemove : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TreeRemove(QObject *parent = 0);
+
+    bool remove(QString dir);
+    bool remove(QStringList dirs);
+
+    int    fileCount() const { return files; }
+    int    failedCount() const { return failed; }
+    qint64 bytesFreed() const { return bytes; }
+
+signals:
+    void progress(int files, qint64 bytes);
+
+private:
+    class RemoveJob;
+
+    void removed(int count, int fails, qint64 size);
+
+    QMutex  mutex;
+    int     files;
+    int     failed;
+    qint64  bytes;
+};
+
+#endif // TREEREMOVE_H
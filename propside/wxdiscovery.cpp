@@ -0,0 +1,226 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wxdiscovery.h"
+#include "xbeeserialport.h"
+
+WxDiscovery::WxDiscovery(QObject *parent) : QObject(parent)
+{
+    requestsLeft = 0;
+    ttl = TTL_MS;
+
+    socket.bind(QHostAddress::Any, 0);
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readReplies()));
+
+    requestTimer.setInterval(REQUEST_INTERVAL_MS);
+    connect(&requestTimer, SIGNAL(timeout()), this, SLOT(sendRequest()));
+
+    /* keep the cache fresh so opening the port list never has to wait */
+    refreshTimer.setInterval(REFRESH_MS);
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(discover()));
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(expire()));
+    refreshTimer.start();
+}
+
+void WxDiscovery::setTtl(int msecs)
+{
+    ttl = msecs;
+}
+
+/*
+ * Returns the modules seen within the TTL. Never blocks.
+ */
+QList<WxPortInfo> WxDiscovery::ports()
+{
+    QList<WxPortInfo> list;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    foreach(WxEntry entry, cache) {
+        if(now - entry.seen < ttl)
+            list.append(entry.info);
+    }
+    return list;
+}
+
+/*
+ * Start a discovery round. The broadcast is repeated a few times because
+ * UDP gets lost on busy WiFi. Replies arrive through readReplies.
+ */
+void WxDiscovery::discover()
+{
+    if(requestTimer.isActive())
+        return;
+    requestsLeft = REQUEST_COUNT;
+    sendRequest();
+    requestTimer.start();
+}
+
+void WxDiscovery::sendRequest()
+{
+    if(requestsLeft-- < 1) {
+        requestTimer.stop();
+        return;
+    }
+
+    /*
+     * A zero long followed by the addresses that already answered this round,
+     * so those modules don't answer again.
+     */
+    QByteArray packet(4, '\0');
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    foreach(WxEntry entry, cache) {
+        if(now - entry.seen > REQUEST_COUNT*REQUEST_INTERVAL_MS)
+            continue;
+        quint32 ip = qToBigEndian(QHostAddress(entry.info.ipAddr).toIPv4Address());
+        packet.append((const char *) &ip, sizeof(ip));
+    }
+
+    QByteArray xbee = XBeeSerialPort::queryPacket(xbNodeID);
+
+    QList<QHostAddress> sent;
+    foreach(QNetworkInterface iface, QNetworkInterface::allInterfaces()) {
+        if(!(iface.flags() & QNetworkInterface::IsUp) || !(iface.flags() & QNetworkInterface::CanBroadcast))
+            continue;
+        foreach(QNetworkAddressEntry entry, iface.addressEntries()) {
+            QHostAddress bcast = entry.broadcast();
+            if(bcast.isNull() || bcast.protocol() != QAbstractSocket::IPv4Protocol || sent.contains(bcast))
+                continue;
+            socket.writeDatagram(packet, bcast, DISCOVER_PORT);
+            socket.writeDatagram(xbee, bcast, XBEE_APP_PORT);
+            sent.append(bcast);
+        }
+    }
+    if(sent.isEmpty()) {
+        socket.writeDatagram(packet, QHostAddress::Broadcast, DISCOVER_PORT);
+        socket.writeDatagram(xbee, QHostAddress::Broadcast, XBEE_APP_PORT);
+    }
+}
+
+void WxDiscovery::readReplies()
+{
+    bool changed = false;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    while(socket.hasPendingDatagrams()) {
+        QByteArray data;
+        QHostAddress sender;
+        data.resize(socket.pendingDatagramSize());
+        socket.readDatagram(data.data(), data.size(), &sender);
+
+        WxPortInfo info;
+        if(!parseReply(data, sender, info) && !parseXBeeReply(data, sender, info))
+            continue;
+
+        /* modules with the same name get the ip address appended like wxProcFinished does */
+        QMap<QString, WxEntry>::iterator it;
+        for(it = cache.begin(); it != cache.end(); ++it) {
+            if(it.key() != info.ipAddr && it.value().info.portName.compare(info.portName, Qt::CaseInsensitive) == 0) {
+                info.portName += "-" + info.ipAddr;
+                break;
+            }
+        }
+
+        if(!cache.contains(info.ipAddr) || cache.value(info.ipAddr).info.portName != info.portName ||
+                now - cache.value(info.ipAddr).seen >= ttl) {
+            changed = true;
+        }
+        WxEntry entry;
+        entry.info = info;
+        entry.seen = now;
+        cache.insert(info.ipAddr, entry);
+    }
+    if(changed)
+        emit portsChanged();
+}
+
+void WxDiscovery::expire()
+{
+    bool changed = false;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QMap<QString, WxEntry>::iterator it = cache.begin();
+    while(it != cache.end()) {
+        if(now - it.value().seen >= ttl) {
+            it = cache.erase(it);
+            changed = true;
+        }
+        else {
+            ++it;
+        }
+    }
+    if(changed)
+        emit portsChanged();
+}
+
+/*
+ * A reply looks like this. The IP address is the sender of the datagram.
+ * { "name": "wx-8a6e42", "description": "...", "reset pin": "12",
+ *   "rx pullup": "disabled", "mac address": "18:fe:34:8a:6e:42" }
+ */
+bool WxDiscovery::parseReply(const QByteArray &data, const QHostAddress &sender, WxPortInfo &info)
+{
+    QString str = QString::fromUtf8(data);
+    QRegExp namere("\"name\"\\s*:\\s*\"([^\"]*)\"");
+    QRegExp macre("\"mac address\"\\s*:\\s*\"([^\"]*)\"");
+
+    if(namere.indexIn(str) < 0)
+        return false;
+
+    QHostAddress ip(sender.toIPv4Address());
+    info.ipAddr = ip.toString();
+    info.portName = namere.cap(1).toUpper().replace("'","").trimmed();
+    info.VendorName = "";
+    info.macUpper = "";
+    info.macAddr = "";
+
+    if(macre.indexIn(str) > -1) {
+        QStringList fs = macre.cap(1).toUpper().split(":", QString::SkipEmptyParts);
+        if(fs.length() == 6) {
+            info.macUpper = fs[0]+fs[1]+fs[2];
+            info.macAddr  = fs[3]+fs[4]+fs[5];
+        }
+    }
+    if(info.portName.length() == 0)
+        info.portName = "X-"+info.macAddr;
+    return true;
+}
+
+/*
+ * An XBee answers the node ID query with the application service reply
+ * header followed by the node ID. The IP address is the sender.
+ */
+bool WxDiscovery::parseXBeeReply(const QByteArray &data, const QHostAddress &sender, WxPortInfo &info)
+{
+    char cmd[2];
+    QByteArray value;
+    if(!XBeeSerialPort::parseReply(data, cmd, value) || cmd[0] != 'N' || cmd[1] != 'I')
+        return false;
+    int end = value.indexOf('\0');
+    if(end > -1)
+        value.truncate(end);
+
+    QHostAddress ip(sender.toIPv4Address());
+    info.ipAddr = ip.toString();
+    info.portName = QString::fromLatin1(value).toUpper().replace("'","").trimmed();
+    info.VendorName = "XBee";
+    info.macUpper = "";
+    info.macAddr = "";
+
+    if(info.portName.length() == 0)
+        info.portName = "XBEE-"+info.ipAddr;
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the Parallax Propeller SimpleIDE development environment.
+ *
+ * Copyright (C) 2014 Parallax Incorporated
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WXDISCOVERY_H
+#define WXDISCOVERY_H
+
+#include <QtCore>
+#include <QtNetwork>
+
+struct WxPortInfo {
+    QString portName;   ///< Port name
+    QString VendorName; ///< Vendor name
+    QString ipAddr;     ///< IP Address
+    QString macUpper;   ///< MAC Addr upper
+    QString macAddr;    ///< MAC Address
+};
+
+/*
+ * WxDiscovery finds Parallax WX modules the same way proploader -W does,
+ * but in process and without blocking. A UDP broadcast goes to the
+ * discovery port of every interface and modules answer with a short
+ * JSON description. XBee Wi-Fi modules are asked for their node ID on
+ * the XBee application port in the same round; their VendorName is
+ * "XBee". Replies update a cache; entries expire after a TTL unless a
+ * later discovery sees them again.
+ */
+class WxDiscovery : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WxDiscovery(QObject *parent = 0);
+
+    QList<WxPortInfo> ports();
+    void setTtl(int msecs);
+
+signals:
+    void portsChanged();
+
+public slots:
+    void discover();
+
+private slots:
+    void sendRequest();
+    void readReplies();
+    void expire();
+
+private:
+    enum { DISCOVER_PORT = 32420 };
+    enum { REQUEST_COUNT = 3, REQUEST_INTERVAL_MS = 200 };
+    enum { REFRESH_MS = 10000, TTL_MS = 30000 };
+
+    bool parseReply(const QByteArray &data, const QHostAddress &sender, WxPortInfo &info);
+    bool parseXBeeReply(const QByteArray &data, const QHostAddress &sender, WxPortInfo &info);
+
+    struct WxEntry {
+        WxPortInfo  info;
+        qint64      seen;
+    };
+
+    QUdpSocket  socket;
+    QTimer      requestTimer;
+    QTimer      refreshTimer;
+    int         requestsLeft;
+    int         ttl;
+    QMap<QString, WxEntry> cache;
+};
+
+#endif // WXDISCOVERY_H
@@ -1,9 +1,21 @@
-#include "console.h"
 #include "xbeeserialport.h"
 
 XBeeSerialPort::XBeeSerialPort(QObject *parent) : QObject(parent)
 {
     isopen = false;
+    nextFrameID = 1;
+    failed = 0;
+    baud = 0;
+    myhostaddr = 0;
+    remoteaddr = 0;
+
+    retryTimer.setInterval(FRAME_TIMEOUT_MS/4);
+    connect(&retryTimer, SIGNAL(timeout()), this, SLOT(retryFrames()));
+}
+
+XBeeSerialPort::~XBeeSerialPort()
+{
+    close();
 }
 
 bool XBeeSerialPort::open(QHostAddress addr, qint64 baudrate)
@@ -18,21 +30,26 @@ bool XBeeSerialPort::open(QHostAddress addr, qint64 baudrate)
     remoteaddr = addr.toIPv4Address();
     baud = baudrate;
 
-    setItem(xbSerialIP, serialUDP);             // Ensure XBee's Serial Service uses UDP packets [WRITE DISABLED DUE TO FIRMWARE BUG]
-    setItem(xbIPDestination, myhostaddr);       // Ensure Serial-to-IP destination is us (our IP)
-    setItem(xbIPPort, XBEE_SER_PORT);           // Ensure Serial-to-IP port is proper (default, in this case)
-    //setItem(xbDestPort, XBEE_SER_PORT);
-    setItem(xbOutputMask, 0x7FFF);              // Ensure output mask is proper (default, in this case)
-    setItem(xbRTSFlow, pinEnabled);             // Ensure RTS flow pin is enabled (input)
-    setItem(xbIO4Mode, pinOutLow);              // Ensure serial hold pin is set to output low
-    setItem(xbIO2Mode, pinOutHigh);             // Ensure reset pin is set to output high
-    setItem(xbIO4Timer, 2);                     // Ensure serial hold pin's timer is set to 200 ms
-    setItem(xbIO2Timer, 1);                     // Ensure reset pin's timer is set to 100 ms
-    setItem(xbSerialMode, transparentMode);     // Ensure Serial Mode is transparent [WRITE DISABLED DUE TO FIRMWARE BUG]
-    setItem(xbSerialBaud, this->baudRate());    // Ensure baud rate is set to initial speed
-    setItem(xbSerialParity, parityNone);        // Ensure parity is none
-    setItem(xbSerialStopBits, stopBits1);       // Ensure stop bits is 1
-    setItem(xbPacketingTimeout, 3);             // Ensure packetization timout is 3 character times
+    /*
+     * Configuration is sent as one pipelined batch instead of
+     * a round trip per item.
+     */
+    queueItem(xbSerialIP, serialUDP);           // Ensure XBee's Serial Service uses UDP packets [WRITE DISABLED DUE TO FIRMWARE BUG]
+    queueItem(xbIPDestination, myhostaddr);     // Ensure Serial-to-IP destination is us (our IP)
+    queueItem(xbIPPort, XBEE_SER_PORT);         // Ensure Serial-to-IP port is proper (default, in this case)
+    //queueItem(xbDestPort, XBEE_SER_PORT);
+    queueItem(xbOutputMask, 0x7FFF);            // Ensure output mask is proper (default, in this case)
+    queueItem(xbRTSFlow, pinEnabled);           // Ensure RTS flow pin is enabled (input)
+    queueItem(xbIO4Mode, pinOutLow);            // Ensure serial hold pin is set to output low
+    queueItem(xbIO2Mode, pinOutHigh);           // Ensure reset pin is set to output high
+    queueItem(xbIO4Timer, 2);                   // Ensure serial hold pin's timer is set to 200 ms
+    queueItem(xbIO2Timer, 1);                   // Ensure reset pin's timer is set to 100 ms
+    queueItem(xbSerialMode, transparentMode);   // Ensure Serial Mode is transparent [WRITE DISABLED DUE TO FIRMWARE BUG]
+    queueItem(xbSerialBaud, this->baudRate());  // Ensure baud rate is set to initial speed
+    queueItem(xbSerialParity, parityNone);      // Ensure parity is none
+    queueItem(xbSerialStopBits, stopBits1);     // Ensure stop bits is 1
+    queueItem(xbPacketingTimeout, 3);           // Ensure packetization timout is 3 character times
+    sendQueued();
 
     if (isOpen()) close();
 
@@ -46,16 +63,16 @@ bool XBeeSerialPort::open(QHostAddress addr, qint64 baudrate)
      * socket.connectToHost(addr, XBEE_SER_PORT) needs to be called.
      */
     if (!socket.bind(XBEE_SER_PORT, QAbstractSocket::ShareAddress))
-        return -1;
+        return false;
 
     /*
-     * We will poll for incoming data the same way we do for the serial driver.
-     * If we go event driven, then we need to connect readyRead();
-     * connect(&socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
+     * Event driven like the Telnet based Wifi port.
+     * The terminal reads the datagrams when updateEvent arrives.
      */
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
 
     isopen = true;
-    return 0;
+    return true;
 }
 
 bool XBeeSerialPort::isOpen()
@@ -72,8 +89,17 @@ bool XBeeSerialPort::isSequential() const
 void XBeeSerialPort::close()
 {
     if (isopen || socket.isOpen()) {
+        disconnect(&socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
         socket.close();
     }
+    retryTimer.stop();
+    frames.clear();
+    queued.clear();
+    inFlight.clear();
+    if (appSocket.state() == QUdpSocket::BoundState) {
+        disconnect(&appSocket, SIGNAL(readyRead()), this, SLOT(appReadyRead()));
+        appSocket.close();
+    }
     isopen = false;
 }
 
@@ -89,18 +115,9 @@ void XBeeSerialPort::flush()
     }
 }
 
-/*
- * not used
- */
 void XBeeSerialPort::readyRead()
 {
-    char buf[BUFSIZ];
-    if (socket.state() != QUdpSocket::BoundState) return;
-    int rc = socket.pendingDatagramSize();
-    rc = (rc < BUFSIZ) ? rc : BUFSIZ-1;
-    socket.readDatagram(buf, rc);
-    buf[rc] = 0;
-    rxdata += QByteArray(buf);
+    emit updateEvent(this);
 }
 
 qint64 XBeeSerialPort::bytesAvailable() const
@@ -154,86 +171,239 @@ QString XBeeSerialPort::portName() const
 /*
  * functions taken from David's file
  */
-int XBeeSerialPort::setItem(xbCommand cmd, const QString value)
+static const char *atCmd[] = {
+    "", "SH", "SL", "ID", "MY", "MK", "GW",
+    "C0", "DL", "NI", "NP", "RO",
+    "D2", "D4", "OM", "IO", "T2", "T4",
+    "AP", "BD", "NB", "SB", "D6",
+    "IP", "VR", "HV", "HS", "CK"
+};
+
+/*
+ * A remote AT query on its own, for broadcasting to every module.
+ */
+QByteArray XBeeSerialPort::queryPacket(xbCommand cmd)
 {
-    const int MYBUFSIZE = 2048;
-    uint8_t txBuf[MYBUFSIZE];
-    uint8_t rxBuf[MYBUFSIZE];
-    txPacket *tx = (txPacket *)txBuf;
-    rxPacket *rx = (rxPacket *)rxBuf;
-    int cnt;
+    txPacket tx;
+    tx.hdr.number1 = rand();
+    tx.hdr.number2 = tx.hdr.number1 ^ 0x4242;
+    tx.hdr.packetID = 0;
+    tx.hdr.encryptionPad = 0;
+    tx.hdr.commandID = 0x02;
+    tx.hdr.commandOptions = 0x00;
+    tx.frameID = 0x01;
+    tx.configOptions = 0x00;
+    strncpy(tx.atCommand, atCmd[cmd], 2);
+    return QByteArray((const char *)&tx, sizeof(txPacket));
+}
 
-    for (int i = 0; i < value.size(); ++i)
-        txBuf[sizeof(txPacket) + i] = value[i].toLatin1();
+bool XBeeSerialPort::parseReply(const QByteArray &data, char cmd[2], QByteArray &value)
+{
+    if (data.size() < (int)sizeof(rxPacket))
+        return false;
+    const rxPacket *rx = (const rxPacket *)data.constData();
+    if ((rx->hdr.number1 ^ rx->hdr.number2) != 0x4242 || rx->status != 0x00)
+        return false;
+    cmd[0] = rx->atCommand[0];
+    cmd[1] = rx->atCommand[1];
+    value = data.mid(sizeof(rxPacket));
+    return true;
+}
 
-    if ((cnt = sendRemoteCommand(cmd, tx, sizeof(txPacket) + value.size(), rx, sizeof(rxBuf))) == -1)
+int XBeeSerialPort::setItem(xbCommand cmd, const QString value)
+{
+    int id = queueItem(cmd, value);
+    if (id < 0)
         return -1;
-
-    return 0;
+    return sendQueued() ? -1 : 0;
 }
 
 int XBeeSerialPort::setItem(xbCommand cmd, int value)
 {
-    const int MYBUFSIZE = 2048;
-    uint8_t txBuf[MYBUFSIZE];
-    uint8_t rxBuf[MYBUFSIZE];
-    txPacket *tx = (txPacket *)txBuf;
-    rxPacket *rx = (rxPacket *)rxBuf;
-    int cnt, i;
+    int id = queueItem(cmd, value);
+    if (id < 0)
+        return -1;
+    return sendQueued() ? -1 : 0;
+}
+
+int XBeeSerialPort::queueItem(xbCommand cmd, const QString value)
+{
+    return queueCommand(cmd, value.toLatin1());
+}
+
+int XBeeSerialPort::queueItem(xbCommand cmd, int value)
+{
+    QByteArray ba;
+    for (int i = 0; i < (int)sizeof(int); ++i)
+        ba.append((char)(value >> ((sizeof(int) - i - 1) * 8)));
+    return queueCommand(cmd, ba);
+}
 
-    for (i = 0; i < (int)sizeof(int); ++i)
-        txBuf[sizeof(txPacket) + i] = value >> ((sizeof(int) - i - 1) * 8);
+int XBeeSerialPort::queueQuery(xbCommand cmd)
+{
+    return queueCommand(cmd, QByteArray());
+}
+
+int XBeeSerialPort::pendingCommands() const
+{
+    return frames.count();
+}
 
-    if ((cnt = sendRemoteCommand(cmd, tx, sizeof(txPacket) + sizeof(int), rx, sizeof(rxBuf))) == -1)
+/*
+ * Build a remote AT command frame. Frame IDs 1..255 are handed out in turn;
+ * 0 would tell the module not to reply.
+ */
+int XBeeSerialPort::queueCommand(xbCommand cmd, const QByteArray &value)
+{
+    if (frames.count() >= 255)
         return -1;
 
-    return 0;
+    while (nextFrameID == 0 || frames.contains(nextFrameID))
+        nextFrameID++;
+    quint8 id = nextFrameID++;
+
+    txPacket tx;
+    tx.hdr.packetID = 0;
+    tx.hdr.encryptionPad = 0;
+    tx.hdr.commandID = 0x02;
+    tx.hdr.commandOptions = 0x00;
+    tx.frameID = id;
+    tx.configOptions = 0x02;
+    strncpy(tx.atCommand, atCmd[cmd], 2);
+
+    XBeeFrame frame;
+    frame.cmd = cmd;
+    frame.packet = QByteArray((const char *)&tx, sizeof(txPacket)) + value;
+    frame.retries = FRAME_RETRIES;
+    frames.insert(id, frame);
+    queued.append(id);
+    return id;
 }
 
-int XBeeSerialPort::sendRemoteCommand(xbCommand cmd, txPacket *tx, int txCnt, rxPacket *rx, int rxSize)
+bool XBeeSerialPort::bindAppSocket()
 {
-    int retries, timeout, cnt;
+    if (appSocket.state() == QUdpSocket::BoundState)
+        return true;
+    if (!appSocket.bind(XBEE_APP_PORT, QAbstractSocket::ShareAddress))
+        return false;
+    connect(&appSocket, SIGNAL(readyRead()), this, SLOT(appReadyRead()));
+    return true;
+}
 
-    QUdpSocket sock;
-    QHostAddress rhaddr(remoteaddr);
+/*
+ * Each transmission gets a new packet number so a reply can be
+ * matched to its frame even if an earlier attempt answers late.
+ */
+bool XBeeSerialPort::sendFrame(XBeeFrame &frame)
+{
+    txPacket *tx = (txPacket *)frame.packet.data();
+    quint16 number = rand();
 
-    if(!sock.bind(XBEE_APP_PORT, QAbstractSocket::ShareAddress))
-        return -1;
+    tx->hdr.number1 = number;
+    tx->hdr.number2 = tx->hdr.number1 ^ 0x4242;
+    frame.numbers.append(tx->hdr.number1);
+    frame.sent.start();
+
+    qint64 len = frame.packet.size();
+    return appSocket.writeDatagram(frame.packet.constData(), len, QHostAddress(remoteaddr), XBEE_APP_PORT) == len;
+}
 
-    tx->hdr.packetID = 0;
-    tx->hdr.encryptionPad = 0;
-    tx->hdr.commandID = 0x02;
-    tx->hdr.commandOptions = 0x00;
-    tx->frameID = 0x01;
-    tx->configOptions = 0x02;
-    strncpy(tx->atCommand, atCmd[cmd], 2);
-
-    retries = 3;
-    timeout = 200;
-    while (--retries >= 0) {
-        qint16 number = rand();
-
-        tx->hdr.number1 = number;
-        tx->hdr.number2 = tx->hdr.number1 ^ 0x4242;
-
-        if (sock.writeDatagram((char *)tx, txCnt, rhaddr, XBEE_APP_PORT) != txCnt) {
-            sock.close();
-            return -1;
-        }
-
-        if (sock.waitForReadyRead(timeout)) {
-            if ((cnt = sock.readDatagram((char *)rx, rxSize)) >= (int)sizeof(rxPacket)
-            &&  (rx->hdr.number1 ^ rx->hdr.number2) == 0x4242
-            &&  rx->hdr.number1 == number
-            &&  rx->status == 0x00) {
-                sock.close();
-                return cnt;
-            }
-        }
+void XBeeSerialPort::fillWindow()
+{
+    while (!queued.isEmpty() && inFlight.count() < MAX_IN_FLIGHT) {
+        quint8 id = queued.takeFirst();
+        inFlight.append(id);
+        if (!sendFrame(frames[id]))
+            finishFrame(id, -1, QByteArray());
     }
+    if (inFlight.isEmpty())
+        retryTimer.stop();
+    else if (!retryTimer.isActive())
+        retryTimer.start();
+}
 
-    sock.close();
+void XBeeSerialPort::finishFrame(quint8 frameID, int status, const QByteArray &value)
+{
+    if (!frames.contains(frameID))
+        return;
+    int cmd = frames[frameID].cmd;
+    frames.remove(frameID);
+    inFlight.removeAll(frameID);
+    queued.removeAll(frameID);
+    if (status != 0)
+        failed++;
+    emit commandFinished(frameID, cmd, status, value);
+}
+
+void XBeeSerialPort::processReplies()
+{
+    char buf[BUFSIZ];
+
+    while (appSocket.hasPendingDatagrams()) {
+        int cnt = appSocket.readDatagram(buf, sizeof(buf));
+        if (cnt < (int)sizeof(rxPacket))
+            continue;
+        rxPacket *rx = (rxPacket *)buf;
+        if ((rx->hdr.number1 ^ rx->hdr.number2) != 0x4242)
+            continue;
+        if (!frames.contains(rx->frameID))
+            continue;
+        if (!frames[rx->frameID].numbers.contains(rx->hdr.number1))
+            continue;
+        QByteArray value(buf + sizeof(rxPacket), cnt - sizeof(rxPacket));
+        finishFrame(rx->frameID, rx->status, value);
+    }
+    fillWindow();
+}
 
-    return -1;
+void XBeeSerialPort::appReadyRead()
+{
+    processReplies();
+}
+
+/*
+ * Resend frames that have not been answered in time.
+ * Frames out of retries fail individually; the rest of the batch goes on.
+ */
+void XBeeSerialPort::retryFrames()
+{
+    foreach (quint8 id, inFlight) {
+        XBeeFrame &frame = frames[id];
+        if (frame.sent.elapsed() < FRAME_TIMEOUT_MS)
+            continue;
+        if (--frame.retries <= 0 || !sendFrame(frame))
+            finishFrame(id, -1, QByteArray());
+    }
+    fillWindow();
 }
 
+int XBeeSerialPort::sendQueued(int timeout)
+{
+    failed = 0;
+    if (!bindAppSocket()) {
+        foreach (quint8 id, frames.keys())
+            finishFrame(id, -1, QByteArray());
+        return failed;
+    }
+
+    fillWindow();
+    if (timeout <= 0)
+        return 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!frames.isEmpty() && timer.elapsed() < timeout) {
+        qint64 wait = FRAME_TIMEOUT_MS;
+        foreach (quint8 id, inFlight)
+            wait = qMin(wait, (qint64)FRAME_TIMEOUT_MS - frames[id].sent.elapsed());
+        if (wait < 1) wait = 1;
+        if (appSocket.waitForReadyRead((int)wait))
+            processReplies();
+        retryFrames();
+    }
+
+    foreach (quint8 id, frames.keys())
+        finishFrame(id, -1, QByteArray());
+    retryTimer.stop();
+    return failed;
+}
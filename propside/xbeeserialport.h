@@ -0,0 +1,152 @@
+#ifndef XBEESERIALPORT_H
+#define XBEESERIALPORT_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QMap>
+#include <stdint.h>
+
+#define XBEE_APP_PORT 0xBEE      // application service, remote AT commands
+#define XBEE_SER_PORT 0x2616     // serial service, transparent UART data
+
+#pragma pack(push, 1)
+
+/*
+ * XBee Wi-Fi application service packet layout.
+ */
+typedef struct {
+    uint16_t number1;
+    uint16_t number2;
+    uint8_t  packetID;
+    uint8_t  encryptionPad;
+    uint8_t  commandID;
+    uint8_t  commandOptions;
+} appHeader;
+
+typedef struct {
+    appHeader hdr;
+    uint8_t  frameID;
+    uint8_t  configOptions;
+    char     atCommand[2];
+} txPacket;
+
+typedef struct {
+    appHeader hdr;
+    uint8_t  frameID;
+    char     atCommand[2];
+    uint8_t  status;
+} rxPacket;
+
+#pragma pack(pop)
+
+enum xbCommand {
+    xbData, xbMacHigh, xbMacLow, xbSSID, xbIPAddr, xbIPMask, xbIPGateway,
+    xbIPPort, xbIPDestination, xbNodeID, xbMaxRFPayload, xbPacketingTimeout,
+    xbIO2Mode, xbIO4Mode, xbOutputMask, xbOutputState, xbIO2Timer, xbIO4Timer,
+    xbSerialMode, xbSerialBaud, xbSerialParity, xbSerialStopBits, xbRTSFlow,
+    xbSerialIP, xbFirmwareVer, xbHardwareVer, xbHardwareSeries, xbChecksum
+};
+
+enum { serialUDP = 0, serialTCP };
+enum { transparentMode = 0, apiWoEscapeMode, apiWEscapeMode };
+enum { pinDisabled = 0, pinEnabled, pinAnalog, pinInput, pinOutLow, pinOutHigh };
+enum { parityNone = 0, parityEven, parityOdd };
+enum { stopBits1 = 0, stopBits2 };
+
+class XBeeSerialPort : public QObject
+{
+    Q_OBJECT
+public:
+    XBeeSerialPort(QObject *parent = 0);
+    virtual ~XBeeSerialPort();
+
+    bool open(QHostAddress addr, qint64 baudrate);
+    bool isOpen();
+    bool isSequential() const;
+    void close();
+    void flush();
+
+    qint64 bytesAvailable() const;
+    QByteArray readAll();
+    qint64 write(QByteArray barry, int len);
+
+    void setBaudRate(qint64 baudrate);
+    qint64 baudRate() const;
+    void setPortName(QString name);
+    QString portName() const;
+
+    /* single command round trip; returns 0 or -1 */
+    int setItem(xbCommand cmd, const QString value);
+    int setItem(xbCommand cmd, int value);
+
+    /*
+     * Batched commands. queue* returns the frame ID of the command.
+     * sendQueued pipelines everything queued and waits up to timeout ms,
+     * returning the number of failed frames. With timeout 0 it returns
+     * right away and results arrive through commandFinished.
+     */
+    int queueItem(xbCommand cmd, const QString value);
+    int queueItem(xbCommand cmd, int value);
+    int queueQuery(xbCommand cmd);
+    int sendQueued(int timeout = BATCH_TIMEOUT_MS);
+    int pendingCommands() const;
+
+    /* an XBee answer to a discovery query; false if data is something else */
+    static bool parseReply(const QByteArray &data, char cmd[2], QByteArray &value);
+    static QByteArray queryPacket(xbCommand cmd);
+
+signals:
+    void commandFinished(int frameID, int cmd, int status, QByteArray value);
+    void updateEvent(XBeeSerialPort*);
+
+public slots:
+    void readyRead();
+
+private slots:
+    void appReadyRead();
+    void retryFrames();
+
+private:
+    enum {
+        MAX_IN_FLIGHT    = 8,
+        FRAME_TIMEOUT_MS = 200,
+        FRAME_RETRIES    = 3,
+        BATCH_TIMEOUT_MS = 3000
+    };
+
+    struct XBeeFrame {
+        xbCommand       cmd;
+        QByteArray      packet;
+        QList<quint16>  numbers;    // packet numbers of every transmission
+        int             retries;
+        QElapsedTimer   sent;
+    };
+
+    int  queueCommand(xbCommand cmd, const QByteArray &value);
+    bool bindAppSocket();
+    bool sendFrame(XBeeFrame &frame);
+    void fillWindow();
+    void processReplies();
+    void finishFrame(quint8 frameID, int status, const QByteArray &value);
+
+    QUdpSocket  socket;
+    QUdpSocket  appSocket;
+    QTimer      retryTimer;
+
+    QMap<quint8, XBeeFrame> frames;
+    QList<quint8>           queued;
+    QList<quint8>           inFlight;
+    quint8                  nextFrameID;
+    int                     failed;
+
+    QString     port;
+    qint64      baud;
+    quint32     myhostaddr;
+    quint32     remoteaddr;
+    bool        isopen;
+};
+
+#endif // XBEESERIALPORT_H
@@ -4,6 +4,9 @@
 XEsp8266port::XEsp8266port(QObject *parent) : QObject(parent), socket(0), notifier(0), connected(false), signalsConnected(false)
 {
     isopen = false;
+    reconnectDelay = RECONNECT_MIN_MS;
+    reconnectTimer.setSingleShot(true);
+    connect(&reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnect()));
 }
 
 bool XEsp8266port::open(QHostAddress addr, qint64 baudrate)
@@ -20,12 +23,14 @@ bool XEsp8266port::open(QHostAddress addr, qint64 baudrate)
         signalsConnected = true;
     }
 
+    hostAddr = addr;
+    reconnectDelay = RECONNECT_MIN_MS;
     socket.connectToHost(addr, XEsp8266port::SER_PORT,QTcpSocket::ReadWrite);
 
     baud = baudrate;
 
     isopen = true;
-    return 0;
+    return true;
 }
 
 bool XEsp8266port::isOpen()
@@ -41,25 +46,24 @@ bool XEsp8266port::isSequential() const
 
 void XEsp8266port::close()
 {
-    if (isopen || socket.isOpen()) {
-        socket.close();
-    }
+    // clear isopen first so the disconnect does not schedule a reconnect
     isopen = false;
+    reconnectTimer.stop();
+    if (socket.isOpen() || socket.state() != QTcpSocket::UnconnectedState) {
+        socket.abort();
+    }
 }
 
+/*
+ * discard everything received so far
+ */
 void XEsp8266port::flush()
 {
     char buf[BUFSIZ];
-    int rc = 0;
-
-    qDebug() << "flush Socket.State" << socket.state();
 
     if (socket.state() != QTcpSocket::ConnectedState) return;
-    while (socket.bytesAvailable()) {
-        rc = socket.bytesAvailable();
-        rc = (rc < BUFSIZ) ? rc : BUFSIZ-1;
-        socket.readLine(buf, rc);
-    }
+    while (socket.read(buf, sizeof(buf)) > 0)
+        ;
 }
 
 /*
@@ -75,10 +79,8 @@ void XEsp8266port::readyRead()
 
 qint64 XEsp8266port::bytesAvailable() const
 {
-    //qDebug() << "bytesAvailable Socket.State" << socket.state();
-
     if (socket.state() != QTcpSocket::ConnectedState) return 0;
-    return socket.bytesAvailable() ? 1 : 0;
+    return socket.bytesAvailable();
 }
 
 QByteArray XEsp8266port::readAll()
@@ -88,23 +90,33 @@ QByteArray XEsp8266port::readAll()
     return ba;
 }
 
+/*
+ * read up to len bytes into the caller's buffer. no allocation.
+ */
 int XEsp8266port::read(char *buf, qint64 len)
 {
-    //char *buffer = new char[len+1];
+    if (socket.state() != QTcpSocket::ConnectedState) return 0;
     int rlen = socket.read(buf, len);
-    buf[rlen] = '\0';
     return rlen;
 }
 
 int XEsp8266port::write(QByteArray barry, int len)
 {
-    qint64 rc = 0;
+    return write(barry.constData(), len);
+}
 
-    qDebug() << "write Socket.State" << socket.state();
+/*
+ * Keystrokes go out right away. LowDelayOption turns off Nagle and
+ * flush() hands the data to the socket without waiting for the event loop.
+ */
+int XEsp8266port::write(const char *buf, int len)
+{
+    qint64 rc = 0;
 
     if(socket.state() != QTcpSocket::ConnectedState)
         return rc;
-    rc = socket.write(barry.constData(), (qint64)len);
+    rc = socket.write(buf, (qint64)len);
+    socket.flush();
     return rc;
 }
 
@@ -145,7 +157,11 @@ void XEsp8266port::socketConnected()
 #endif
     qDebug() << "socketConnected";
 
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket.setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
     connected = true;
+    reconnectDelay = RECONNECT_MIN_MS;
 #ifndef Q_OS_MAC
     notifier = new QSocketNotifier(socket.socketDescriptor(), QSocketNotifier::Exception, this);
     connect(notifier, SIGNAL(activated(int)), this, SLOT(socketException(int)));
@@ -162,6 +178,7 @@ void XEsp8266port::socketConnectionClosed()
 #endif
     connected = false;
     emit sockDisconnected();
+    scheduleReconnect();
 }
 
 void XEsp8266port::socketReadyRead()
@@ -174,6 +191,30 @@ void XEsp8266port::socketError(QAbstractSocket::SocketError error)
 {
     qDebug() << "socketError" << error;
     //emit q->connectionError(error);
+    if (socket.state() != QTcpSocket::ConnectedState)
+        scheduleReconnect();
+}
+
+/*
+ * The module can drop the telnet connection when WiFi is weak or it resets.
+ * Keep trying while the port is supposed to be open, doubling the delay each time.
+ */
+void XEsp8266port::scheduleReconnect()
+{
+    if (!isopen || reconnectTimer.isActive())
+        return;
+    reconnectTimer.start(reconnectDelay);
+    reconnectDelay *= 2;
+    if (reconnectDelay > RECONNECT_MAX_MS)
+        reconnectDelay = RECONNECT_MAX_MS;
+}
+
+void XEsp8266port::reconnect()
+{
+    if (!isopen || socket.state() != QTcpSocket::UnconnectedState)
+        return;
+    qDebug() << "reconnect" << hostAddr.toString();
+    socket.connectToHost(hostAddr, XEsp8266port::SER_PORT, QTcpSocket::ReadWrite);
 }
 
 void XEsp8266port::socketException(int)
@@ -183,10 +224,10 @@ void XEsp8266port::socketException(int)
 
 bool XEsp8266port::waitForReadyRead(int ms)
 {
-    socket.waitForReadyRead(ms);
+    return socket.waitForReadyRead(ms);
 }
 
 bool XEsp8266port::waitForBytesWritten(int ms)
 {
-    socket.waitForBytesWritten(ms);
+    return socket.waitForBytesWritten(ms);
 }
@@ -5,6 +5,7 @@
 #include <QHostAddress>
 #include <QTcpSocket>
 #include <QSocketNotifier>
+#include <QTimer>
 
 struct XEspInfo {
     qint32 ipAddr;
@@ -31,6 +32,7 @@ public:
     QByteArray readAll();
     int read(char *buf, qint64 len);
     int write(QByteArray barry, int len);
+    int write(const char *buf, int len);
 
     void setBaudRate(qint64 baudrate);
     qint64 getBaudRate() const;
@@ -44,6 +46,9 @@ public:
 
 private:
     enum { SER_PORT = 23 };
+    enum { RECONNECT_MIN_MS = 250, RECONNECT_MAX_MS = 8000 };
+
+    void scheduleReconnect();
 
 private slots:
 
@@ -52,6 +57,7 @@ private slots:
     void socketReadyRead();
     void socketError(QAbstractSocket::SocketError error);
     void socketException(int);
+    void reconnect();
 
 signals:
     void sockConnected();
@@ -73,6 +79,10 @@ private:
 
     QTcpSocket socket;
     QSocketNotifier *notifier;
+
+    QHostAddress hostAddr;
+    QTimer  reconnectTimer;
+    int     reconnectDelay;
 };
 
 #endif // WIFIESP8266_H
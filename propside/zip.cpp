@@ -50,9 +50,13 @@
 #include <qendian.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qhash.h>
 
 #include <zlib.h>
 #include <QApplication>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #if defined(Q_OS_WIN)
 #  undef S_IFREG
@@ -410,6 +414,7 @@ public:
     bool ownDevice;
     bool dirtyFileTree;
     QList<FileHeader> fileHeaders;
+    QHash<QString, int> nameIndex;
     QByteArray comment;
     uint start_of_directory;
 };
@@ -445,6 +450,125 @@ public:
     ZipReader::Status status;
 };
 
+/*
+ * One queued disk entry. The file is read in chunks and deflated on a
+ * pool thread; the writer waits for entries in the order they were added.
+ */
+class ZipDiskEntry : public QRunnable
+{
+public:
+    ZipDiskEntry(const QString &name, const QString &path, bool isDir, bool store)
+        : name(name), path(path), isDir(isDir), store(store),
+          ok(true), crc(0), size(0), done(isDir)
+    {
+        setAutoDelete(false);
+    }
+
+    void run();
+    void wait();
+
+    QString     name;
+    QString     path;
+    bool        isDir;
+    bool        store;
+
+    bool        ok;
+    uint        crc;
+    uint        size;
+    QDateTime   modified;
+    QByteArray  data;       // deflated contents; empty when stored
+
+private:
+    void finish();
+
+    QMutex          mutex;
+    QWaitCondition  finished;
+    bool            done;
+};
+
+void ZipDiskEntry::run()
+{
+    const int chunk = 64*1024;
+    QFile file(path);
+    modified = QFileInfo(file).lastModified();
+    crc = ::crc32(0, 0, 0);
+    if (!file.open(QIODevice::ReadOnly)) {
+        ok = false;
+        finish();
+        return;
+    }
+
+    QByteArray in(chunk, 0);
+    qint64 len;
+    if (store) {
+        while ((len = file.read(in.data(), chunk)) > 0) {
+            crc = ::crc32(crc, (const uchar *)in.constData(), len);
+            size += len;
+        }
+        finish();
+        return;
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        ok = false;
+        finish();
+        return;
+    }
+
+    QByteArray out(chunk, 0);
+    int flush = Z_NO_FLUSH;
+    int res = Z_OK;
+    do {
+        len = file.read(in.data(), chunk);
+        if (len < 0) {
+            ok = false;
+            break;
+        }
+        flush = file.atEnd() || len == 0 ? Z_FINISH : Z_NO_FLUSH;
+        crc = ::crc32(crc, (const uchar *)in.constData(), len);
+        size += len;
+        stream.next_in = (Bytef *)in.data();
+        stream.avail_in = (uInt)len;
+        do {
+            stream.next_out = (Bytef *)out.data();
+            stream.avail_out = chunk;
+            res = deflate(&stream, flush);
+            data.append(out.constData(), chunk - stream.avail_out);
+        } while (stream.avail_out == 0);
+    } while (flush != Z_FINISH);
+    deflateEnd(&stream);
+
+    if (ok && res != Z_STREAM_END)
+        ok = false;
+
+    // not worth it, store the original instead
+    if (ok && (uint)data.size() >= size) {
+        store = true;
+        data.clear();
+    }
+    finish();
+}
+
+void ZipDiskEntry::finish()
+{
+    QMutexLocker lock(&mutex);
+    done = true;
+    finished.wakeAll();
+}
+
+void ZipDiskEntry::wait()
+{
+    QMutexLocker lock(&mutex);
+    while (!done) {
+        finished.wait(&mutex, 20);
+        lock.unlock();
+        QApplication::processEvents();
+        lock.relock();
+    }
+}
+
 class ZipWriterPrivate : public ZipPrivate
 {
 public:
@@ -456,6 +580,11 @@ public:
     {
     }
 
+    ~ZipWriterPrivate()
+    {
+        qDeleteAll(pending);
+    }
+
     ZipWriter::Status status;
     QFile::Permissions permissions;
     ZipWriter::CompressionPolicy compressionPolicy;
@@ -463,6 +592,14 @@ public:
     enum EntryType { Directory, File, Symlink };
 
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+
+    bool storeFromDisk(const QString &path) const;
+    void flushPending();
+
+    QList<ZipDiskEntry *> pending;
+
+private:
+    void writeDiskEntry(ZipDiskEntry *entry);
 };
 
 LocalFileHeader CentralFileHeader::toLocalHeader() const
@@ -566,10 +703,107 @@ void ZipReaderPrivate::scanFiles()
         }
 
         ZDEBUG("found file '%s'", header.file_name.data());
+        nameIndex.insert(QString::fromLocal8Bit(header.file_name), fileHeaders.count());
         fileHeaders.append(header);
     }
 }
 
+/*
+ * Extract one entry from its own handle on the archive, streaming
+ * through inflate in chunks. Runs on a pool thread.
+ */
+class ZipExtractEntry : public QRunnable
+{
+public:
+    ZipExtractEntry(const QString &archive, const FileHeader &header, const QString &dest)
+        : archive(archive), header(header), dest(dest), ok(false)
+    {
+        setAutoDelete(false);
+    }
+
+    void run();
+
+    QString     archive;
+    FileHeader  header;
+    QString     dest;
+    bool        ok;
+};
+
+void ZipExtractEntry::run()
+{
+    const int chunk = 64*1024;
+    QFile zip(archive);
+    QFile out(dest);
+    if (!zip.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return;
+
+    qint64 remaining = readUInt(header.h.compressed_size);
+    uint expected = readUInt(header.h.crc_32);
+    zip.seek(readUInt(header.h.offset_local_header));
+    LocalFileHeader lh;
+    if (zip.read((char *)&lh, sizeof(LocalFileHeader)) != sizeof(LocalFileHeader))
+        return;
+    zip.seek(zip.pos() + readUShort(lh.file_name_length) + readUShort(lh.extra_field_length));
+
+    int method = readUShort(header.h.compression_method);
+    uint crc = ::crc32(0, 0, 0);
+    QByteArray in(chunk, 0);
+
+    if (method == 0) {
+        while (remaining > 0) {
+            qint64 len = zip.read(in.data(), qMin<qint64>(chunk, remaining));
+            if (len <= 0)
+                return;
+            crc = ::crc32(crc, (const uchar *)in.constData(), len);
+            out.write(in.constData(), len);
+            remaining -= len;
+        }
+    }
+    else if (method == 8) {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            return;
+        QByteArray buf(chunk, 0);
+        int res = Z_OK;
+        bool drained = true;    // last call left room, no output pending
+        while (res != Z_STREAM_END) {
+            if (stream.avail_in == 0 && drained) {
+                qint64 len = remaining > 0 ? zip.read(in.data(), qMin<qint64>(chunk, remaining)) : 0;
+                if (len <= 0)
+                    break;
+                remaining -= len;
+                stream.next_in = (Bytef *)in.data();
+                stream.avail_in = (uInt)len;
+            }
+            stream.next_out = (Bytef *)buf.data();
+            stream.avail_out = chunk;
+            res = inflate(&stream, Z_NO_FLUSH);
+            if (res == Z_BUF_ERROR) {
+                drained = true;
+                continue;
+            }
+            if (res != Z_OK && res != Z_STREAM_END)
+                break;
+            drained = stream.avail_out != 0;
+            int have = chunk - stream.avail_out;
+            crc = ::crc32(crc, (const uchar *)buf.constData(), have);
+            out.write(buf.constData(), have);
+        }
+        inflateEnd(&stream);
+        if (res != Z_STREAM_END) {
+            qWarning("Zip: Z_DATA_ERROR: Input data is corrupted");
+            return;
+        }
+    }
+    else {
+        qWarning() << "Zip: Unknown compression method";
+        return;
+    }
+
+    ok = (crc == expected) && out.error() == QFile::NoError;
+}
+
 void ZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, Zip::Method m*/)
 {
 #ifndef NDEBUG
@@ -665,6 +899,129 @@ void ZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const Q
     dirtyFileTree = true;
 }
 
+/*
+ * Files that are already compressed or tiny gain nothing from deflate.
+ */
+bool ZipWriterPrivate::storeFromDisk(const QString &path) const
+{
+    if (compressionPolicy == ZipWriter::NeverCompress)
+        return true;
+    if (compressionPolicy == ZipWriter::AlwaysCompress)
+        return false;
+
+    static const char *packed[] = {
+        "zip", "gz", "tgz", "bz2", "xz", "7z", "jar",
+        "png", "jpg", "jpeg", "gif", "mp3", 0 };
+    QFileInfo info(path);
+    if (info.size() < 64)
+        return true;
+    QString suffix = info.suffix().toLower();
+    for (int n = 0; packed[n]; n++) {
+        if (suffix == QLatin1String(packed[n]))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Deflate queued disk entries on a thread pool and write them in order.
+ * Only a window of entries is in flight so memory stays bounded.
+ */
+void ZipWriterPrivate::flushPending()
+{
+    if (pending.isEmpty())
+        return;
+
+    QThreadPool pool;
+    int window = pool.maxThreadCount() * 2;
+    int started = 0;
+
+    for (int n = 0; n < pending.count(); n++) {
+        for (; started < pending.count() && started < n + window; started++) {
+            if (!pending[started]->isDir)
+                pool.start(pending[started]);
+        }
+        ZipDiskEntry *entry = pending[n];
+        entry->wait();
+        if (status == ZipWriter::NoError)
+            writeDiskEntry(entry);
+        entry->data.clear();
+    }
+    pool.waitForDone();
+    qDeleteAll(pending);
+    pending.clear();
+}
+
+void ZipWriterPrivate::writeDiskEntry(ZipDiskEntry *entry)
+{
+    if (entry->isDir) {
+        addEntry(Directory, entry->name, QByteArray());
+        return;
+    }
+    if (!entry->ok) {
+        qWarning("Zip: can't read %s, skipping", qPrintable(entry->path));
+        status = ZipWriter::FileOpenError;
+        return;
+    }
+
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = ZipWriter::FileOpenError;
+        return;
+    }
+    device->seek(start_of_directory);
+
+    FileHeader header;
+    memset(&header.h, 0, sizeof(CentralFileHeader));
+    writeUInt(header.h.signature, 0x02014b50);
+    writeUShort(header.h.version_needed, 0x14);
+    writeUShort(header.h.compression_method, entry->store ? 0 : 8);
+    writeUInt(header.h.uncompressed_size, entry->size);
+    writeUInt(header.h.compressed_size, entry->store ? entry->size : (uint)entry->data.length());
+    writeUInt(header.h.crc_32, entry->crc);
+    writeMSDosDate(header.h.last_mod_file, entry->modified);
+
+    header.file_name = entry->name.toLocal8Bit();
+    if (header.file_name.size() > 0xffff) {
+        qWarning("Zip: Filename too long, chopping it to 65535 characters");
+        header.file_name = header.file_name.left(0xffff);
+    }
+    writeUShort(header.h.file_name_length, header.file_name.length());
+    writeUShort(header.h.version_made, 3 << 8);
+    quint32 mode = permissionsToMode(permissions) | S_IFREG;
+    writeUInt(header.h.external_file_attributes, mode << 16);
+    writeUInt(header.h.offset_local_header, start_of_directory);
+
+    LocalFileHeader h = header.h.toLocalHeader();
+    device->write((const char *)&h, sizeof(LocalFileHeader));
+    device->write(header.file_name);
+    if (entry->store) {
+        // stream stored files straight from disk
+        QFile file(entry->path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            status = ZipWriter::FileOpenError;
+            return;
+        }
+        QByteArray buf(64*1024, 0);
+        qint64 len;
+        qint64 total = 0;
+        while ((len = file.read(buf.data(), buf.size())) > 0) {
+            device->write(buf.constData(), len);
+            total += len;
+        }
+        if (total != entry->size) {
+            // file changed under us
+            status = ZipWriter::FileError;
+        }
+    }
+    else {
+        device->write(entry->data);
+    }
+
+    fileHeaders.append(header);
+    start_of_directory = device->pos();
+    dirtyFileTree = true;
+}
+
 //////////////////////////////  Reader
 
 /*!
@@ -844,18 +1201,38 @@ ZipReader::FileInfo ZipReader::entryInfoAt(int index) const
     return fi;
 }
 
+/*
+ * Opens a closed archive device for the length of one call, so a
+ * reader can keep its directory without holding the file open.
+ */
+class ZipDeviceGuard
+{
+public:
+    ZipDeviceGuard(QIODevice *device) : device(device), opened(false) {
+        if (!device->isOpen())
+            opened = device->open(QIODevice::ReadOnly);
+    }
+    ~ZipDeviceGuard() {
+        if (opened)
+            device->close();
+    }
+private:
+    QIODevice *device;
+    bool opened;
+};
+
 /*!
     Fetch the file contents from the zip archive and return the uncompressed bytes.
+    A device closed after the directory was read is reopened for the call.
 */
 QByteArray ZipReader::fileData(const QString &fileName) const
 {
-    d->scanFiles();
-    int i;
-    for (i = 0; i < d->fileHeaders.size(); ++i) {
-        if (QString::fromLocal8Bit(d->fileHeaders.at(i).file_name) == fileName)
-            break;
-    }
-    if (i == d->fileHeaders.size())
+    int i = indexOf(fileName);
+    if (i < 0)
+        return QByteArray();
+
+    ZipDeviceGuard guard(d->device);
+    if (!d->device->isOpen())
         return QByteArray();
 
     FileHeader header = d->fileHeaders.at(i);
@@ -914,25 +1291,82 @@ QByteArray ZipReader::fileData(const QString &fileName) const
     return QByteArray();
 }
 
+/*!
+    Returns the index of \a fileName in the directory listing, or -1.
+    Lookups use an index built when the central directory is read.
+*/
+int ZipReader::indexOf(const QString &fileName) const
+{
+    d->scanFiles();
+    return d->nameIndex.value(fileName, -1);
+}
+
 /*!
     Extracts the full contents of the zip file into \a destinationDir on
     the local filesystem.
     In case writing or linking a file fails, the extraction will be aborted.
 */
 bool ZipReader::extractAll(const QString &destinationDir) const
+{
+    return extractAll(destinationDir, QString());
+}
+
+/*!
+    Extracts entries under \a stripPrefix into \a destinationDir with the
+    prefix removed; other entries are skipped. An empty prefix extracts
+    everything. Files are streamed to disk in parallel when the archive
+    is a file.
+*/
+bool ZipReader::extractAll(const QString &destinationDir, const QString &stripPrefix) const
 {
     QDir baseDir(destinationDir);
 
-    // create directories first
     QList<FileInfo> allFiles = fileInfoList();
+    QFile *archive = qobject_cast<QFile *>(d->device);
+
+    // create directories first
+    QStringList destinations;
     foreach (FileInfo fi, allFiles) {
-        QApplication::processEvents();
-        const QString absPath = destinationDir + "/" + fi.filePath;
-        if (fi.isDir) {
-            if (!baseDir.mkpath(fi.filePath))
-                return false;
-            //if (!QFile::setPermissions(absPath, fi.permissions)) return false;
+        QString name = fi.filePath;
+        if (!stripPrefix.isEmpty()) {
+            if (!name.startsWith(stripPrefix)) {
+                destinations.append(QString());
+                continue;
+            }
+            name = name.mid(stripPrefix.length());
+        }
+        if (name.isEmpty()) {
+            destinations.append(QString());
+            continue;
         }
+        const QString absFile = destinationDir + "/" + name;
+        destinations.append(absFile);
+        QString absPath = absFile;
+        if (!fi.isDir)
+            absPath = absPath.left(absPath.lastIndexOf("/")+1);
+        if (!baseDir.mkpath(absPath))
+            return false;
+    }
+
+    if (archive && !archive->fileName().isEmpty()) {
+        QThreadPool pool;
+        QList<ZipExtractEntry *> jobs;
+        for (int n = 0; n < allFiles.count(); n++) {
+            if (allFiles[n].isDir || destinations[n].isEmpty())
+                continue;
+            ZipExtractEntry *job = new ZipExtractEntry(archive->fileName(), d->fileHeaders.at(n), destinations[n]);
+            jobs.append(job);
+            pool.start(job);
+        }
+        while (!pool.waitForDone(50))
+            QApplication::processEvents();
+        bool ok = true;
+        foreach (ZipExtractEntry *job, jobs) {
+            if (!job->ok)
+                ok = false;
+        }
+        qDeleteAll(jobs);
+        return ok;
     }
 
     // set up symlinks
@@ -956,18 +1390,11 @@ bool ZipReader::extractAll(const QString &destinationDir) const
     }
 #endif
 
-    foreach (FileInfo fi, allFiles) {
+    for (int n = 0; n < allFiles.count(); n++) {
+        const FileInfo &fi = allFiles.at(n);
         QApplication::processEvents();
-        const QString absFile = destinationDir + "/" + fi.filePath;
-        QString absPath = destinationDir + "/" + fi.filePath;
-        if(absPath.endsWith("/") == false) {
-            absPath = absPath.left(absPath.lastIndexOf("/")+1);
-            QDir absDir(absPath);
-            if(absDir.exists() == false) {
-                absDir.mkpath(absPath);
-            }
-        }
-        if (!fi.isDir) {
+        const QString absFile = destinations[n];
+        if (!fi.isDir && !absFile.isEmpty()) {
             QFile f(absFile);
             if (!f.open(QIODevice::WriteOnly))
                 return false;
@@ -1186,6 +1613,7 @@ QFile::Permissions ZipWriter::creationPermissions() const
 */
 void ZipWriter::addFile(const QString &fileName, const QByteArray &data)
 {
+    d->flushPending();
     d->addEntry(ZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), data);
 }
 
@@ -1208,11 +1636,24 @@ void ZipWriter::addFile(const QString &fileName, QIODevice *device)
             return;
         }
     }
+    d->flushPending();
     d->addEntry(ZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), device->readAll());
     if (opened)
         device->close();
 }
 
+/*!
+    Add the file at \a path to the archive as \a fileName.
+    The file is not read here; it is streamed from disk and compressed
+    on a worker thread when the queue is flushed, which happens on close()
+    or when an entry is added by another method. Entries keep their order.
+*/
+void ZipWriter::addFileFromDisk(const QString &fileName, const QString &path)
+{
+    d->pending.append(new ZipDiskEntry(QDir::fromNativeSeparators(fileName), path,
+                                       false, d->storeFromDisk(path)));
+}
+
 /*!
     Create a new directory in the archive with the specified \a dirName and
     the \a permissions;
@@ -1223,6 +1664,10 @@ void ZipWriter::addDirectory(const QString &dirName)
     // separator is mandatory
     if (!name.endsWith(QLatin1Char('/')))
         name.append(QLatin1Char('/'));
+    if (d->pending.count() > 0) {
+        d->pending.append(new ZipDiskEntry(name, QString(), true, true));
+        return;
+    }
     d->addEntry(ZipWriterPrivate::Directory, name, QByteArray());
 }
 
@@ -1233,6 +1678,7 @@ void ZipWriter::addDirectory(const QString &dirName)
 */
 void ZipWriter::addSymLink(const QString &fileName, const QString &destination)
 {
+    d->flushPending();
     d->addEntry(ZipWriterPrivate::Symlink, QDir::fromNativeSeparators(fileName), QFile::encodeName(destination));
 }
 
@@ -1246,6 +1692,8 @@ void ZipWriter::close()
         return;
     }
 
+    d->flushPending();
+
     //qDebug("Zip::close writing directory, %d entries", d->fileHeaders.size());
     d->device->seek(d->start_of_directory);
     // write new directory
@@ -26,10 +26,50 @@
 #include "zipwriter.h"
 
 Zipper::Zipper(QObject *parent) :
-    QObject(parent)
+    QObject(parent), zipReader(0), zipReaderSize(0)
 {
 }
 
+Zipper::~Zipper()
+{
+    delete zipReader;
+}
+
+/*
+ * The central directory is read once per archive. Callers usually ask
+ * several questions about the same zip, so the reader is kept until a
+ * different or changed archive is opened. The file itself is closed
+ * once the directory is read and only opened again while an entry is
+ * read or extracted, so the user can still move or delete the zip.
+ */
+ZipReader *Zipper::openZip(QString zipName)
+{
+    QFileInfo info(zipName);
+    if(zipReader != 0 &&
+       zipReaderName == info.absoluteFilePath() &&
+       zipReaderTime == info.lastModified() &&
+       zipReaderSize == info.size()) {
+        return zipReader;
+    }
+
+    delete zipReader;
+    zipReader = new ZipReader(zipName);
+    zipReaderName = info.absoluteFilePath();
+    zipReaderTime = info.lastModified();
+    zipReaderSize = info.size();
+
+    zipInfo = zipReader->fileInfoList();
+    zipTypes.clear();
+    for(int n = 0; n < zipInfo.count(); n++) {
+        QString name = zipInfo.at(n).filePath;
+        int dot = name.lastIndexOf(".");
+        if(dot > name.lastIndexOf("/"))
+            zipTypes[name.mid(dot)].append(n);
+    }
+    zipReader->close();
+    return zipReader;
+}
+
 bool Zipper::makeSpinZip(QString fileName, QStringList fileTree, QString libPath, StatusDialog *stat)
 {
     statusDialog = stat;
@@ -51,6 +91,7 @@ bool Zipper::zipFileList(QString source, QStringList list, QString dstZipFile)
     ZipWriter zip(dstZipFile);
     if(!zip.isWritable())
         return false;
+    zip.setCompressionPolicy(ZipWriter::AutoCompress);
 
     foreach(QString entry, list) {
         if(entry.compare(".") == 0) continue;
@@ -58,10 +99,9 @@ bool Zipper::zipFileList(QString source, QStringList list, QString dstZipFile)
         if(entry.endsWith("/")) {
             zip.addDirectory(entry);
         } else {
-            QFile file(source+"/"+entry);
-            if(file.open(QFile::ReadOnly)) {
-                zip.addFile(entry, file.readAll());
-                file.close();
+            QFileInfo file(source+"/"+entry);
+            if(file.isReadable()) {
+                zip.addFileFromDisk(entry, file.filePath());
             }
             else {
                 retval = false;
@@ -70,6 +110,8 @@ bool Zipper::zipFileList(QString source, QStringList list, QString dstZipFile)
         }
     }
     zip.close();
+    if(zip.status() != ZipWriter::NoError)
+        retval = false;
     return retval;
 }
 
@@ -78,8 +120,10 @@ bool Zipper::zipFileList(QString source, QStringList list, QString dstZipFile)
 bool Zipper::unzipAll(QString fileName, QString folder, QString special)
 {
     bool rc = false;
-    ZipReader zipr(fileName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
+    ZipReader *zipr = openZip(fileName);
+    QList<ZipReader::FileInfo> info = zipInfo;
+    if(info.isEmpty())
+        return false;
     bool onefolder = true;
     QString s = info.at(0).filePath;
     QString first;
@@ -99,23 +143,12 @@ bool Zipper::unzipAll(QString fileName, QString folder, QString special)
             break;
         }
     }
-    if(onefolder == false) {
-        rc = zipr.extractAll(folder);
+    /* a single top folder is unwrapped unless it's the special one */
+    if(onefolder == false || first.isEmpty() || first.compare(special) == 0) {
+        rc = zipr->extractAll(folder);
     }
     else {
-        QString tmp = QDir::tempPath()+"/SimpleIDE_TempZip";
-        QDir tmpd(QDir::tempPath());
-        tmpd.mkdir(tmp);
-        rc = zipr.extractAll(tmp);
-        if(rc) {
-            if(first.compare(special) == 0) {
-                Directory::recursiveCopyDir(tmp+"/"+first, folder+"/"+special);
-            }
-            else {
-                Directory::recursiveCopyDir(tmp+"/"+first, folder);
-            }
-            Directory::recursiveRemoveDir(tmp);
-        }
+        rc = zipr->extractAll(folder, first+sep);
     }
     return rc;
 }
@@ -123,11 +156,10 @@ bool Zipper::unzipAll(QString fileName, QString folder, QString special)
 QString Zipper::unzipFirstFile(QString zipName, QString *fileName)
 {
     QByteArray bytes;
-    ZipReader zipr(zipName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
-    if(info.count() > 0) {
-        *fileName = info.at(0).filePath;
-        bytes = zipr.fileData(*fileName);
+    ZipReader *zipr = openZip(zipName);
+    if(zipInfo.count() > 0) {
+        *fileName = zipInfo.at(0).filePath;
+        bytes = zipr->fileData(*fileName);
     }
     return QString(bytes);
 }
@@ -135,13 +167,17 @@ QString Zipper::unzipFirstFile(QString zipName, QString *fileName)
 QString Zipper::unzipTopTypeFile(QString zipName, QString type)
 {
     QString fileName;
-    ZipReader zipr(zipName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
-    if(info.count() > 0) {
+    openZip(zipName);
+    QList<int> list = zipTypes.value(type);
+    if(!type.startsWith(".")) {
+        list.clear();
+        for(int n = 0; n < zipInfo.count(); n++)
+            list.append(n);
+    }
+    if(list.count() > 0) {
         QString name;
-        for(int n = 0; n < info.count(); n++) {
-            name = info.at(n).filePath;
-            qDebug() << "unzipTopTypeFile" << name;
+        foreach(int n, list) {
+            name = zipInfo.at(n).filePath;
             if(name.contains("library/")) continue;
             if(name.endsWith(type)) {
                 if(name.indexOf("/") > -1) {
@@ -159,40 +195,19 @@ QString Zipper::unzipTopTypeFile(QString zipName, QString type)
 
 QString Zipper::unzipFile(QString zipName, QString fileName)
 {
-    QByteArray bytes;
-    ZipReader zipr(zipName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
-    for(int n = 0; n < info.count(); n++) {
-        QApplication::processEvents();
-        if(info.at(n).filePath.compare(fileName) == 0) {
-            bytes = zipr.fileData(fileName);
-            break;
-        }
-    }
-    return QString(bytes);
+    ZipReader *zipr = openZip(zipName);
+    return QString(zipr->fileData(fileName));
 }
 
 bool Zipper::unzipFileExists(QString zipName, QString fileName)
 {
-    QString file;
-    ZipReader zipr(zipName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
-    for(int n = 0; n < info.count(); n++) {
-        QApplication::processEvents();
-        file = info.at(n).filePath;
-        qDebug() << file;
-        if(!file.compare(fileName)) {
-            return true;
-        }
-    }
-    return false;
+    return openZip(zipName)->indexOf(fileName) >= 0;
 }
 
 int  Zipper::unzipFileCount(QString zipName)
 {
-    ZipReader zipr(zipName);
-    QList<ZipReader::FileInfo> info = zipr.fileInfoList();
-    return info.count();
+    openZip(zipName);
+    return zipInfo.count();
 }
 
 QString Zipper::getZipDestination(QString fileName)
@@ -266,6 +281,7 @@ void Zipper::zipSpinProjectTree(QString fileName, QStringList fileTree)
             tr("Can't create zip file")+"\n"+dstName);
         return;
     }
+    zip.setCompressionPolicy(ZipWriter::AutoCompress);
     foreach(QString entry, fileTree) {
         QString name;
         if(QFile::exists(spinCodePath+"/"+entry)) {
@@ -280,11 +296,7 @@ void Zipper::zipSpinProjectTree(QString fileName, QStringList fileTree)
             zip.close();
             return;
         }
-        QFile file(name);
-        if(file.open(QFile::ReadOnly)) {
-            zip.addFile(source+"/"+entry, file.readAll());
-            file.close();
-        }
+        zip.addFileFromDisk(source+"/"+entry, name);
     }
     zip.close();
 
@@ -412,6 +424,7 @@ bool Zipper::createFolderZip(QString source, QString dstZipFile)
     ZipWriter zip(dstZipFile);
     if(!zip.isWritable())
         return false;
+    zip.setCompressionPolicy(ZipWriter::AutoCompress);
 
     QStringList list = directoryTreeList(source);
     foreach(QString entry, list) {
@@ -421,11 +434,9 @@ bool Zipper::createFolderZip(QString source, QString dstZipFile)
         if(entry.endsWith("/")) {
             zip.addDirectory(entry);
         } else {
-            QFile file(source+"/"+entry);
-            if(file.open(QFile::ReadOnly)) {
-                zip.addFile(entry, file.readAll());
-                file.close();
-            }
+            QFileInfo file(source+"/"+entry);
+            if(file.isReadable())
+                zip.addFileFromDisk(entry, file.filePath());
         }
     }
     zip.close();
@@ -23,6 +23,7 @@
 #include "qtversion.h"
 
 #include "StatusDialog.h"
+#include "zipreader.h"
 
 #if 0
 extern "C" {
@@ -36,6 +37,7 @@ class Zipper : public QObject
     Q_OBJECT
 public:
     explicit Zipper(QObject *parent = 0);
+    ~Zipper();
     // special spinzip
     bool makeSpinZip(QString fileName, QStringList fileTree, QString libPath, StatusDialog *stat);
     // any zip
@@ -52,6 +54,7 @@ public:
     QStringList directoryTreeList(QString folder);
 
 private:
+    ZipReader *openZip(QString zipName);
     QString getZipDestination(QString fileName);
     void    zipSpinProjectTree(QString fileName, QStringList fileTree);
     bool    createFolderZip(QString source, QString dstZipFile);
@@ -62,6 +65,14 @@ private:
     StatusDialog *statusDialog;
     QString newProjectFolder;
 
+    /* last archive opened, with its directory indexed by type */
+    ZipReader  *zipReader;
+    QString     zipReaderName;
+    QDateTime   zipReaderTime;
+    qint64      zipReaderSize;
+    QList<ZipReader::FileInfo>  zipInfo;
+    QHash<QString, QList<int> > zipTypes;
+
 signals:
 
 public slots:
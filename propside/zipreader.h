@@ -85,8 +85,10 @@ public:
     int count() const;
 
     FileInfo entryInfoAt(int index) const;
+    int indexOf(const QString &fileName) const;
     QByteArray fileData(const QString &fileName) const;
     bool extractAll(const QString &destinationDir) const;
+    bool extractAll(const QString &destinationDir, const QString &stripPrefix) const;
 
     enum Status {
         NoError,
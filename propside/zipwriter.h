@@ -86,6 +86,8 @@ public:
 
     void addFile(const QString &fileName, QIODevice *device);
 
+    void addFileFromDisk(const QString &fileName, const QString &path);
+
     void addDirectory(const QString &dirName);
 
     void addSymLink(const QString &fileName, const QString &destination);